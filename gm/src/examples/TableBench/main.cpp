@@ -0,0 +1,163 @@
+/*
+  Table benchmark: times gmTableObject insert, lookup and iteration for int, string and object keys at a few table
+  sizes. Compare builds with GM_TABLE_OPEN_ADDRESSING set to 0 and 1 (gmConfig.h).
+*/
+
+#include <time.h>
+#include "gmThread.h" // game monkey script
+
+enum KeyType
+{
+  KEY_INT,
+  KEY_STRING,
+  KEY_TABLE,
+};
+
+static const char * s_keyTypeNames[] = { "int", "string", "table" };
+
+static gmVariable * s_keys = NULL;
+static int * s_order = NULL;
+static gmVariable s_missKeys[64];
+
+
+static double Seconds(clock_t a_start)
+{
+  return (double) (clock() - a_start) / CLOCKS_PER_SEC;
+}
+
+
+/// \brief MakeKeys() creates a_count distinct keys, and keys that are not in the table for misses.
+static void MakeKeys(gmMachine * a_machine, KeyType a_type, int a_count)
+{
+  char name[32];
+  int i;
+  for(i = 0; i < a_count + 64; ++i)
+  {
+    gmVariable key;
+    if(a_type == KEY_INT)
+    {
+      key.SetInt(i * 4); // spread like array indices, a common script pattern is t[i] with small i
+    }
+    else if(a_type == KEY_STRING)
+    {
+      sprintf(name, "key%d", i);
+      key.SetString(a_machine->AllocStringObject(name));
+    }
+    else
+    {
+      key.SetTable(a_machine->AllocTableObject());
+    }
+    if(i < a_count) s_keys[i] = key;
+    else s_missKeys[i - a_count] = key;
+  }
+
+  // visit keys in a random order so lookups don't walk memory in insertion order
+  srand(1234);
+  for(i = 0; i < a_count; ++i) s_order[i] = i;
+  for(i = a_count - 1; i > 0; --i)
+  {
+    int j = (int) (((unsigned int) rand() * (RAND_MAX + 1u) + (unsigned int) rand()) % (unsigned int) (i + 1));
+    int tmp = s_order[i]; s_order[i] = s_order[j]; s_order[j] = tmp;
+  }
+}
+
+
+static void Bench(gmMachine * a_machine, KeyType a_type, int a_count)
+{
+  const int OPS = 4000000;
+  int reps = OPS / a_count;
+  if(reps < 2) reps = 2;
+
+  a_machine->EnableGC(false); // keys and tables are not referenced from script
+  MakeKeys(a_machine, a_type, a_count);
+
+  gmVariable value;
+  value.SetInt(1);
+  int rep, i;
+  int sum = 0;
+
+  // insert into new tables
+  clock_t start = clock();
+  gmTableObject * table = NULL;
+  for(rep = 0; rep < reps; ++rep)
+  {
+    table = a_machine->AllocTableObject();
+    for(i = 0; i < a_count; ++i)
+    {
+      table->Set(a_machine, s_keys[i], value);
+    }
+  }
+  double insertTime = Seconds(start);
+
+  // look up every key
+  start = clock();
+  for(rep = 0; rep < reps; ++rep)
+  {
+    for(i = 0; i < a_count; ++i)
+    {
+      sum += table->Get(s_keys[s_order[i]]).m_value.m_int;
+    }
+  }
+  double lookupTime = Seconds(start);
+
+  // look up keys that are not there
+  start = clock();
+  for(rep = 0; rep < reps; ++rep)
+  {
+    for(i = 0; i < a_count; ++i)
+    {
+      sum += table->Get(s_missKeys[i & 63]).m_type;
+    }
+  }
+  double missTime = Seconds(start);
+
+  // iterate
+  start = clock();
+  for(rep = 0; rep < reps; ++rep)
+  {
+    gmTableIterator it;
+    for(gmTableNode * node = table->GetFirst(it); !table->IsNull(it); node = table->GetNext(it))
+    {
+      sum += node->m_value.m_value.m_int;
+    }
+  }
+  double iterateTime = Seconds(start);
+
+  double ops = (double) reps * a_count;
+  fprintf(stdout, "%-7s %8d %10.1f %10.1f %10.1f %10.1f\n", s_keyTypeNames[a_type], a_count,
+    insertTime * 1e9 / ops, lookupTime * 1e9 / ops, missTime * 1e9 / ops, iterateTime * 1e9 / ops);
+  if(sum != reps * a_count * 2) // lookups and iteration add 1 per entry, misses add GM_NULL (0)
+  {
+    fprintf(stdout, "unexpected result %d\n", sum);
+  }
+
+  a_machine->EnableGC(true);
+  a_machine->CollectGarbage(true);
+}
+
+
+int main(int argc, char* argv[])
+{
+  static const int counts[] = { 10, 1000, 1000000 };
+  const int maxCount = 1000000;
+
+  gmMachine* machine = new gmMachine;
+  s_keys = new gmVariable[maxCount];
+  s_order = new int[maxCount];
+
+  fprintf(stdout, "%s layout, ns per operation\n", GM_TABLE_OPEN_ADDRESSING ? "open addressing" : "chained");
+  fprintf(stdout, "%-7s %8s %10s %10s %10s %10s\n", "keys", "entries", "insert", "lookup", "miss", "iterate");
+  int type, size;
+  for(type = KEY_INT; type <= KEY_TABLE; ++type)
+  {
+    for(size = 0; size < (int) (sizeof(counts) / sizeof(counts[0])); ++size)
+    {
+      Bench(machine, (KeyType) type, counts[size]);
+    }
+  }
+
+  delete [] s_order;
+  delete [] s_keys;
+  delete machine;
+  return 0;
+}
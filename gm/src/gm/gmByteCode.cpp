@@ -13,6 +13,203 @@
 #include "gmByteCode.h"
 
 
+const char * gmGetByteCodeName(gmuint32 a_byteCode)
+{
+  switch(a_byteCode)
+  {
+    case BC_NOP : return "nop";
+    case BC_LINE : return "line";
+
+    case BC_GETDOT : return "get dot";
+    case BC_SETDOT : return "set dot";
+    case BC_GETIND : return "get index";
+    case BC_SETIND : return "set index";
+
+    case BC_BRA : return "bra";
+    case BC_BRZ : return "brz";
+    case BC_BRNZ : return "brnz";
+    case BC_BRZK : return "brzk";
+    case BC_BRNZK : return "brnzk";
+    case BC_CALL : return "call";
+    case BC_RET : return "ret";
+    case BC_RETV : return "retv";
+    case BC_FOREACH : return "foreach";
+    
+    case BC_POP : return "pop";
+    case BC_POP2 : return "pop2";
+    case BC_DUP : return "dup";
+    case BC_DUP2 : return "dup2";
+    case BC_SWAP : return "swap";
+    case BC_PUSHNULL : return "push null";
+    case BC_PUSHINT : return "push int";
+    case BC_PUSHINT0 : return "push int 0";
+    case BC_PUSHINT1 : return "push int 1";
+    case BC_PUSHFP : return "push fp";
+    case BC_PUSHSTR : return "push str";
+    case BC_PUSHTBL : return "push tbl";
+    case BC_PUSHFN : return "push fn";
+    case BC_PUSHTHIS : return "push this";
+    
+    case BC_GETLOCAL : return "get local";
+    case BC_SETLOCAL : return "set local";
+    case BC_GETGLOBAL : return "get global";
+    case BC_SETGLOBAL : return "set global";
+    case BC_GETTHIS : return "get this";
+    case BC_SETTHIS : return "set this";
+
+    case BC_OP_ADDI : return "add int";
+    case BC_OP_SUBI : return "sub int";
+    case BC_OP_LTI : return "lt int";
+    case BC_DUPGETDOT : return "dup get dot";
+    
+    case BC_OP_ADD : return "add";
+    case BC_OP_SUB : return "sub";
+    case BC_OP_MUL : return "mul";
+    case BC_OP_DIV : return "div";
+    case BC_OP_REM : return "rem";
+
+    case BC_BIT_OR : return "bor";
+    case BC_BIT_XOR : return "bxor";
+    case BC_BIT_AND : return "band";
+    case BC_BIT_INV : return "binv";
+    case BC_BIT_SHL : return "bshl";
+    case BC_BIT_SHR : return "bshr";
+    
+    case BC_OP_NEG : return "neg";
+    case BC_OP_POS : return "pos";
+    case BC_OP_NOT : return "not";
+    
+    case BC_OP_LT : return "lt";
+    case BC_OP_GT : return "gt";
+    case BC_OP_LTE : return "lte";
+    case BC_OP_GTE : return "gte";
+    case BC_OP_EQ : return "eq";
+    case BC_OP_NEQ : return "neq";
+
+    default : break;
+  }
+  return "ERROR";
+}
+
+
+int gmGetByteCodeOperandSize(gmuint32 a_byteCode)
+{
+  switch(a_byteCode)
+  {
+    case BC_GETDOT :
+    case BC_SETDOT :
+    case BC_BRA :
+    case BC_BRZ :
+    case BC_BRNZ :
+    case BC_BRZK :
+    case BC_BRNZK :
+    case BC_FOREACH :
+    case BC_PUSHINT :
+    case BC_PUSHSTR :
+    case BC_PUSHFN :
+    case BC_GETGLOBAL :
+    case BC_SETGLOBAL :
+    case BC_GETTHIS :
+    case BC_SETTHIS :
+    case BC_OP_ADDI :
+    case BC_OP_SUBI :
+    case BC_OP_LTI :
+    case BC_DUPGETDOT : return sizeof(gmptr);
+    case BC_PUSHFP : return sizeof(gmfloat);
+
+    case BC_CALL :
+    case BC_GETLOCAL :
+    case BC_SETLOCAL : return sizeof(gmuint32);
+
+    default : break;
+  }
+  return 0;
+}
+
+
+#if GM_BYTECODE_PROFILE
+
+static gmuint32 s_byteCodeCount[BC_MAX];
+static gmuint32 s_byteCodePairCount[BC_MAX][BC_MAX];
+static const gmuint8 * s_lastInstruction = NULL;
+static gmuint32 s_lastByteCode = BC_MAX;
+
+
+void gmByteCodeProfileCount(const gmuint8 * a_instruction)
+{
+  gmuint32 byteCode = *((const gmuint32 *) a_instruction);
+  if(byteCode >= BC_MAX) return;
+
+  ++s_byteCodeCount[byteCode];
+  if(s_lastByteCode < BC_MAX && s_lastInstruction + sizeof(gmuint32) + gmGetByteCodeOperandSize(s_lastByteCode) == a_instruction)
+  {
+    ++s_byteCodePairCount[s_lastByteCode][byteCode];
+  }
+  s_lastInstruction = a_instruction;
+  s_lastByteCode = byteCode;
+}
+
+
+void gmByteCodeProfileReset()
+{
+  memset(s_byteCodeCount, 0, sizeof(s_byteCodeCount));
+  memset(s_byteCodePairCount, 0, sizeof(s_byteCodePairCount));
+  s_lastInstruction = NULL;
+  s_lastByteCode = BC_MAX;
+}
+
+
+void gmByteCodeProfilePrint(FILE * a_fp, int a_maxPairs)
+{
+  // total
+  double total = 0.0;
+  gmuint32 i, j;
+  for(i = 0; i < BC_MAX; ++i) total += (double) s_byteCodeCount[i];
+  if(total == 0.0) total = 1.0;
+
+  fprintf(a_fp, "byte code profile, %.0f instructions"GM_NL, total);
+
+  // single byte codes, in order of frequency
+  bool printed[BC_MAX];
+  memset(printed, 0, sizeof(printed));
+  for(;;)
+  {
+    gmuint32 best = BC_MAX;
+    for(i = 0; i < BC_MAX; ++i)
+    {
+      if(!printed[i] && s_byteCodeCount[i] && (best == BC_MAX || s_byteCodeCount[i] > s_byteCodeCount[best])) best = i;
+    }
+    if(best == BC_MAX) break;
+    printed[best] = true;
+    fprintf(a_fp, "  %10u %5.1f%% %s"GM_NL, s_byteCodeCount[best], 100.0 * s_byteCodeCount[best] / total, gmGetByteCodeName(best));
+  }
+
+  // most frequent adjacent pairs
+  fprintf(a_fp, "byte code pairs"GM_NL);
+  bool pairPrinted[BC_MAX][BC_MAX];
+  memset(pairPrinted, 0, sizeof(pairPrinted));
+  for(int pair = 0; pair < a_maxPairs; ++pair)
+  {
+    gmuint32 bi = 0, bj = 0, best = 0;
+    for(i = 0; i < BC_MAX; ++i)
+    {
+      for(j = 0; j < BC_MAX; ++j)
+      {
+        if(!pairPrinted[i][j] && s_byteCodePairCount[i][j] > best)
+        {
+          best = s_byteCodePairCount[i][j]; bi = i; bj = j;
+        }
+      }
+    }
+    if(best == 0) break;
+    pairPrinted[bi][bj] = true;
+    fprintf(a_fp, "  %10u %5.1f%% %s, %s"GM_NL, best, 100.0 * best / total, gmGetByteCodeName(bi), gmGetByteCodeName(bj));
+  }
+}
+
+#endif // GM_BYTECODE_PROFILE
+
+
 #if GM_COMPILE_DEBUG
 
 void gmByteCodePrint(FILE * a_fp, const void * a_byteCode, int a_byteCodeLength)
@@ -26,97 +223,26 @@ void gmByteCodePrint(FILE * a_fp, const void * a_byteCode, int a_byteCodeLength)
   instruction = (const gmuint8 *) a_byteCode;
   const gmuint8 * end = instruction + a_byteCodeLength;
   const gmuint8 * start = instruction;
-  const char * cp;
-  bool opiptr, opf32;
 
   while(instruction < end)
   {
-    opiptr = false;
-    opf32 = false;
-
     int addr = instruction - start;
-
-    switch(*instruction)
-    {
-      case BC_NOP : cp = "nop"; break;
-      case BC_LINE : cp = "line"; break;
-
-      case BC_GETDOT : cp = "get dot"; opiptr = true; break;
-      case BC_SETDOT : cp = "set dot"; opiptr = true; break;
-      case BC_GETIND : cp = "get index"; break;
-      case BC_SETIND : cp = "set index"; break;
-
-      case BC_BRA : cp = "bra"; opiptr = true; break;
-      case BC_BRZ : cp = "brz"; opiptr = true; break;
-      case BC_BRNZ : cp = "brnz"; opiptr = true; break;
-      case BC_BRZK : cp = "brzk"; opiptr = true; break;
-      case BC_BRNZK : cp = "brnzk"; opiptr = true; break;
-      case BC_CALL : cp = "call"; opiptr = true; break;
-      case BC_RET : cp = "ret"; break;
-      case BC_RETV : cp = "retv"; break;
-      case BC_FOREACH : cp = "foreach"; opiptr = true; break;
-      
-      case BC_POP : cp = "pop"; break;
-      case BC_POP2 : cp = "pop2"; break;
-      case BC_DUP : cp = "dup"; break;
-      case BC_DUP2 : cp = "dup2"; break;
-      case BC_SWAP : cp = "swap"; break;
-      case BC_PUSHNULL : cp = "push null"; break;
-      case BC_PUSHINT : cp = "push int"; opiptr = true; break;
-      case BC_PUSHINT0 : cp = "push int 0"; break;
-      case BC_PUSHINT1 : cp = "push int 1"; break;
-      case BC_PUSHFP : cp = "push fp"; opf32 = true; break;
-      case BC_PUSHSTR : cp = "push str"; opiptr = true; break;
-      case BC_PUSHTBL : cp = "push tbl"; break;
-      case BC_PUSHFN : cp = "push fn"; opiptr = true; break;
-      case BC_PUSHTHIS : cp = "push this"; break;
-      
-      case BC_GETLOCAL : cp = "get local"; opiptr = true; break;
-      case BC_SETLOCAL : cp = "set local"; opiptr = true; break;
-      case BC_GETGLOBAL : cp = "get global"; opiptr = true; break;
-      case BC_SETGLOBAL : cp = "set global"; opiptr = true; break;
-      case BC_GETTHIS : cp = "get this"; opiptr = true; break;
-      case BC_SETTHIS : cp = "set this"; opiptr = true; break;
-      
-      case BC_OP_ADD : cp = "add"; break;
-      case BC_OP_SUB : cp = "sub"; break;
-      case BC_OP_MUL : cp = "mul"; break;
-      case BC_OP_DIV : cp = "div"; break;
-      case BC_OP_REM : cp = "rem"; break;
-
-      case BC_BIT_OR : cp = "bor"; break;
-      case BC_BIT_XOR : cp = "bxor"; break;
-      case BC_BIT_AND : cp = "band"; break;
-      case BC_BIT_INV : cp = "binv"; break;
-      case BC_BIT_SHL : cp = "bshl"; break;
-      case BC_BIT_SHR : cp = "bshr"; break;
-      
-      case BC_OP_NEG : cp = "neg"; break;
-      case BC_OP_POS : cp = "pos"; break;
-      case BC_OP_NOT : cp = "not"; break;
-      
-      case BC_OP_LT : cp = "lt"; break;
-      case BC_OP_GT : cp = "gt"; break;
-      case BC_OP_LTE : cp = "lte"; break;
-      case BC_OP_GTE : cp = "gte"; break;
-      case BC_OP_EQ : cp = "eq"; break;
-      case BC_OP_NEQ : cp = "neq"; break;
-
-      default : cp = "ERROR"; break;
-    }
+    gmuint32 byteCode = *instruction32;
+    const char * cp = gmGetByteCodeName(byteCode);
+    int operandSize = gmGetByteCodeOperandSize(byteCode);
 
     ++instruction32;
 
-    if(opf32)
+    if(byteCode == BC_PUSHFP)
     {
       float fval = *((float *) instruction);
-      instruction += sizeof(gmint32);
+      instruction += operandSize;
       fprintf(a_fp, "  %04d %s %f"GM_NL, addr, cp, fval);
     }
-    else if (opiptr)
+    else if(operandSize)
     {
       gmptr ival = *((gmptr *) instruction);
-      instruction += sizeof(gmptr);
+      instruction += operandSize;
       fprintf(a_fp, "  %04d %s %d"GM_NL, addr, cp, ival);
     }
     else
@@ -128,4 +254,3 @@ void gmByteCodePrint(FILE * a_fp, const void * a_byteCode, int a_byteCodeLength)
 
 
 #endif // GM_COMPILE_DEBUG
-
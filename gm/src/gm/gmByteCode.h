@@ -91,8 +91,33 @@ enum gmByteCode
   BC_SETGLOBAL,       // set global opptr (symbol id) --tos
   BC_GETTHIS,         // get this opptr (symbol id) ++tos
   BC_SETTHIS,         // set this opptr (symbol id) --tos
+
+  // superinstructions, fused from the most frequent adjacent pairs reported by GM_BYTECODE_PROFILE
+  BC_OP_ADDI,         // tos = tos + opptr (int constant), replaces push int, add
+  BC_OP_SUBI,         // tos = tos - opptr (int constant), replaces push int, sub
+  BC_OP_LTI,          // tos = tos < opptr (int constant), replaces push int, lt
+  BC_DUPGETDOT,       // tos + 1 = tos '.' opptr, ++tos, replaces dup, get dot for method calls
+
+  BC_MAX,             // number of byte codes, must be last
 };
 
+/// \brief gmGetByteCodeName() will return a printable name for a byte code
+const char * gmGetByteCodeName(gmuint32 a_byteCode);
+
+/// \brief gmGetByteCodeOperandSize() will return the number of operand bytes following a byte code
+int gmGetByteCodeOperandSize(gmuint32 a_byteCode);
+
+#if GM_BYTECODE_PROFILE
+
+/// \brief gmByteCodeProfileCount() is called by the vm for each executed instruction when GM_BYTECODE_PROFILE is set.
+///        Pairs are only counted when the second instruction directly follows the first in the byte code, as these
+///        are the only pairs that may be fused into a single instruction.
+void gmByteCodeProfileCount(const gmuint8 * a_instruction);
+void gmByteCodeProfileReset();
+void gmByteCodeProfilePrint(FILE * a_fp, int a_maxPairs = 32);
+
+#endif // GM_BYTECODE_PROFILE
+
 #if GM_COMPILE_DEBUG
 
 void gmByteCodePrint(FILE * a_fp, const void * a_byteCode, int a_byteCodeLength);
@@ -147,6 +147,12 @@ void gmByteCodeGen::AdjustStack(gmByteCode a_instruction)
     case BC_OP_GTE : --m_tos; break;
     case BC_OP_EQ : --m_tos; break;
     case BC_OP_NEQ : --m_tos; break;
+
+    // operand is pushed as a temporary when falling back to the binary operator
+    case BC_OP_ADDI :
+    case BC_OP_SUBI :
+    case BC_OP_LTI : if(m_tos + 1 > m_maxTos) m_maxTos = m_tos + 1; break;
+    case BC_DUPGETDOT : ++m_tos; break;
   }
 
   if(m_tos > m_maxTos) m_maxTos = m_tos;
@@ -21,6 +21,16 @@ static const char * s_tempVarName1 = "__t1";
 
 #define SIZEOF_BC_BRA   8
 
+#if GM_COMPILE_SUPERINSTRUCTIONS
+
+/// \brief gmIsIntConstant will return true if the node is an int constant that may be folded into an int constant operator
+static bool gmIsIntConstant(const gmCodeTreeNode * a_node)
+{
+  return (a_node && a_node->m_type == CTNT_EXPRESSION && a_node->m_subType == CTNET_CONSTANT && a_node->m_subTypeType == CTNCT_INT);
+}
+
+#endif // GM_COMPILE_SUPERINSTRUCTIONS
+
 /// \brief gmSortDebugLines will sort debug line information
 static void gmSortDebugLines(gmArraySimple<gmLineInfo> &a_lineInfo)
 {
@@ -976,6 +986,16 @@ bool gmCodeGenPrivate::GenExprOpAr(const gmCodeTreeNode * a_node, gmByteCodeGen
   GM_ASSERT(a_node->m_type == CTNT_EXPRESSION && a_node->m_subType == CTNET_OPERATION);
 
   if(!Generate(a_node->m_children[0], a_byteCode)) return false;
+
+#if GM_COMPILE_SUPERINSTRUCTIONS
+  if(gmIsIntConstant(a_node->m_children[1]))
+  {
+    gmptr value = *((gmptr *) &a_node->m_children[1]->m_data.m_iValue);
+    if(a_node->m_subTypeType == CTNOT_ADD) return a_byteCode->EmitPtr(BC_OP_ADDI, value);
+    if(a_node->m_subTypeType == CTNOT_MINUS) return a_byteCode->EmitPtr(BC_OP_SUBI, value);
+  }
+#endif // GM_COMPILE_SUPERINSTRUCTIONS
+
   if(!Generate(a_node->m_children[1], a_byteCode)) return false;
 
   switch(a_node->m_subTypeType)
@@ -1021,6 +1041,14 @@ bool gmCodeGenPrivate::GenExprOpComparison(const gmCodeTreeNode * a_node, gmByte
   GM_ASSERT(a_node->m_type == CTNT_EXPRESSION && a_node->m_subType == CTNET_OPERATION);
 
   if(!Generate(a_node->m_children[0], a_byteCode)) return false;
+
+#if GM_COMPILE_SUPERINSTRUCTIONS
+  if(a_node->m_subTypeType == CTNOT_LT && gmIsIntConstant(a_node->m_children[1]))
+  {
+    return a_byteCode->EmitPtr(BC_OP_LTI, *((gmptr *) &a_node->m_children[1]->m_data.m_iValue));
+  }
+#endif // GM_COMPILE_SUPERINSTRUCTIONS
+
   if(!Generate(a_node->m_children[1], a_byteCode)) return false;
 
   switch(a_node->m_subTypeType)
@@ -1303,8 +1331,12 @@ bool gmCodeGenPrivate::GenExprCall(const gmCodeTreeNode * a_node, gmByteCodeGen
   if(callee->m_type == CTNT_EXPRESSION && callee->m_subType == CTNET_OPERATION && callee->m_subTypeType == CTNOT_DOT)
   {
     if(!Generate(callee->m_children[0], a_byteCode)) return false;
+#if GM_COMPILE_SUPERINSTRUCTIONS
+    a_byteCode->EmitPtr(BC_DUPGETDOT, m_hooks->GetSymbolId(callee->m_children[1]->m_data.m_string));
+#else // !GM_COMPILE_SUPERINSTRUCTIONS
     a_byteCode->Emit(BC_DUP);
     a_byteCode->EmitPtr(BC_GETDOT, m_hooks->GetSymbolId(callee->m_children[1]->m_data.m_string));
+#endif // !GM_COMPILE_SUPERINSTRUCTIONS
   }
   else
   {
@@ -50,6 +50,7 @@ enum gmEndian
 // COMPILER CODE GENERATOR
 
 #define GM_COMPILE_PASS_THIS_ALWAYS 0         // set to 1 to pass current this to each function call
+#define GM_COMPILE_SUPERINSTRUCTIONS 1        // set to 1 to emit fused byte codes for common instruction pairs (see gmByteCode.h)
 
 // RUNTIME THREAD
 
@@ -71,7 +72,10 @@ enum gmEndian
 #define GMMACHINE_AUTOMEMALLOWSHRINK 0        // Allow memory liimits to shrink, otherwise memory will grow when needed only
 #define GMMACHINE_INITIALGCHARDLIMIT 128*1024  // default gc hard memory limit.
 #define GMMACHINE_INITIALGCSOFTLIMIT (GMMACHINE_INITIALGCHARDLIMIT * 9 / 10) // default gc soft memory limit
-#define GMMACHINE_STRINGHASHSIZE    8192      // this will be dynamic... todo
+#define GMMACHINE_STRINGHASHSIZE    8192      // initial (and smallest) size of the string intern table (power of 2)
+#define GMMACHINE_STRINGHASHGROW    1         // let the string intern table grow and shrink with the number of strings, see gmHash::SetGrowable()
+#define GMHASH_REHASHSTEP           4         // slots moved to the new table per insert while a growable gmHash resizes
+#define GMMACHINE_MEMBERCACHESIZE   1024      // inline cache slots for member access instructions, indexed by instruction address (power of 2, 0 to disable)
 #define GMMACHINE_MAXKILLEDTHREADS  16        // max size of the free thread list (don't make too large, ie, < 32)
 #define GMMACHINE_GCEVERYALLOC      0         // define this to check garbage collection every allocate.
 #define GMMACHINE_SUPERPARANOIDGC   0         // validate references (only for debugging purposes)
@@ -95,10 +99,26 @@ enum gmEndian
 // DEBUGGING
 
 #define GMDEBUG_SUPPORT             1         // allow use with the gm debugger
+#define GM_BYTECODE_PROFILE         0         // count executed byte codes and adjacent byte code pairs, see gmByteCodeProfilePrint()
+
+// VIRTUAL MACHINE
+
+#define GM_USE_COMPUTED_GOTO        1         // use gcc "labels as values" threaded dispatch in gmThread::Sys_Execute where supported
+#define GM_TABLE_OPEN_ADDRESSING    1         // gmTableObject uses open addressing with a mixed key hash and probes a group of control bytes at once
+                                              // (16 with GM_SSE2), 0 for chained nodes hashed by the raw key value
 
 
 // GARBAGE COLLECTOR
 #define GM_USE_INCGC                1         // use incremental garbage collector
+#if defined(GM_THREADS)
+#define GM_GC_BACKGROUND_FREE       1         // allow big blocks of collected objects to be returned to the system on a worker thread, see gmMachine::SetBackgroundFree().
+                                              // Only blocks of GM_GC_BACKGROUND_FREE_MIN bytes or more move to the worker; objects are destructed,
+                                              // and their headers and small blocks returned to the pools, on the collecting thread
+#else // !GM_THREADS
+#define GM_GC_BACKGROUND_FREE       0         // no thread api on this platform (GM_THREADS in gmConfig_p.h)
+#endif // !GM_THREADS
+#define GM_GC_BACKGROUND_FREE_MIN   (512*1024) // smallest block handed to the worker. System heaps map blocks this large directly and unmap them on free,
+                                              // smaller blocks are cheaper to free in place than across threads
 
 
 #define GM_BOOL_OP                  1         // Spport for a bool operator on user types for use in if statements. For full effect, users will want to implement operators [bool, ==, !=, !]
@@ -150,7 +150,11 @@ bool gmFunctionObject::Init(gmMachine * a_machine, bool a_debug, gmFunctionInfo
         case BC_GETGLOBAL :
         case BC_SETGLOBAL :
         case BC_GETTHIS :
-        case BC_SETTHIS : instruction += sizeof(gmptr); break;
+        case BC_SETTHIS :
+        case BC_OP_ADDI :
+        case BC_OP_SUBI :
+        case BC_OP_LTI :
+        case BC_DUPGETDOT : instruction += sizeof(gmptr); break;
         case BC_PUSHFP : instruction += sizeof(gmfloat); break;
       
         case BC_CALL :
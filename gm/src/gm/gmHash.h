@@ -76,9 +76,9 @@ public:
       {
         m_elem = m_hash->GetNext(m_elem);
       }
-      while(m_elem == NULL && m_slot < m_hash->m_size)
+      while(m_elem == NULL && m_slot < m_hash->m_size + m_hash->m_oldSize)
       {
-        m_elem = m_hash->m_table[m_slot++];
+        m_elem = m_hash->GetSlot(m_slot++);
       }
     }
   
@@ -121,15 +121,55 @@ public:
   /// \brief Find()
   T * Find(const KEY &a_key);
 
+  /// \brief SetGrowable() lets the table double its size when Count() exceeds it, and halve it (down to a_minSize) when
+  ///        Count() drops below a quarter of it. Items move to the new table GMHASH_REHASHSTEP slots per Insert(), so a
+  ///        resize never rehashes the whole table at once. Only Insert() restructures the table.
+  void SetGrowable(bool a_growable, gmuint a_minSize);
+
   inline gmuint Count() const { return m_count; }
   inline Iterator First() const { return Iterator(this); }
 
+  /// \brief GetSize() returns the number of slots, Count() / GetSize() is the load factor
+  inline gmuint GetSize() const { return m_size; }
+  /// \brief IsResizing() returns true while items are moving to a new table
+  inline bool IsResizing() const { return (m_oldTable != NULL); }
+  /// \brief GetRehashWork() returns the number of items moved by resizes so far
+  inline gmuint GetRehashWork() const { return m_rehashWork; }
+  /// \brief GetLongestChain() returns the length of the longest slot chain, walks the whole table
+  gmuint GetLongestChain() const;
+
 private:
 
   T * GetNext(T * a_elem) const { return a_elem->NQUAL::m_next; }
+
+  /// \brief a slot of the new table is cleared and used once the first old slot that moves into it has moved
+  inline bool IsSlotReady(gmuint a_slot) const { return (m_oldTable == NULL) || ((a_slot & (m_oldSize - 1)) < m_rehashPos); }
+  /// \brief GetSlot() returns slot chains of the new table followed by those of the old one
+  inline T * GetSlot(gmuint a_slot) const
+  {
+    if(a_slot < m_size) return IsSlotReady(a_slot) ? m_table[a_slot] : NULL;
+    return m_oldTable[a_slot - m_size];
+  }
+  /// \brief GetOldSlot() returns the old table slot chain of a hash that has not moved yet, or NULL
+  inline T ** GetOldSlot(gmuint a_hash) const
+  {
+    if(m_oldTable == NULL || (a_hash & (m_oldSize - 1)) < m_rehashPos) return NULL;
+    return &m_oldTable[a_hash & (m_oldSize - 1)];
+  }
+
+  static T * FindInChain(T * a_node, const KEY &a_key);
+  static T * RemoveFromChain(T ** a_node, T * a_item);
+  void Resize(gmuint a_size);
+  void RehashStep(gmuint a_slots);
+
   T ** m_table;
   gmuint m_count;
   gmuint m_size;
+  T ** m_oldTable;        //!< table being emptied into m_table by a resize
+  gmuint m_oldSize;
+  gmuint m_rehashPos;     //!< next slot of m_oldTable to move
+  gmuint m_minSize;       //!< smallest size of a growable table, 0 if the table is fixed
+  gmuint m_rehashWork;
 
   friend class Iterator;
 };
@@ -195,18 +235,29 @@ QUAL::gmHash(gmuint a_size)
     m_table[i] = NULL;
   }
   m_count = 0;
+  m_oldTable = NULL;
+  m_oldSize = 0;
+  m_rehashPos = 0;
+  m_minSize = 0;
+  m_rehashWork = 0;
 }
 
 TMPL
 QUAL::~gmHash()
 {
   delete [] m_table;
+  delete [] m_oldTable;
 }
 
 
 TMPL
 void QUAL::RemoveAll()
 {
+  delete [] m_oldTable;
+  m_oldTable = NULL;
+  m_oldSize = 0;
+  m_rehashPos = 0;
+
   int i = m_size;
   while(i--)
   {
@@ -220,28 +271,44 @@ TMPL
 void QUAL::RemoveAndDeleteAll()
 {
   // iterate over table and delete all
-  int i = m_size;
+  int i = m_size + m_oldSize;
   T * node, * next;
   while(i--)
   {
-    node = m_table[i];
+    node = GetSlot(i);
     while(node)
     {
       next = node->NQUAL::m_next;
       delete node;
       node = next;
     }
-    m_table[i] = NULL;
   }
-  m_count = 0;
+  RemoveAll();
 }
 
 
 TMPL
 T * QUAL::Insert(T * a_node)
 {
-  gmuint slot = HASHER::Hash(a_node->GetKey()) & (m_size - 1);
-  T ** node = &m_table[slot];
+  gmuint hash = HASHER::Hash(a_node->GetKey());
+  gmuint slot = hash & (m_size - 1);
+  T ** oldSlot = GetOldSlot(hash);
+  T ** node;
+
+  if(IsSlotReady(slot))
+  {
+    node = &m_table[slot];
+    if(oldSlot) // shrinking, the key may still be in the old table
+    {
+      T * found = FindInChain(*oldSlot, a_node->GetKey());
+      if(found) return found;
+    }
+  }
+  else
+  {
+    GM_ASSERT(oldSlot);
+    node = oldSlot; // the new slot is not used yet, the key can only be in the old table
+  }
 
   while(*node)
   {
@@ -254,6 +321,22 @@ T * QUAL::Insert(T * a_node)
   a_node->NQUAL::m_next = *node;
   *node = a_node;
   ++m_count;
+
+  if(m_minSize)
+  {
+    if(m_oldTable)
+    {
+      RehashStep(GMHASH_REHASHSTEP);
+    }
+    else if(m_count > m_size)
+    {
+      Resize(m_size << 1);
+    }
+    else if(m_count < (m_size >> 2) && m_size > m_minSize)
+    {
+      Resize(m_size >> 1);
+    }
+  }
   return NULL;
 }
 
@@ -261,20 +344,24 @@ T * QUAL::Insert(T * a_node)
 TMPL
 T * QUAL::Remove(T * a_node)
 {
-  gmuint slot = HASHER::Hash(a_node->GetKey()) & (m_size - 1);
-  T ** node = &m_table[slot];
+  gmuint hash = HASHER::Hash(a_node->GetKey());
+  gmuint slot = hash & (m_size - 1);
+  T ** oldSlot = GetOldSlot(hash);
+  T * found = NULL;
 
-  while(*node)
+  if(IsSlotReady(slot))
   {
-    if(a_node == *node)
-    {
-      *node = a_node->NQUAL::m_next;
-      --m_count;
-      return a_node;
-    }
-    node = &((*node)->NQUAL::m_next);
+    found = RemoveFromChain(&m_table[slot], a_node);
   }
-  return NULL;
+  if(found == NULL && oldSlot)
+  {
+    found = RemoveFromChain(oldSlot, a_node);
+  }
+  if(found)
+  {
+    --m_count;
+  }
+  return found;
 }
 
 
@@ -295,52 +382,174 @@ T * QUAL::Remove(Iterator & a_it)
 TMPL
 T * QUAL::RemoveKey(const KEY &a_key)
 {
-  gmuint slot = HASHER::Hash(a_key) & (m_size - 1);
-  T ** node = &m_table[slot];
-  T * found;
+  gmuint hash = HASHER::Hash(a_key);
+  gmuint slot = hash & (m_size - 1);
+  T ** oldSlot = GetOldSlot(hash);
+  T ** node = NULL;
+  T * found = NULL;
 
-  while(*node)
+  if(IsSlotReady(slot))
+  {
+    node = &m_table[slot];
+    found = FindInChain(*node, a_key);
+  }
+  if(found == NULL && oldSlot)
+  {
+    node = oldSlot;
+    found = FindInChain(*node, a_key);
+  }
+  if(found)
+  {
+    RemoveFromChain(node, found);
+    --m_count;
+  }
+  return found;
+}
+
+
+TMPL
+T * QUAL::Find(const KEY &a_key)
+{
+  gmuint hash = HASHER::Hash(a_key);
+  gmuint slot = hash & (m_size - 1);
+  T * node = NULL;
+
+  if(IsSlotReady(slot))
+  {
+    node = FindInChain(m_table[slot], a_key);
+  }
+  if(node == NULL && m_oldTable)
+  {
+    T ** oldSlot = GetOldSlot(hash);
+    if(oldSlot) node = FindInChain(*oldSlot, a_key);
+  }
+  return node;
+}
+
+
+TMPL
+void QUAL::SetGrowable(bool a_growable, gmuint a_minSize)
+{
+  // make sure size is power of 2
+  GM_ASSERT((a_minSize & (a_minSize - 1)) == 0);
+  m_minSize = (a_growable) ? ((a_minSize) ? a_minSize : 1) : 0;
+  if(!a_growable)
   {
-    int compare = HASHER::Compare((*node)->GetKey(), a_key);
+    RehashStep(m_oldSize); // finish a resize in progress
+  }
+}
+
+
+TMPL
+gmuint QUAL::GetLongestChain() const
+{
+  gmuint longest = 0;
+  gmuint i = m_size + m_oldSize;
+  while(i--)
+  {
+    gmuint length = 0;
+    for(T * node = GetSlot(i); node; node = node->NQUAL::m_next)
+    {
+      ++length;
+    }
+    if(length > longest) longest = length;
+  }
+  return longest;
+}
+
+
+TMPL
+T * QUAL::FindInChain(T * a_node, const KEY &a_key)
+{
+  while(a_node)
+  {
+    int compare = HASHER::Compare(static_cast<T*>(a_node)->GetKey(), a_key);
     if(compare == 0)
     {
-      --m_count;
-      found = *node;
-      *node = found->NQUAL::m_next;
-      return (found);
+      return a_node;
     }
     else if(compare > 0)
     {
       return NULL;
     }
-    node = &((*node)->NQUAL::m_next);
+    a_node = a_node->NQUAL::m_next;
   }
   return NULL;
 }
 
 
 TMPL
-T * QUAL::Find(const KEY &a_key)
+T * QUAL::RemoveFromChain(T ** a_node, T * a_item)
 {
-  gmuint slot = HASHER::Hash(a_key) & (m_size - 1);
-  T * node = m_table[slot];
+  while(*a_node)
+  {
+    if(a_item == *a_node)
+    {
+      *a_node = a_item->NQUAL::m_next;
+      return a_item;
+    }
+    a_node = &((*a_node)->NQUAL::m_next);
+  }
+  return NULL;
+}
+
+
+TMPL
+void QUAL::Resize(gmuint a_size)
+{
+  GM_ASSERT(m_oldTable == NULL);
+
+  // slots of the new table are cleared by RehashStep() as items move into them
+  m_oldTable = m_table;
+  m_oldSize = m_size;
+  m_rehashPos = 0;
+  m_table = GM_NEW(T * [a_size]);
+  m_size = a_size;
+}
+
+
+TMPL
+void QUAL::RehashStep(gmuint a_slots)
+{
+  if(m_oldTable == NULL) return;
 
-  while(node)
+  while(a_slots-- && m_rehashPos < m_oldSize)
   {
-    int compare = HASHER::Compare(static_cast<T*>(node)->GetKey(), a_key);
-    if(compare == 0)
+    // clear the new slots this is the first old slot to move into
+    gmuint i;
+    for(i = m_rehashPos; i < m_size; i += m_oldSize)
     {
-      return node;
+      m_table[i] = NULL;
     }
-    else if(compare > 0)
+
+    // chains are sorted, move items keeping them sorted
+    T * node = m_oldTable[m_rehashPos];
+    while(node)
     {
-      return NULL;
+      T * next = node->NQUAL::m_next;
+      T ** dest = &m_table[HASHER::Hash(node->GetKey()) & (m_size - 1)];
+      while(*dest && HASHER::Compare(node->GetKey(), (*dest)->GetKey()) > 0)
+      {
+        dest = &((*dest)->NQUAL::m_next);
+      }
+      node->NQUAL::m_next = *dest;
+      *dest = node;
+      ++m_rehashWork;
+      node = next;
     }
-    node = node->NQUAL::m_next;
+    m_oldTable[m_rehashPos++] = NULL;
+  }
+
+  if(m_rehashPos >= m_oldSize)
+  {
+    delete [] m_oldTable;
+    m_oldTable = NULL;
+    m_oldSize = 0;
+    m_rehashPos = 0;
   }
-  return NULL;
 }
 
+
 #undef TMPL
 #undef QUAL
 #undef NQUAL
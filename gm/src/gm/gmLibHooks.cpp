@@ -316,6 +316,9 @@ gmFunctionObject * gmLibHooks::BindLib(gmMachine &a_machine, gmStream &a_stream,
         case BC_BRNZK :
         case BC_FOREACH :
         case BC_PUSHINT :
+        case BC_OP_ADDI :
+        case BC_OP_SUBI :
+        case BC_OP_LTI :
         case BC_PUSHFP : instruction += sizeof(gmfloat); break;
 
         case BC_CALL :
@@ -324,6 +327,7 @@ gmFunctionObject * gmLibHooks::BindLib(gmMachine &a_machine, gmStream &a_stream,
 
         case BC_GETDOT :
         case BC_SETDOT :
+        case BC_DUPGETDOT :
         case BC_GETTHIS :
         case BC_SETTHIS :
         case BC_GETGLOBAL :
@@ -233,6 +233,8 @@ gmMachine::gmMachine()
   m_statsGCIncCollect = 0;
   m_statsGCWarnings = 0;
 
+  m_strings.SetGrowable(GMMACHINE_STRINGHASHGROW != 0, GMMACHINE_STRINGHASHSIZE);
+
   m_debug = false;
   m_debugUser = NULL;
 
@@ -240,6 +242,10 @@ gmMachine::gmMachine()
 
   m_global = AllocTableObject(); // Alloc global table
 
+#if GMMACHINE_MEMBERCACHESIZE
+  memset(m_memberCache, 0, sizeof(m_memberCache));
+#endif // GMMACHINE_MEMBERCACHESIZE
+
   m_types.SetCount(0);
 
   ResetDefaultTypes();
@@ -524,6 +530,7 @@ bool gmMachine::RegisterTypeOperator(gmType a_type, gmOperator a_operator, gmFun
   if(a_function)
   {
     m_types[a_type].m_operators[a_operator] = a_function->GetRef();
+    m_types[a_type].m_nativeOperators[a_operator] = NULL; // Native operators take precedence so remove the default one
   }
   else if(a_nativeFunction)
   {
@@ -1161,6 +1168,11 @@ bool gmMachine::CollectGarbage(bool a_forceFullCollect)
   bool result = false;
   if(m_gcEnabled)
   {
+#if GM_GC_BACKGROUND_FREE
+    // Big blocks freed by destructed objects go to the background free worker, if running
+    m_fixedSet.BeginDeferredFree();
+#endif // GM_GC_BACKGROUND_FREE
+
     GM_ASSERT(GetDesiredByteMemoryUsageSoft() <= GetDesiredByteMemoryUsageHard());
     GM_ASSERT(GetDesiredByteMemoryUsageHard() > 0);
     
@@ -1291,6 +1303,10 @@ bool gmMachine::CollectGarbage(bool a_forceFullCollect)
         }
       }
     }
+
+#if GM_GC_BACKGROUND_FREE
+    m_fixedSet.EndDeferredFree();
+#endif // GM_GC_BACKGROUND_FREE
   }
 
   return result;
@@ -1303,6 +1319,26 @@ bool gmMachine::IsGCRunning()
 }
 
 
+bool gmMachine::SetBackgroundFree(bool a_enable)
+{
+#if GM_GC_BACKGROUND_FREE
+  return m_fixedSet.SetBackgroundFree(a_enable);
+#else // !GM_GC_BACKGROUND_FREE
+  return !a_enable;
+#endif // !GM_GC_BACKGROUND_FREE
+}
+
+
+bool gmMachine::GetBackgroundFree() const
+{
+#if GM_GC_BACKGROUND_FREE
+  return m_fixedSet.GetBackgroundFree();
+#else // !GM_GC_BACKGROUND_FREE
+  return false;
+#endif // !GM_GC_BACKGROUND_FREE
+}
+
+
 #else //GM_USE_INCGC
 
 bool gmMachine::CollectGarbage(bool a_forceFullCollect)
@@ -1430,12 +1466,21 @@ gmStringObject * gmMachine::AllocStringObject(const char * a_string, int a_lengt
     a_length = strlen(a_string);
   }
   char * string = (char *) Sys_Alloc(a_length + 1);
+  if(!string)
+  {
+    return NULL;
+  }
   memcpy(string, a_string, a_length + 1);
 
 #if GMMACHINE_GCEVERYALLOC
   CollectGarbage();
 #endif
   newStringObj = (gmStringObject *) m_memStringObj.Alloc();
+  if(!newStringObj)
+  {
+    Sys_Free(string);
+    return NULL;
+  }
 
   GM_PLACEMENT_NEW( gmStringObject(string, a_length), newStringObj );
 
@@ -1458,6 +1503,10 @@ gmStringObject * gmMachine::AllocStringObject(const char * a_string, int a_lengt
 gmStringObject * gmMachine::AllocPermanantStringObject(const char * a_string, int a_length)
 {
   gmStringObject * newStringObj = AllocStringObject(a_string, a_length);
+  if(!newStringObj)
+  {
+    return NULL;
+  }
 #if GM_USE_INCGC 
   newStringObj->SetPersist(true);
   #if GM_GC_KEEP_PERSISTANT_SEPARATE
@@ -1480,6 +1529,10 @@ gmTableObject * gmMachine::AllocTableObject()
   CollectGarbage();
 #endif
   gmTableObject * newTableObj = (gmTableObject *) m_memTableObj.Alloc();
+  if(!newTableObj)
+  {
+    return NULL;
+  }
   GM_PLACEMENT_NEW(gmTableObject, newTableObj);
 
 #if GM_USE_INCGC
@@ -1501,6 +1554,10 @@ gmFunctionObject * gmMachine::AllocFunctionObject(gmCFunction a_function)
   CollectGarbage();
 #endif
   gmFunctionObject * newFunctionObj = (gmFunctionObject *) m_memFunctionObj.Alloc();
+  if(!newFunctionObj)
+  {
+    return NULL;
+  }
    GM_PLACEMENT_NEW(gmFunctionObject, newFunctionObj);
   
 #if GM_USE_INCGC
@@ -1524,6 +1581,10 @@ gmUserObject * gmMachine::AllocUserObject(void * a_user, int a_userType)
   CollectGarbage();
 #endif
   gmUserObject * newUserObj = (gmUserObject *) m_memUserObj.Alloc();
+  if(!newUserObj)
+  {
+    return NULL;
+  }
   gmConstructElement<gmUserObject>(newUserObj);
 
 #if GM_USE_INCGC
@@ -1551,6 +1612,13 @@ void gmMachine::Sys_FreeUniqueString(const char * a_string)
 
 
 
+int gmMachine::GetStatsStringLongestChain()
+{
+  return m_strings.GetLongestChain();
+}
+
+
+
 int gmMachine::GetThreadId()
 {
   while(GetThread(++m_threadId)) {}
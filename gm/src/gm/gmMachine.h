@@ -210,6 +210,7 @@ public:
   void RegisterTypeVariable(gmType a_type, const char * a_variableName, const gmVariable &a_variable);
 
   /// \brief RegisterTypeOperator() will let you regiester operators for user types only.
+  ///        Registering a function replaces the default native operator (e.g. reference equality) of the type.
   /// \param a_operator
   /// \param a_function
   /// \param a_nativeFunction
@@ -218,6 +219,9 @@ public:
   /// \brief GetTypeVariable() will lookup the type variables for the given variable key.
   inline gmVariable GetTypeVariable(gmType a_type, const gmVariable &a_key) const;
 
+  /// \brief GetTypeVariableCached() will lookup the type variables using an inline cache slot, see gmTableObject::GetCached()
+  inline gmVariable GetTypeVariableCached(gmType a_type, const gmVariable &a_key, int &a_cacheIndex) const;
+
   /// \brief GetTypeNativeOperator() will lookup a type for a native operator
   inline gmOperatorFunction GetTypeNativeOperator(gmType a_type, gmOperator a_operator);
 
@@ -383,6 +387,17 @@ public:
   /// \brief Is automatic memory limit calculation enabled?
   inline bool GetAutoMemoryUsage() const          { return m_autoMem; }
 
+  /// \brief SetBackgroundFree() will start (or stop) a worker thread that returns big blocks freed by collected objects
+  ///        (table nodes, byte code, large strings of GM_GC_BACKGROUND_FREE_MIN bytes or more) to the system. Nothing
+  ///        else moves to the worker: objects, including those without a user gc callback, are still destructed
+  ///        during CollectGarbage(), and their headers and smaller blocks go back to the pools there.
+  /// \return true if background free is now enabled as requested, false if thread creation failed or it is not
+  ///         compiled in (GM_GC_BACKGROUND_FREE).
+  bool SetBackgroundFree(bool a_enable);
+
+  /// \brief Is the background free worker running?
+  bool GetBackgroundFree() const;
+
   /// \brief GetSystemMemUsed will return the number of bytes allocated by the system.  This is slow, call for debug only
   unsigned int GetSystemMemUsed() const;
 
@@ -428,10 +443,18 @@ public:
   ///        are common to all threads.
   inline gmTableObject * GetGlobals() { return m_global; }
 
+#if GMMACHINE_MEMBERCACHESIZE
+  /// \brief GetMemberCacheSlot() will return the inline cache slot for a member access instruction.  Slots only hold
+  ///        a node index hint that is validated on use, so instructions sharing a slot only cost misses.
+  inline int &GetMemberCacheSlot(const void * a_instruction) { return m_memberCache[((gmuptr) a_instruction >> 2) & (GMMACHINE_MEMBERCACHESIZE - 1)]; }
+#endif // GMMACHINE_MEMBERCACHESIZE
+
   /// \brief GetObject() will convert a gmptr (machine pointer size int) into an object pointer.  use this whenever
   ///        converting from a gmVariable m_value.m_ref to an object.
   inline gmObject * GetObject(gmptr a_ref);
 
+  // The Alloc*Object() functions return NULL when the machine is out of memory.
+
   /// \brief AllocStringObject() will create a constant string object from the unique string pool.
   /// \param a_length is the string length not including '\0' terminator, (-1) if unknown
   gmStringObject * AllocStringObject(const char * a_string, int a_length = -1);
@@ -518,6 +541,11 @@ public:
   inline int GetStatsGCNumFullCollects()          { return m_statsGCFullCollect; }
   inline int GetStatsGCNumIncCollects()           { return m_statsGCIncCollect; }
   inline int GetStatsGCNumWarnings()              { return m_statsGCWarnings; }
+  inline int GetStatsStringCount()                { return m_strings.Count(); }
+  inline int GetStatsStringTableSize()            { return m_strings.GetSize(); }
+  inline int GetStatsStringRehashWork()           { return m_strings.GetRehashWork(); } ///< Strings moved by intern table resizes so far
+  /// \brief Length of the longest string intern table chain, walks the whole table
+  int GetStatsStringLongestChain();
   /// \brief Is GC actually running a cycle
   bool IsGCRunning();
 
@@ -578,6 +606,11 @@ protected:
   // String Table
   gmHash<const char *, gmStringObject> m_strings;
 
+#if GMMACHINE_MEMBERCACHESIZE
+  // Inline cache for member access instructions
+  int m_memberCache[GMMACHINE_MEMBERCACHESIZE];
+#endif // GMMACHINE_MEMBERCACHESIZE
+
   // Types
   class Type
   {
@@ -668,6 +701,13 @@ inline gmVariable gmMachine::GetTypeVariable(gmType a_type, const gmVariable &a_
 
 
 
+inline gmVariable gmMachine::GetTypeVariableCached(gmType a_type, const gmVariable &a_key, int &a_cacheIndex) const
+{
+  return m_types[a_type].m_variables->GetCached(a_key, a_cacheIndex);
+}
+
+
+
 inline gmOperatorFunction gmMachine::GetTypeNativeOperator(gmType a_type, gmOperator a_operator)
 {
   return m_types[a_type].m_nativeOperators[a_operator];
@@ -13,10 +13,128 @@
 #include "gmMemChain.h"
 #include "gmMem.h"
 
+#ifdef GM_64BIT_PTR
+
+// gmptr object references are 32 bit (see GM_64BIT_PTR), gm objects are allocated from memory chains
+// so on 64 bit targets the chunks are placed below GM_CHUNK_LIMIT. gmptr is signed and references are
+// cast back to pointers through it, so the limit is 2GB rather than 4GB; above it they'd be sign extended.
+// Chunk sizes are rounded up to the system allocation granularity and the chain uses the whole rounded
+// size. gmAllocChunk() returns NULL once no address range below the limit is left, and the chain Alloc
+// functions then return NULL. Several machines may allocate chunks from different threads, so the search
+// hint is read and written atomically.
+
+#define GM_CHUNK_LIMIT 0x80000000ULL
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#define GM_CHUNK_GRANULARITY 0x10000
+
+static void * gmAllocChunk(unsigned int a_size)
+{
+  static volatile LONG64 s_hint = GM_CHUNK_GRANULARITY;
+  ULONG_PTR start = (ULONG_PTR) InterlockedCompareExchange64(&s_hint, 0, 0), addr = start;
+  for(;;)
+  {
+    if(addr + a_size >= GM_CHUNK_LIMIT)
+    {
+      if(start == GM_CHUNK_GRANULARITY) break;
+      start = addr = GM_CHUNK_GRANULARITY; // wrap around once, chunks may have been freed
+    }
+    void * mem = VirtualAlloc((void *) addr, a_size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if(mem)
+    {
+      InterlockedExchange64(&s_hint, (LONG64) (addr + a_size));
+      return mem;
+    }
+    addr += GM_CHUNK_GRANULARITY;
+  }
+  GM_ASSERT(!"out of memory below GM_CHUNK_LIMIT");
+  return NULL;
+}
+
+static void gmFreeChunk(void * a_mem, unsigned int a_size)
+{
+  VirtualFree(a_mem, 0, MEM_RELEASE);
+}
+
+#else // !_WIN32
+
+#include <sys/mman.h>
+
+#define GM_CHUNK_GRANULARITY 0x1000
+#define GM_CHUNK_HINT_STEP   0x10000
+
+static inline void * gmMapChunk(unsigned long long a_hint, unsigned int a_size, int a_flags)
+{
+  void * mem = mmap((void *) (size_t) a_hint, a_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | a_flags, -1, 0);
+  if(mem == MAP_FAILED) return NULL;
+  if((unsigned long long) mem + a_size >= GM_CHUNK_LIMIT)
+  {
+    munmap(mem, a_size); // hint was not taken, the system placed the chunk above the limit
+    return NULL;
+  }
+  return mem;
+}
+
+static void * gmAllocChunk(unsigned int a_size)
+{
+  void * mem;
+#ifdef MAP_32BIT
+  // MAP_32BIT places chunks in the low 2GB, the hinted search below takes over where it fails
+  mem = gmMapChunk(0, a_size, MAP_32BIT);
+  if(mem) return mem;
+#endif // MAP_32BIT
+  static unsigned long long s_hint = 0x10000000; // gmuptr may be 32 bit, see GM_64BIT_PTR
+  unsigned long long start = __atomic_load_n(&s_hint, __ATOMIC_RELAXED), addr = start;
+  for(;;)
+  {
+    if(addr + a_size >= GM_CHUNK_LIMIT)
+    {
+      if(start == GM_CHUNK_HINT_STEP) break;
+      start = addr = GM_CHUNK_HINT_STEP; // wrap around once, chunks may have been freed
+    }
+    mem = gmMapChunk(addr, a_size, 0);
+    if(mem)
+    {
+      __atomic_store_n(&s_hint, (unsigned long long) mem + a_size, __ATOMIC_RELAXED);
+      return mem;
+    }
+    addr += GM_CHUNK_HINT_STEP;
+  }
+  GM_ASSERT(!"out of memory below GM_CHUNK_LIMIT");
+  return NULL;
+}
+
+static void gmFreeChunk(void * a_mem, unsigned int a_size)
+{
+  munmap(a_mem, a_size);
+}
+
+#endif // !_WIN32
+
+#else // !GM_64BIT_PTR
+
+static inline void * gmAllocChunk(unsigned int a_size)
+{
+  return GM_NEW( char[a_size] );
+}
+
+static inline void gmFreeChunk(void * a_mem, unsigned int a_size)
+{
+  delete [] (char*)a_mem;
+}
+
+#endif // !GM_64BIT_PTR
+
 
 gmMemChain::gmMemChain(unsigned int a_elementSize, unsigned int a_numElementsInChunk)
 {
   m_chunkSize = a_numElementsInChunk * a_elementSize;
+#ifdef GM_CHUNK_GRANULARITY
+  m_chunkSize = ((sizeof(MemChunk) + m_chunkSize + GM_CHUNK_GRANULARITY - 1) & ~(GM_CHUNK_GRANULARITY - 1)) - sizeof(MemChunk);
+#endif // GM_CHUNK_GRANULARITY
   m_elementSize = a_elementSize;
   m_rootChunk = NULL;
   m_currentChunk = NULL;
@@ -45,7 +163,7 @@ void gmMemChain::FreeChunks()
       chunkToFree = curChunk;
       curChunk = curChunk->m_nextChunk;
       
-      delete [] (char*)chunkToFree;
+      gmFreeChunk(chunkToFree, sizeof(MemChunk) + m_chunkSize);
     }
   }
 }
@@ -77,7 +195,7 @@ void gmMemChain::Presize(int a_kbytes)
   MemChunk * currentChunk = m_currentChunk;
   while(numChunks > 0)
   {
-    NewChunk();
+    if(!NewChunk()) break;
     --numChunks;
   }
   if(currentChunk)
@@ -100,12 +218,16 @@ gmMemChain::MemChunk* gmMemChain::NewChunk()
   }
   else //No, allocate a new one
   {
-    char * mem = (char *) GM_NEW( char[sizeof(MemChunk) + m_chunkSize] );
+    char * mem = (char *) gmAllocChunk(sizeof(MemChunk) + m_chunkSize);
+    if(!mem)
+    {
+      return NULL; // out of memory, chain is left as it was
+    }
     newChunk = (MemChunk *) mem;
   
     //Allocate memory and set address space
     newChunk->m_minAddress = mem + sizeof(MemChunk);
-    newChunk->m_lastAddress = (void*)((unsigned int)newChunk->m_minAddress + m_chunkSize);
+    newChunk->m_lastAddress = (void*)((gmuptr)newChunk->m_minAddress + m_chunkSize);
     newChunk->m_curAddress = newChunk->m_minAddress;
 
     //Link new chunk to chain
@@ -133,13 +255,13 @@ void* gmMemChain::Alloc()
   //Allocate first chunk if none exist
   if(!m_rootChunk)
   {
-    NewChunk();
+    if(!NewChunk()) return NULL;
   }
 
-  //Advance ptr, allocate new chunk if necessary
-  if(((gmuptr)m_currentChunk->m_curAddress + m_elementSize) > (gmuptr)m_currentChunk->m_lastAddress)
+  //Advance ptr, allocate new chunk if necessary (compare the space left, the end of a chunk may be close to the gmuptr range)
+  if(m_elementSize > (gmuptr)m_currentChunk->m_lastAddress - (gmuptr)m_currentChunk->m_curAddress)
   {
-    NewChunk();    
+    if(!NewChunk()) return NULL;
   }
   retPtr = m_currentChunk->m_curAddress;
   m_currentChunk->m_curAddress = (void*)((gmuptr)m_currentChunk->m_curAddress + m_elementSize);
@@ -157,16 +279,16 @@ void* gmMemChain::AllocBytes(unsigned int a_numBytes, unsigned int a_alignNumByt
   //Allocate first chunk if none exist
   if(!m_rootChunk)
   {
-    NewChunk();
+    if(!NewChunk()) return NULL;
   }
 
   //Align and record the pointer.
   retPtr = _gmAlignMem(m_currentChunk->m_curAddress, a_alignNumBytes);
 
   //Create new chunk if not enough memory in this one.
-  if(((gmuptr)retPtr + a_numBytes) > (gmuptr)m_currentChunk->m_lastAddress)
+  if((gmuptr)retPtr > (gmuptr)m_currentChunk->m_lastAddress || a_numBytes > (gmuptr)m_currentChunk->m_lastAddress - (gmuptr)retPtr)
   {
-    NewChunk();    
+    if(!NewChunk()) return NULL;
     
     //Align and record the pointer.
     retPtr = _gmAlignMem(m_currentChunk->m_curAddress, a_alignNumBytes);
@@ -188,7 +310,7 @@ void* gmMemChain::Alloc(unsigned int a_numElementsToAlloc)
   //Allocate first chunk if none exist
   if(!m_rootChunk)
   {
-    NewChunk();
+    if(!NewChunk()) return NULL;
   }
 
   //Advance ptr, allocate new chunk if necessary
@@ -196,12 +318,12 @@ void* gmMemChain::Alloc(unsigned int a_numElementsToAlloc)
 
   GM_ASSERT(allocSize <= m_chunkSize); // Chunk size is too small to alloc that many elements at once and should be increased
 
-  if(((unsigned int)m_currentChunk->m_curAddress + allocSize) > (unsigned int)m_currentChunk->m_lastAddress)
+  if(allocSize > (gmuptr)m_currentChunk->m_lastAddress - (gmuptr)m_currentChunk->m_curAddress)
   {
-    NewChunk();    
+    if(!NewChunk()) return NULL;
   }
   retPtr = m_currentChunk->m_curAddress;
-  m_currentChunk->m_curAddress = (void*)((unsigned int)m_currentChunk->m_curAddress + allocSize);
+  m_currentChunk->m_curAddress = (void*)((gmuptr)m_currentChunk->m_curAddress + allocSize);
 
   return retPtr;
 }
@@ -23,13 +23,14 @@ public:
   gmMemChain(unsigned int a_elementSize, unsigned int a_numElementsInChunk);
   virtual ~gmMemChain();
 
-  /// \brief Alloc()
+  /// \brief Alloc(), returns NULL when out of memory (see gmAllocChunk() for 64 bit targets)
   void* Alloc(unsigned int a_numElements);
   void* Alloc();
 
   /// \brief Alloc memory
   /// \param a_numBytes Number of bytes ot allocate.
   /// \param a_alignNumBytes Number of bytes to align to.
+  /// \return The memory, or NULL when out of memory.
   void* AllocBytes(unsigned int a_numBytes, unsigned int a_alignNumBytes = 1);
 
   /// \brief Reset()
@@ -100,6 +100,10 @@ void* gmMemFixed::Alloc()
   {
     //No, so get chain to alloc a new one
     newMemPtr = m_memChain.Alloc();
+    if(!newMemPtr)
+    {
+      return NULL;
+    }
   }
 
 #ifdef GM_DEBUG_BUILD
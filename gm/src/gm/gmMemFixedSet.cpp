@@ -134,3 +134,183 @@ void gmMemFixedSet::FreeBigAllocs()
   m_bigAllocs.RemoveAll();
 }
 
+
+#if GM_GC_BACKGROUND_FREE
+
+#ifdef _WIN32
+#include <windows.h>
+#else // !_WIN32
+#include <pthread.h>
+#endif // !_WIN32
+
+// Returning big blocks to the system heap (which may unmap pages) is the slow part of destructing large
+// tables and functions. While the worker runs, gmMachine::CollectGarbage() holds these blocks back and hands
+// them over in one batch. Objects are still destructed on the owning thread, so user type gc callbacks,
+// the string table and the fixed pools are never touched by the worker.
+
+struct gmMemFixedSet::BackgroundFree
+{
+  BigMemNode* m_pending;                          ///< Chain waiting to be freed
+  bool m_quit;                                    ///< Exit once m_pending is empty
+#ifdef _WIN32
+  CRITICAL_SECTION m_lock;
+  CONDITION_VARIABLE m_wake;
+  HANDLE m_thread;
+
+  void Lock()    { EnterCriticalSection(&m_lock); }
+  void Unlock()  { LeaveCriticalSection(&m_lock); }
+  void Wait()    { SleepConditionVariableCS(&m_wake, &m_lock, INFINITE); }
+  void Wake()    { WakeConditionVariable(&m_wake); }
+
+  static DWORD WINAPI ThreadMain(LPVOID a_worker) { ((BackgroundFree*)a_worker)->Run(); return 0; }
+
+  bool Start()
+  {
+    InitializeCriticalSection(&m_lock);
+    InitializeConditionVariable(&m_wake);
+    m_thread = ::CreateThread(NULL, 0, ThreadMain, this, 0, NULL);
+    if(!m_thread)
+    {
+      DeleteCriticalSection(&m_lock);
+      return false;
+    }
+    return true;
+  }
+
+  void Join()
+  {
+    WaitForSingleObject(m_thread, INFINITE);
+    CloseHandle(m_thread);
+    DeleteCriticalSection(&m_lock);
+  }
+#else // !_WIN32
+  pthread_mutex_t m_lock;
+  pthread_cond_t m_wake;
+  pthread_t m_thread;
+
+  void Lock()    { pthread_mutex_lock(&m_lock); }
+  void Unlock()  { pthread_mutex_unlock(&m_lock); }
+  void Wait()    { pthread_cond_wait(&m_wake, &m_lock); }
+  void Wake()    { pthread_cond_signal(&m_wake); }
+
+  static void* ThreadMain(void* a_worker) { ((BackgroundFree*)a_worker)->Run(); return NULL; }
+
+  bool Start()
+  {
+    pthread_mutex_init(&m_lock, NULL);
+    pthread_cond_init(&m_wake, NULL);
+    if(pthread_create(&m_thread, NULL, ThreadMain, this) != 0)
+    {
+      pthread_cond_destroy(&m_wake);
+      pthread_mutex_destroy(&m_lock);
+      return false;
+    }
+    return true;
+  }
+
+  void Join()
+  {
+    pthread_join(m_thread, NULL);
+    pthread_cond_destroy(&m_wake);
+    pthread_mutex_destroy(&m_lock);
+  }
+#endif // !_WIN32
+
+  void Run()
+  {
+    Lock();
+    for(;;)
+    {
+      while(!m_pending && !m_quit)
+      {
+        Wait();
+      }
+      BigMemNode* chain = m_pending;
+      if(!chain)
+      {
+        break; // m_quit
+      }
+      m_pending = NULL;
+      Unlock();
+      FreeDeferredChain(chain);
+      Lock();
+    }
+    Unlock();
+  }
+
+  void Submit(BigMemNode* a_first, BigMemNode* a_last)
+  {
+    Lock();
+    DeferredNext(a_last) = m_pending;
+    m_pending = a_first;
+    Wake();
+    Unlock();
+  }
+
+  void Stop()
+  {
+    Lock();
+    m_quit = true;
+    Wake();
+    Unlock();
+    Join();
+  }
+};
+
+
+void gmMemFixedSet::FreeDeferredChain(BigMemNode* a_chain)
+{
+  while(a_chain)
+  {
+    BigMemNode* nodeToDelete = a_chain;
+    a_chain = DeferredNext(a_chain);
+
+    delete [] (char*)nodeToDelete;
+  }
+}
+
+
+bool gmMemFixedSet::SetBackgroundFree(bool a_enable)
+{
+  if(a_enable && !m_backgroundFree)
+  {
+    BackgroundFree* worker = GM_NEW( BackgroundFree );
+    worker->m_pending = NULL;
+    worker->m_quit = false;
+    if(!worker->Start())
+    {
+      delete worker;
+      return false;
+    }
+    m_backgroundFree = worker;
+  }
+  else if(!a_enable && m_backgroundFree)
+  {
+    // Blocks still held back are freed here, the worker drains its chain before exiting
+    FreeDeferredChain(m_deferred);
+    m_deferred = NULL;
+    m_deferredLast = NULL;
+    m_deferFree = false;
+
+    m_backgroundFree->Stop();
+    delete m_backgroundFree;
+    m_backgroundFree = NULL;
+  }
+  return true;
+}
+
+
+void gmMemFixedSet::EndDeferredFree()
+{
+  m_deferFree = false;
+  if(m_deferred)
+  {
+    GM_ASSERT(m_backgroundFree);
+    m_backgroundFree->Submit(m_deferred, m_deferredLast);
+    m_deferred = NULL;
+    m_deferredLast = NULL;
+  }
+}
+
+#endif // GM_GC_BACKGROUND_FREE
+
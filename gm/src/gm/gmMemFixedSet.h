@@ -27,6 +27,7 @@ public:
 
   /// \brief Alloc() an element
   /// \param a_size size of allocation
+  /// \return NULL when out of memory
   inline void* Alloc(int a_size);
   
   /// \brief Free() an element
@@ -46,6 +47,22 @@ public:
   /// \brief GetSystemMemUsed will return the number of bytes allocated by the system.
   unsigned int GetSystemMemUsed() const;
 
+#if GM_GC_BACKGROUND_FREE
+  /// \brief SetBackgroundFree() will start or stop the worker thread that returns deferred big allocations to the system.
+  /// \return true if the worker is running as requested.
+  bool SetBackgroundFree(bool a_enable);
+
+  /// \brief GetBackgroundFree() will return true if the worker thread is running.
+  inline bool GetBackgroundFree() const { return m_backgroundFree != NULL; }
+
+  /// \brief BeginDeferredFree() will hold back big allocations (GM_GC_BACKGROUND_FREE_MIN bytes or more) passed to Free()
+  ///        until EndDeferredFree(), if the worker is running.
+  inline void BeginDeferredFree() { m_deferFree = (m_backgroundFree != NULL); }
+
+  /// \brief EndDeferredFree() will hand the held back big allocations to the worker thread.
+  void EndDeferredFree();
+#endif // GM_GC_BACKGROUND_FREE
+
   /// \brief Presize() will presize the memfixed pools
   void Presize(int a_pool8,
                int a_pool16,
@@ -91,6 +108,19 @@ protected:
   gmListDouble<BigMemNode> m_bigAllocs;           ///< List holding memory for more than 512 bytes
   int m_memUsed;
 
+#if GM_GC_BACKGROUND_FREE
+  struct BackgroundFree;
+
+  /// \brief Deferred big allocations are chained through the first word of their (dead) data
+  static inline BigMemNode*& DeferredNext(BigMemNode* a_node) { return *(BigMemNode**)a_node->Data(); }
+  static void FreeDeferredChain(BigMemNode* a_chain);
+
+  BackgroundFree* m_backgroundFree;               ///< Worker thread, NULL if big allocations are freed immediately
+  BigMemNode* m_deferred;                         ///< Big allocations held back since BeginDeferredFree()
+  BigMemNode* m_deferredLast;                     ///< Last node of m_deferred
+  bool m_deferFree;                               ///< Hold back big allocations in Free()?
+#endif // GM_GC_BACKGROUND_FREE
+
 };
 
 
@@ -105,11 +135,20 @@ gmMemFixedSet::gmMemFixedSet()
     m_mem512(512 + sizeof(SmallMemNode), 16)
 {
   m_memUsed = 0;
+#if GM_GC_BACKGROUND_FREE
+  m_backgroundFree = NULL;
+  m_deferred = NULL;
+  m_deferredLast = NULL;
+  m_deferFree = false;
+#endif // GM_GC_BACKGROUND_FREE
 }
 
 
 gmMemFixedSet::~gmMemFixedSet()
 {
+#if GM_GC_BACKGROUND_FREE
+  SetBackgroundFree(false);
+#endif // GM_GC_BACKGROUND_FREE
   FreeBigAllocs();
 }
 
@@ -123,18 +162,21 @@ void* gmMemFixedSet::Alloc(int a_size)
     if (a_size <= 8)
     {
       node = (SmallMemNode*)m_mem8.Alloc();
+      if(!node) return NULL;
       node->m_size = 8;
       m_memUsed += 8;
     }
     else if (a_size <= 16)
     {
       node = (SmallMemNode*)m_mem16.Alloc();
+      if(!node) return NULL;
       node->m_size = 16;
       m_memUsed += 16;
     }
     else if (a_size <= 24)
     {
       node = (SmallMemNode*)m_mem24.Alloc();
+      if(!node) return NULL;
       node->m_size = 24;
       m_memUsed += 24;
     }
@@ -143,6 +185,7 @@ void* gmMemFixedSet::Alloc(int a_size)
       GM_ASSERT(a_size <= 32);
 
       node = (SmallMemNode*)m_mem32.Alloc();
+      if(!node) return NULL;
       node->m_size = 32;
       m_memUsed += 32;
     }
@@ -152,24 +195,28 @@ void* gmMemFixedSet::Alloc(int a_size)
     if (a_size <= 64)
     {
       node = (SmallMemNode*)m_mem64.Alloc();
+      if(!node) return NULL;
       node->m_size = 64;
       m_memUsed += 64;
     }
     else if (a_size <= 128)
     {
       node = (SmallMemNode*)m_mem128.Alloc();
+      if(!node) return NULL;
       node->m_size = 128;
       m_memUsed += 128;
     }
     else if (a_size <= 256)
     {
       node = (SmallMemNode*)m_mem256.Alloc();
+      if(!node) return NULL;
       node->m_size = 256;
       m_memUsed += 256;
     }
     else if (a_size <= 512)
     {
       node = (SmallMemNode*)m_mem512.Alloc();
+      if(!node) return NULL;
       node->m_size = 512;
       m_memUsed += 512;
     }    
@@ -181,6 +228,7 @@ void* gmMemFixedSet::Alloc(int a_size)
 
       m_bigAllocs.InsertFirst(bigNode);
       bigNode->m_size = a_size;
+      GetSmallNodeData(bigNode->Data())->m_size = a_size; // Free() reads the size from here, BigMemNode may be padded on 64 bit targets
       m_memUsed += a_size;
 
       return bigNode->Data();
@@ -248,7 +296,21 @@ void gmMemFixedSet::Free(void* a_ptr)
       BigMemNode* bigNode = GetBigNodeData(a_ptr);
       m_memUsed -= bigNode->m_size;
       m_bigAllocs.Remove(bigNode);
-      delete [] (char*) bigNode;
+#if GM_GC_BACKGROUND_FREE
+      if(m_deferFree && bigNode->m_size >= GM_GC_BACKGROUND_FREE_MIN)
+      {
+        DeferredNext(bigNode) = m_deferred;
+        if(!m_deferred)
+        {
+          m_deferredLast = bigNode;
+        }
+        m_deferred = bigNode;
+      }
+      else
+#endif // GM_GC_BACKGROUND_FREE
+      {
+        delete [] (char*) bigNode;
+      }
     }
   }
     
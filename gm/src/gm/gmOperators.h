@@ -76,4 +76,8 @@ typedef void (GM_CDECL *gmOperatorFunction)(gmThread * a_thread, gmVariable * a_
 
 void gmInitBasicType(gmType a_type, gmOperatorFunction * a_operators);
 
+// default GM_TABLE dot operators, the vm replaces these with inline cached table access
+void GM_CDECL gmTableGetDot(gmThread * a_thread, gmVariable * a_operands);
+void GM_CDECL gmTableSetDot(gmThread * a_thread, gmVariable * a_operands);
+
 #endif // _GMOPERATORS_H_
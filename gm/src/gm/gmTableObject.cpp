@@ -14,16 +14,167 @@
 #include "gmMachine.h"
 #include "gmThread.h"
 
+#if GM_TABLE_OPEN_ADDRESSING
+
+#if defined(GM_SSE2)
+#include <emmintrin.h>
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Control bytes of the open addressing layout. A used node keeps the low 7 bits of its key hash, free nodes have the
+// top bit set. Tables smaller than a group pad their control bytes with sentinels, which never match.
+enum
+{
+  GM_TABLE_CTRL_EMPTY = 0x80,
+  GM_TABLE_CTRL_DELETED = 0xfe,
+  GM_TABLE_CTRL_SENTINEL = 0xff,
+};
+
+
+static inline int gmTableLowestBit(gmuint32 a_bits)
+{
+#if defined(__GNUC__)
+  return __builtin_ctz(a_bits);
+#elif defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, a_bits);
+  return (int) index;
+#else
+  int index = 0;
+  while(!(a_bits & 1)) { a_bits >>= 1; ++index; }
+  return index;
+#endif
+}
+
+
+#if defined(GM_SSE2)
+
+/// \class gmTableGroup
+/// \brief Matches the control bytes of 16 nodes at once, one mask bit per node.
+class gmTableGroup
+{
+public:
+  enum { WIDTH = 16 };
+
+  inline gmTableGroup(const gmuint8 * a_ctrl) { m_ctrl = _mm_loadu_si128((const __m128i *) a_ctrl); }
+
+  inline gmuint32 Match(gmuint32 a_hash) const { return (gmuint32) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char) a_hash), m_ctrl)); }
+  inline gmuint32 MatchEmpty() const { return Match(GM_TABLE_CTRL_EMPTY); }
+  // empty and deleted are the only control bytes below the sentinel as signed chars
+  inline gmuint32 MatchFree() const { return (gmuint32) _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8((char) GM_TABLE_CTRL_SENTINEL), m_ctrl)); }
+  static inline int Index(gmuint32 a_match) { return gmTableLowestBit(a_match); }
+
+private:
+  __m128i m_ctrl;
+};
+
+#else // GM_SSE2
+
+/// \class gmTableGroup
+/// \brief Matches the control bytes of 4 nodes at once within a 32 bit word, the top bit of each byte is its mask bit.
+///        Match() may report a used node next to a real match, callers compare keys anyway.
+class gmTableGroup
+{
+public:
+  enum { WIDTH = 4 };
+
+  inline gmTableGroup(const gmuint8 * a_ctrl) { memcpy(&m_ctrl, a_ctrl, sizeof(m_ctrl)); }
+
+  inline gmuint32 Match(gmuint32 a_hash) const
+  {
+    gmuint32 x = m_ctrl ^ (LSBS * a_hash);
+    return (x - LSBS) & ~x & MSBS;
+  }
+  inline gmuint32 MatchEmpty() const { return m_ctrl & (~m_ctrl << 6) & MSBS; }
+  inline gmuint32 MatchFree() const { return m_ctrl & (~m_ctrl << 7) & MSBS; }
+  static inline int Index(gmuint32 a_match) { return gmTableLowestBit(a_match) >> 3; }
+
+private:
+  enum { LSBS = 0x01010101, MSBS = 0x80808080 };
+  gmuint32 m_ctrl;
+};
+
+#endif // GM_SSE2
+
+
+/// \brief GroupMask() returns the number of groups in a table of a_size nodes minus one.
+static inline gmuint32 GroupMask(int a_size)
+{
+  return (a_size > gmTableGroup::WIDTH) ? (gmuint32) (a_size / gmTableGroup::WIDTH) - 1 : 0;
+}
+
+#endif //GM_TABLE_OPEN_ADDRESSING
+
 
 gmTableObject::gmTableObject()
 {
   m_nodes = NULL;
+#if GM_TABLE_OPEN_ADDRESSING
+  m_ctrl = NULL;
+  m_growthLeft = 0;
+#else //GM_TABLE_OPEN_ADDRESSING
   m_firstFree = NULL;
+#endif //GM_TABLE_OPEN_ADDRESSING
   m_tableSize = 0;
   m_slotsUsed = 0;
 }
 
 
+#if GM_TABLE_OPEN_ADDRESSING
+
+inline int gmTableObject::FindIndex(const gmVariable* a_key, gmuint32 a_hash) const
+{
+  gmuint32 groupMask = GroupMask(m_tableSize);
+  gmuint32 group = (a_hash >> 7) & groupMask;
+  gmuint32 step = 0;
+
+  // probe groups quadratically, a group with an empty node ends the search
+  for(;;)
+  {
+    gmTableGroup ctrl(m_ctrl + group * gmTableGroup::WIDTH);
+    gmuint32 match;
+    for(match = ctrl.Match(a_hash & 0x7f); match; match &= match - 1)
+    {
+      int index = group * gmTableGroup::WIDTH + gmTableGroup::Index(match);
+      const gmTableNode * node = &m_nodes[index];
+      if(a_key->m_value.m_ref == node->m_key.m_value.m_ref && a_key->m_type == node->m_key.m_type)
+      {
+        return index;
+      }
+    }
+    if(ctrl.MatchEmpty())
+    {
+      return -1;
+    }
+    group = (group + ++step) & groupMask;
+    GM_ASSERT(step <= groupMask);
+  }
+}
+
+
+
+inline int gmTableObject::FindFreeIndex(gmuint32 a_hash) const
+{
+  gmuint32 groupMask = GroupMask(m_tableSize);
+  gmuint32 group = (a_hash >> 7) & groupMask;
+  gmuint32 step = 0;
+
+  for(;;)
+  {
+    gmuint32 match = gmTableGroup(m_ctrl + group * gmTableGroup::WIDTH).MatchFree();
+    if(match)
+    {
+      return group * gmTableGroup::WIDTH + gmTableGroup::Index(match);
+    }
+    group = (group + ++step) & groupMask;
+    GM_ASSERT(step <= groupMask);
+  }
+}
+
+#endif //GM_TABLE_OPEN_ADDRESSING
+
+
 #if GM_USE_INCGC
 
 
@@ -92,7 +243,12 @@ void gmTableObject::Destruct(gmMachine * a_machine)
     m_nodes = NULL;
   }
 
+#if GM_TABLE_OPEN_ADDRESSING
+  m_ctrl = NULL;
+  m_growthLeft = 0;
+#else //GM_TABLE_OPEN_ADDRESSING
   m_firstFree = NULL;
+#endif //GM_TABLE_OPEN_ADDRESSING
   m_tableSize = 0;
   m_slotsUsed = 0;
 
@@ -105,6 +261,16 @@ void gmTableObject::Destruct(gmMachine * a_machine)
 
 gmVariable gmTableObject::Get(const gmVariable &a_key) const
 {
+#if GM_TABLE_OPEN_ADDRESSING
+  if(m_nodes && a_key.m_type != GM_NULL)
+  {
+    int index = FindIndex(&a_key, HashKey(&a_key));
+    if(index >= 0)
+    {
+      return m_nodes[index].m_value;
+    }
+  }
+#else //GM_TABLE_OPEN_ADDRESSING
   gmTableNode* foundNode = NULL;
 
   if(m_nodes && a_key.m_type != GM_NULL)
@@ -121,11 +287,45 @@ gmVariable gmTableObject::Get(const gmVariable &a_key) const
       foundNode = foundNode->m_nextInHashTable;
     } while (foundNode);
   }  
+#endif //GM_TABLE_OPEN_ADDRESSING
 
   return gmVariable::s_null;
 }
 
 
+gmVariable gmTableObject::GetAndCache(const gmVariable &a_key, int &a_cacheIndex) const
+{
+#if GM_TABLE_OPEN_ADDRESSING
+  if(m_nodes && a_key.m_type != GM_NULL)
+  {
+    int index = FindIndex(&a_key, HashKey(&a_key));
+    if(index >= 0)
+    {
+      a_cacheIndex = index;
+      return m_nodes[index].m_value;
+    }
+  }
+#else //GM_TABLE_OPEN_ADDRESSING
+  gmTableNode* foundNode = NULL;
+  if(m_nodes && a_key.m_type != GM_NULL)
+  {
+    foundNode = GetAtHashPos(&a_key);
+    do
+    {
+      if(a_key.m_value.m_ref == foundNode->m_key.m_value.m_ref &&
+         a_key.m_type == foundNode->m_key.m_type)
+      {
+        a_cacheIndex = (int) (foundNode - m_nodes);
+        return foundNode->m_value;
+      }
+      foundNode = foundNode->m_nextInHashTable;
+    } while (foundNode);
+  }  
+#endif //GM_TABLE_OPEN_ADDRESSING
+  return gmVariable::s_null;
+}
+
+
 gmVariable gmTableObject::Get(gmMachine * a_machine, const char * a_key) const
 {
   return Get(gmVariable(GM_STRING, a_machine->AllocStringObject(a_key)->GetRef()));
@@ -138,6 +338,75 @@ void gmTableObject::Set(gmMachine * a_machine, const gmVariable &a_key, const gm
 void gmTableObject::Set(gmMachine * a_machine, const gmVariable &a_key, const gmVariable &a_value)
 #endif //GM_USE_INCGC
 {
+#if GM_TABLE_OPEN_ADDRESSING
+  if(!m_tableSize)
+  {
+    Construct(a_machine);
+  }
+
+  if(a_key.m_type == GM_NULL)
+  {
+    return;
+  }
+
+  gmuint32 hash = HashKey(&a_key);
+  int index = FindIndex(&a_key, hash);
+
+  // find key, if it exists
+  if(index >= 0)
+  {
+    gmTableNode * foundNode = &m_nodes[index];
+
+    //If found and value is null, remove it
+    if(GM_NULL == a_value.m_type)
+    {
+#if GM_USE_INCGC
+      if( !a_disableWriteBarrier )
+      {
+        // Both key and value are going, write barrier them both
+        if(foundNode->m_key.IsReference())
+        {
+          a_machine->GetGC()->WriteBarrier((gmObject*)foundNode->m_key.m_value.m_ref);
+        }
+        if(foundNode->m_value.IsReference())
+        {
+          a_machine->GetGC()->WriteBarrier((gmObject*)foundNode->m_value.m_value.m_ref);
+        }
+      }
+#endif //GM_USE_INCGC
+      RemoveAt(index);
+      return;
+    }
+#if GM_USE_INCGC
+    if( !a_disableWriteBarrier )
+    {
+      // Value is going, write barrier value only
+      if(foundNode->m_value.IsReference())
+      {
+        a_machine->GetGC()->WriteBarrier((gmObject*)foundNode->m_value.m_value.m_ref);
+      }
+    }
+#endif //GM_USE_INCGC
+    foundNode->m_value = a_value;
+    return;
+  }
+
+  //If not found, but value is null, don't add it
+  if(GM_NULL == a_value.m_type)
+  {
+    return;
+  }
+
+  // key was not found, insert it, reusing a deleted node does not use up an empty one
+  index = FindFreeIndex(hash);
+  if(m_growthLeft == 0 && m_ctrl[index] == GM_TABLE_CTRL_EMPTY)
+  {
+    Resize(a_machine);
+    index = FindFreeIndex(hash);
+  }
+  InsertAt(index, hash, a_key, a_value);
+
+#else //GM_TABLE_OPEN_ADDRESSING
   GM_ASSERT(m_firstFree >= &m_nodes[0] && m_firstFree <= &m_nodes[m_tableSize-1]);
 
   if(!m_tableSize)
@@ -275,6 +544,7 @@ void gmTableObject::Set(gmMachine * a_machine, const gmVariable &a_key, const gm
   }
 
   Resize(a_machine);
+#endif //GM_TABLE_OPEN_ADDRESSING
 }
 
 
@@ -289,6 +559,35 @@ void gmTableObject::Set(gmMachine * a_machine, const char * a_key, const gmVaria
 
 
 
+void gmTableObject::SetCached(gmMachine * a_machine, const gmVariable &a_key, const gmVariable &a_value, int &a_cacheIndex)
+{
+  if(a_value.m_type != GM_NULL && (unsigned int) a_cacheIndex < (unsigned int) m_tableSize)
+  {
+    gmTableNode * node = &m_nodes[a_cacheIndex];
+    if(node->m_key.m_value.m_ref == a_key.m_value.m_ref && node->m_key.m_type == a_key.m_type)
+    {
+#if GM_USE_INCGC
+      // Value is going, write barrier value only
+      if(node->m_value.IsReference())
+      {
+        a_machine->GetGC()->WriteBarrier((gmObject*)node->m_value.m_value.m_ref);
+      }
+#endif //GM_USE_INCGC
+      node->m_value = a_value;
+      return;
+    }
+  }
+
+  Set(a_machine, a_key, a_value);
+
+  // Remember where the key landed for the next set
+  if(a_value.m_type != GM_NULL)
+  {
+    GetAndCache(a_key, a_cacheIndex);
+  }
+}
+
+
 gmTableObject * gmTableObject::Duplicate(gmMachine * a_machine)
 {
   gmTableObject * object = a_machine->AllocTableObject();
@@ -312,6 +611,38 @@ gmTableObject * gmTableObject::Duplicate(gmMachine * a_machine)
 
 
 
+void gmTableObject::Reserve(gmMachine * a_machine, int a_count)
+{
+  if(m_slotsUsed)
+  {
+    return;
+  }
+
+  int size = MIN_TABLE_SIZE;
+#if GM_TABLE_OPEN_ADDRESSING
+  while(size - ((size + 7) / 8) < a_count) // see AllocSize()
+#else //GM_TABLE_OPEN_ADDRESSING
+  while(size <= a_count) // the table resizes once its last node is taken
+#endif //GM_TABLE_OPEN_ADDRESSING
+  {
+    size <<= 1;
+  }
+
+  if(size == m_tableSize)
+  {
+    return;
+  }
+  if(m_nodes)
+  {
+    a_machine->Sys_Free(m_nodes);
+    m_nodes = NULL;
+    m_tableSize = 0;
+  }
+  AllocSize(a_machine, size);
+}
+
+
+
 void gmTableObject::Construct(gmMachine * a_machine)
 {
   AllocSize(a_machine, MIN_TABLE_SIZE);
@@ -345,6 +676,99 @@ gmTableNode* gmTableObject::GetNext(gmTableIterator& a_it) const
 
 
 
+#if GM_TABLE_OPEN_ADDRESSING
+
+void gmTableObject::InsertAt(int a_index, gmuint32 a_hash, const gmVariable &a_key, const gmVariable &a_value)
+{
+  if(m_ctrl[a_index] == GM_TABLE_CTRL_EMPTY)
+  {
+    --m_growthLeft;
+  }
+  m_ctrl[a_index] = (gmuint8) (a_hash & 0x7f);
+  m_nodes[a_index].m_key = a_key;
+  m_nodes[a_index].m_value = a_value;
+  ++m_slotsUsed;
+}
+
+
+
+void gmTableObject::RemoveAt(int a_index)
+{
+  // A probe only passes a group that had no empty node. If the group still has one, no probe passes it and the
+  // node can become empty again, otherwise it is marked deleted so probes carry on past it.
+  int group = a_index & ~(gmTableGroup::WIDTH - 1);
+  if(gmTableGroup(m_ctrl + group).MatchEmpty())
+  {
+    m_ctrl[a_index] = GM_TABLE_CTRL_EMPTY;
+    ++m_growthLeft;
+  }
+  else
+  {
+    m_ctrl[a_index] = GM_TABLE_CTRL_DELETED;
+  }
+  m_nodes[a_index].m_key.m_type = GM_NULL;
+  --m_slotsUsed;
+}
+
+
+
+void gmTableObject::Resize(gmMachine * a_machine)
+{
+  int newSize = m_tableSize;
+
+  if(m_slotsUsed >= m_tableSize / 2)
+  {
+    newSize = m_tableSize * 2;
+  }
+  else if((m_slotsUsed <= ( m_tableSize / 4 )) && (m_tableSize > MIN_TABLE_SIZE))
+  {
+    newSize = m_tableSize / 2;
+  }
+  // else keep the size, rehashing drops the deleted nodes
+
+  gmTableNode* oldNodes = m_nodes;
+  gmuint8* oldCtrl = m_ctrl;
+  int oldTableSize = m_tableSize;
+
+  AllocSize(a_machine, newSize);
+
+  int index;
+  for(index = 0; index < oldTableSize; ++index)
+  {
+    if(!(oldCtrl[index] & GM_TABLE_CTRL_EMPTY))
+    {
+      gmuint32 hash = HashKey(&oldNodes[index].m_key);
+      InsertAt(FindFreeIndex(hash), hash, oldNodes[index].m_key, oldNodes[index].m_value);
+    }
+  }
+
+  a_machine->Sys_Free(oldNodes);
+}
+
+
+
+void gmTableObject::AllocSize(gmMachine * a_machine, int a_size)
+{
+  GM_ASSERT((a_size & (a_size-1)) == 0 ); //Check for power of 2 size
+
+  // control bytes follow the nodes, padded to at least one group
+  int ctrlSize = (a_size < gmTableGroup::WIDTH) ? gmTableGroup::WIDTH : a_size;
+  int memSize = sizeof(m_nodes[0]) * a_size + ctrlSize;
+  //WARNING: Sys_Alloc may call Mark and access this class before returning a new pointer!
+  gmTableNode * nodes = (gmTableNode*)a_machine->Sys_Alloc(memSize);
+  m_nodes = nodes;
+  m_ctrl = (gmuint8 *) (nodes + a_size);
+  m_tableSize = a_size;
+  m_slotsUsed = 0;
+  m_growthLeft = a_size - ((a_size + 7) / 8); // keep an eighth of the nodes empty so every probe ends
+
+  memset(m_nodes, 0, sizeof(m_nodes[0]) * a_size);
+  memset(m_ctrl, GM_TABLE_CTRL_EMPTY, a_size);
+  memset(m_ctrl + a_size, GM_TABLE_CTRL_SENTINEL, ctrlSize - a_size);
+}
+
+#else //GM_TABLE_OPEN_ADDRESSING
+
 void gmTableObject::Resize(gmMachine * a_machine)
 {
   int newSize = m_tableSize;
@@ -409,6 +833,8 @@ void gmTableObject::AllocSize(gmMachine * a_machine, int a_size)
   m_firstFree = &m_nodes[m_tableSize-1];
 }
 
+#endif //GM_TABLE_OPEN_ADDRESSING
+
 
 
 gmVariable gmTableObject::GetLinearSearch(const char * a_key) const
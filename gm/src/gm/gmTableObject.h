@@ -23,7 +23,9 @@ typedef int gmTableIterator; ///< Table iterator, is actually the array index, o
 /// \brief Values stored in the table are wrapped in these nodes.
 struct gmTableNode
 {
+#if !GM_TABLE_OPEN_ADDRESSING
   gmTableNode* m_nextInHashTable;                 ///< The next node in the hash table
+#endif //!GM_TABLE_OPEN_ADDRESSING
 
   gmVariable m_key;                               ///< The key used to find a value.
   gmVariable m_value;                             ///< The value associated with the key
@@ -61,12 +63,31 @@ public:
   // Get by c string (uses linear search)
   gmVariable GetLinearSearch(const char * a_key) const;
 
+  /// \brief GetCached() will get by variable, first trying the node at index a_cacheIndex. On a miss, a_cacheIndex is
+  ///        updated to where the key was found. A hit is validated against the node key, so a resize or node move simply
+  ///        misses, and tables with the same layout (same keys inserted in the same order) hit the same index.
+  inline gmVariable GetCached(const gmVariable &a_key, int &a_cacheIndex) const
+  {
+    if((unsigned int) a_cacheIndex < (unsigned int) m_tableSize)
+    {
+      const gmTableNode * node = &m_nodes[a_cacheIndex];
+      if(node->m_key.m_value.m_ref == a_key.m_value.m_ref && node->m_key.m_type == a_key.m_type)
+      {
+        return node->m_value;
+      }
+    }
+    return GetAndCache(a_key, a_cacheIndex);
+  }
+
 #if GM_USE_INCGC  
   void Set(gmMachine * a_machine, const gmVariable &a_key, const gmVariable &a_value, bool a_disableWriteBarrier = false);  
 #else //GM_USE_INCGC
   void Set(gmMachine * a_machine, const gmVariable &a_key, const gmVariable &a_value);
 #endif //GM_USE_INCGC
   void Set(gmMachine * a_machine, const char * a_key, const gmVariable &a_value);
+
+  /// \brief SetCached() will set by variable, overwriting the node at a_cacheIndex if it holds the key. See GetCached().
+  void SetCached(gmMachine * a_machine, const gmVariable &a_key, const gmVariable &a_value, int &a_cacheIndex);
   inline void Set(gmMachine * a_machine, int a_index, const gmVariable &a_value)
   {
     Set(a_machine, gmVariable(GM_INT, (gmptr)a_index), a_value);
@@ -75,6 +96,10 @@ public:
   inline int Count() const { return m_slotsUsed; }
   gmTableObject * Duplicate(gmMachine * a_machine);
 
+  /// \brief Reserve() sizes an empty table so that a_count entries can be set without it resizing. Does nothing to a
+  ///        table that already holds entries.
+  void Reserve(gmMachine * a_machine, int a_count);
+
 
   //
   // iterator
@@ -114,8 +139,32 @@ private:
   };
 
   void Construct(gmMachine * a_machine);
+  gmVariable GetAndCache(const gmVariable &a_key, int &a_cacheIndex) const;
  
   void RemoveAndDeleteAll(gmMachine * a_machine);
+
+#if GM_TABLE_OPEN_ADDRESSING
+
+  /// \brief HashKey() mixes all bits of the key, so pointer and small int keys spread over the whole table.
+  ///        The low 7 bits are stored in the control byte of the slot, the rest picks the first group to probe.
+  static inline gmuint32 HashKey(const gmVariable* a_key)
+  {
+    gmuint32 hash = (gmuint32) a_key->m_value.m_ref ^ ((gmuint32) a_key->m_type * 0x9e3779b9);
+    hash ^= hash >> 16;
+    hash *= 0x7feb352d;
+    hash ^= hash >> 15;
+    hash *= 0x846ca68b;
+    hash ^= hash >> 16;
+    return hash;
+  }
+
+  int FindIndex(const gmVariable* a_key, gmuint32 a_hash) const;
+  int FindFreeIndex(gmuint32 a_hash) const;
+  void InsertAt(int a_index, gmuint32 a_hash, const gmVariable &a_key, const gmVariable &a_value);
+  void RemoveAt(int a_index);
+
+#else //GM_TABLE_OPEN_ADDRESSING
+
   inline gmTableNode * GetAtHashPos(const gmVariable* a_key) const
   {
     unsigned int hash = a_key->m_value.m_ref;
@@ -130,12 +179,18 @@ private:
     return &m_nodes[hash];
   }
 
+#endif //GM_TABLE_OPEN_ADDRESSING
 
   void Resize(gmMachine * a_machine);
   void AllocSize(gmMachine * a_machine, int a_size);
 
   gmTableNode * m_nodes;
+#if GM_TABLE_OPEN_ADDRESSING
+  gmuint8 * m_ctrl;                               ///< A control byte per node (empty, deleted or 7 bits of the key hash), follows m_nodes in the same allocation
+  int m_growthLeft;                               ///< Empty nodes that may still be filled before the table must grow
+#else //GM_TABLE_OPEN_ADDRESSING
   gmTableNode * m_firstFree;
+#endif //GM_TABLE_OPEN_ADDRESSING
   int m_tableSize;
   int m_slotsUsed;
 };
@@ -27,6 +27,29 @@
 #define GMTHREAD_LOG m_machine->GetLog().LogEntry
 #define PUSHNULL top->m_type = GM_NULL; top->m_value.m_int = 0; ++top;
 
+// dispatch macros. with threaded dispatch each instruction jumps directly to the next handler rather than back
+// through the switch. the user break callback needs the loop head, so it forces switch dispatch.
+
+#if GM_USE_COMPUTED_GOTO && defined(__GNUC__) && !defined(GM_CHECK_USER_BREAK_CALLBACK)
+#define GM_THREADED_DISPATCH 1
+#else
+#define GM_THREADED_DISPATCH 0
+#endif
+
+#if GM_BYTECODE_PROFILE
+#define GM_PROFILE_INSTRUCTION gmByteCodeProfileCount(instruction);
+#else // !GM_BYTECODE_PROFILE
+#define GM_PROFILE_INSTRUCTION
+#endif // !GM_BYTECODE_PROFILE
+
+#if GM_THREADED_DISPATCH
+#define GM_CASE(BC) case BC : L_##BC
+#define GM_NEXT { GM_PROFILE_INSTRUCTION GM_ASSERT(*instruction32 < BC_MAX); goto *s_dispatch[*(instruction32++)]; }
+#else // !GM_THREADED_DISPATCH
+#define GM_CASE(BC) case BC
+#define GM_NEXT break
+#endif // !GM_THREADED_DISPATCH
+
 // helper functions
 void gmGetLineFromString(const char * a_string, int a_line, char * a_buffer, int a_len)
 {
@@ -63,6 +86,7 @@ gmThread::gmThread(gmMachine * a_machine, int a_initialByteSize)
   m_top = 0;
   m_base = 0;
   m_numParameters = 0;
+  m_reusable = false;
 #if GMDEBUG_SUPPORT
   m_debugUser = 0;
   m_debugFlags = 0;
@@ -181,6 +205,28 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
   gmVariable * base;
   gmVariable * operand;
   const gmuint8 * code;
+  gmOperator binaryOp;
+
+#if GM_THREADED_DISPATCH
+
+  // handler for each byte code, in gmByteCode enum order
+  static const void * s_dispatch[] = 
+  {
+    &&L_BC_GETDOT, &&L_BC_SETDOT, &&L_BC_GETIND, &&L_BC_SETIND,
+    &&L_BC_OP_ADD, &&L_BC_OP_SUB, &&L_BC_OP_MUL, &&L_BC_OP_DIV, &&L_BC_OP_REM,
+    &&L_BC_BIT_OR, &&L_BC_BIT_XOR, &&L_BC_BIT_AND, &&L_BC_BIT_SHL, &&L_BC_BIT_SHR, &&L_BC_BIT_INV,
+    &&L_BC_OP_LT, &&L_BC_OP_GT, &&L_BC_OP_LTE, &&L_BC_OP_GTE, &&L_BC_OP_EQ, &&L_BC_OP_NEQ,
+    &&L_BC_OP_NEG, &&L_BC_OP_POS, &&L_BC_OP_NOT,
+    &&L_BC_NOP, &&L_BC_LINE,
+    &&L_BC_BRA, &&L_BC_BRZ, &&L_BC_BRNZ, &&L_BC_BRZK, &&L_BC_BRNZK, &&L_BC_CALL, &&L_BC_RET, &&L_BC_RETV, &&L_BC_FOREACH,
+    &&L_BC_POP, &&L_BC_POP2, &&L_BC_DUP, &&L_BC_DUP2, &&L_BC_SWAP, &&L_BC_PUSHNULL, &&L_BC_PUSHINT, &&L_BC_PUSHINT0,
+    &&L_BC_PUSHINT1, &&L_BC_PUSHFP, &&L_BC_PUSHSTR, &&L_BC_PUSHTBL, &&L_BC_PUSHFN, &&L_BC_PUSHTHIS,
+    &&L_BC_GETLOCAL, &&L_BC_SETLOCAL, &&L_BC_GETGLOBAL, &&L_BC_SETGLOBAL, &&L_BC_GETTHIS, &&L_BC_SETTHIS,
+    &&L_BC_OP_ADDI, &&L_BC_OP_SUBI, &&L_BC_OP_LTI, &&L_BC_DUPGETDOT,
+  };
+  typedef char gmDispatchTableCheck[(sizeof(s_dispatch) / sizeof(s_dispatch[0]) == BC_MAX) ? 1 : -1];
+
+#endif // GM_THREADED_DISPATCH
 
   if(m_state != RUNNING) return m_state;
 
@@ -222,16 +268,17 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
     }
 #endif //GM_CHECK_USER_BREAK_CALLBACK 
 
+    GM_PROFILE_INSTRUCTION
     switch(*(instruction32++))
     {
       //
       // unary operator
       //
 
-      case BC_BIT_INV :
-      case BC_OP_NEG :
-      case BC_OP_POS :
-      case BC_OP_NOT :
+      GM_CASE(BC_BIT_INV) :
+      GM_CASE(BC_OP_NEG) :
+      GM_CASE(BC_OP_POS) :
+      GM_CASE(BC_OP_NOT) :
       {
         operand = top - 1; 
         gmOperatorFunction op = OPERATOR(operand->m_type, (gmOperator) instruction32[-1]); 
@@ -248,7 +295,7 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
           State res = PushStackFrame(1, &instruction, &code); 
           top = GetTop();
           base = GetBase();
-          if(res == RUNNING) break;
+          if(res == RUNNING) GM_NEXT;
           if(res == SYS_YIELD) return RUNNING;
           if(res == SYS_EXCEPTION) goto LabelException;
           if(res == KILLED) { m_machine->Sys_SwitchState(this, KILLED); GM_ASSERT(0); } // operator should not kill a thread
@@ -259,41 +306,45 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
           GMTHREAD_LOG("unary operator %s undefined for type %s", gmGetOperatorName((gmOperator) instruction32[-1]), m_machine->GetTypeName(operand->m_type)); 
           goto LabelException; 
         } 
-        break;
+        GM_NEXT;
       }
 
       //
       // operator
       //
 
-      case BC_OP_ADD :
-      case BC_OP_SUB :
-      case BC_OP_MUL :
-      case BC_OP_DIV :
-      case BC_OP_REM :
-      case BC_BIT_OR :
-      case BC_BIT_XOR :
-      case BC_BIT_AND :
-      case BC_BIT_SHL :
-      case BC_BIT_SHR :
-      case BC_OP_LT :
-      case BC_OP_GT :
-      case BC_OP_LTE :
-      case BC_OP_GTE :
-      case BC_OP_EQ :
-      case BC_OP_NEQ :
-      case BC_GETIND :
+      GM_CASE(BC_OP_ADD) :
+      GM_CASE(BC_OP_SUB) :
+      GM_CASE(BC_OP_MUL) :
+      GM_CASE(BC_OP_DIV) :
+      GM_CASE(BC_OP_REM) :
+      GM_CASE(BC_BIT_OR) :
+      GM_CASE(BC_BIT_XOR) :
+      GM_CASE(BC_BIT_AND) :
+      GM_CASE(BC_BIT_SHL) :
+      GM_CASE(BC_BIT_SHR) :
+      GM_CASE(BC_OP_LT) :
+      GM_CASE(BC_OP_GT) :
+      GM_CASE(BC_OP_LTE) :
+      GM_CASE(BC_OP_GTE) :
+      GM_CASE(BC_OP_EQ) :
+      GM_CASE(BC_OP_NEQ) :
+      GM_CASE(BC_GETIND) :
       {
+        binaryOp = (gmOperator) instruction32[-1];
+
+LabelBinaryOperator:
+
         operand = top - 2; 
         --top; 
         register gmType t1 = operand[1].m_type; 
         if(operand->m_type > t1) t1 = operand->m_type; 
-        gmOperatorFunction op = OPERATOR(t1, (gmOperator) instruction32[-1]); 
+        gmOperatorFunction op = OPERATOR(t1, binaryOp); 
         if(op) 
         { 
           op(this, operand); 
         } 
-        else if((fn = CALLOPERATOR(t1, (gmOperator) instruction32[-1]))) 
+        else if((fn = CALLOPERATOR(t1, binaryOp))) 
         { 
           operand[2] = operand[0]; 
           operand[3] = operand[1]; 
@@ -303,7 +354,7 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
           State res = PushStackFrame(2, &instruction, &code); 
           top = GetTop(); 
           base = GetBase();
-          if(res == RUNNING) break;
+          if(res == RUNNING) GM_NEXT;
           if(res == SYS_YIELD) return RUNNING;
           if(res == SYS_EXCEPTION) goto LabelException;
           if(res == KILLED) { m_machine->Sys_SwitchState(this, KILLED); GM_ASSERT(0); } // operator should not kill a thread
@@ -311,13 +362,13 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         } 
         else 
         { 
-          GMTHREAD_LOG("operator %s undefined for type %s and %s", gmGetOperatorName((gmOperator) instruction32[-1]), m_machine->GetTypeName(operand->m_type), m_machine->GetTypeName((operand + 1)->m_type)); 
+          GMTHREAD_LOG("operator %s undefined for type %s and %s", gmGetOperatorName(binaryOp), m_machine->GetTypeName(operand->m_type), m_machine->GetTypeName((operand + 1)->m_type)); 
           goto LabelException; 
         } 
 
-        break;
+        GM_NEXT;
       }
-      case BC_SETIND : 
+      GM_CASE(BC_SETIND) : 
       { 
         operand = top - 3; 
         top -= 3; 
@@ -337,7 +388,7 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
           State res = PushStackFrame(3, &instruction, &code); 
           top = GetTop(); 
           base = GetBase(); 
-          if(res == RUNNING) break; 
+          if(res == RUNNING) GM_NEXT; 
           if(res == SYS_YIELD) return RUNNING; 
           if(res == SYS_EXCEPTION) goto LabelException; 
           if(res == KILLED) { m_machine->Sys_SwitchState(this, KILLED); GM_ASSERT(0); } // operator should not kill a thread 
@@ -348,13 +399,13 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
           GMTHREAD_LOG("setind failed."); 
           goto LabelException; 
         } 
-        break; 
+        GM_NEXT; 
       } 
-      case BC_NOP :
+      GM_CASE(BC_NOP) :
       {
-        break;
+        GM_NEXT;
       }
-      case BC_LINE :
+      GM_CASE(BC_LINE) :
       {
 
 #if GMDEBUG_SUPPORT
@@ -368,9 +419,15 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
 
 #endif // GMDEBUG_SUPPORT
 
-        break;
+        GM_NEXT;
       }
-      case BC_GETDOT :
+      GM_CASE(BC_DUPGETDOT) :
+      {
+        top[0] = top[-1];
+        ++top;
+        // fall through to get dot
+      }
+      GM_CASE(BC_GETDOT) :
       {
         operand = top - 1;
         gmptr member = OPCODE_PTR(instruction);
@@ -378,20 +435,33 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         top->m_value.m_ref = member;
         gmType t1 = operand->m_type;
         gmOperatorFunction op = OPERATOR(t1, O_GETDOT);
+#if GMMACHINE_MEMBERCACHESIZE
+        int &cacheIndex = m_machine->GetMemberCacheSlot(instruction);
+        if(op == gmTableGetDot)
+        {
+          *operand = ((gmTableObject *) GM_MOBJECT(m_machine, operand->m_value.m_ref))->GetCached(*top, cacheIndex);
+          if(operand->m_type) GM_NEXT;
+        }
+        else
+#endif // GMMACHINE_MEMBERCACHESIZE
         if(op)
         {
           op(this, operand);
-          if(operand->m_type) break;
+          if(operand->m_type) GM_NEXT;
         }
         if(t1 == GM_NULL)
         {
           GMTHREAD_LOG("getdot failed.");
           goto LabelException;
         }
+#if GMMACHINE_MEMBERCACHESIZE
+        *operand = m_machine->GetTypeVariableCached(t1, gmVariable(GM_STRING, member), cacheIndex);
+#else // !GMMACHINE_MEMBERCACHESIZE
         *operand = m_machine->GetTypeVariable(t1, gmVariable(GM_STRING, member));
-        break;
+#endif // !GMMACHINE_MEMBERCACHESIZE
+        GM_NEXT;
       }
-      case BC_SETDOT :
+      GM_CASE(BC_SETDOT) :
       {
         operand = top - 2;
         gmptr member = OPCODE_PTR(instruction);
@@ -399,6 +469,14 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         top->m_value.m_ref = member;
         top -= 2;
         gmOperatorFunction op = OPERATOR(operand->m_type, O_SETDOT);
+#if GMMACHINE_MEMBERCACHESIZE
+        if(op == gmTableSetDot)
+        {
+          gmTableObject * table = (gmTableObject *) GM_MOBJECT(m_machine, operand->m_value.m_ref);
+          table->SetCached(m_machine, operand[2], operand[1], m_machine->GetMemberCacheSlot(instruction));
+        }
+        else
+#endif // GMMACHINE_MEMBERCACHESIZE
         if(op)
         {
           op(this, operand);
@@ -408,14 +486,14 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
           GMTHREAD_LOG("setdot failed.");
           goto LabelException;
         }
-        break;
+        GM_NEXT;
       }
-      case BC_BRA :
+      GM_CASE(BC_BRA) :
       {
         instruction = code + OPCODE_PTR_NI(instruction);
-        break;
+        GM_NEXT;
       }
-      case BC_BRZ :
+      GM_CASE(BC_BRZ) :
       {
 #if GM_BOOL_OP
         operand = top - 1;
@@ -440,7 +518,7 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
             State res = PushStackFrame(1, &instruction, &code);
             top = GetTop();
             base = GetBase();
-            if(res == RUNNING) break;
+            if(res == RUNNING) GM_NEXT;
             if(res == SYS_YIELD) return RUNNING;
             if(res == SYS_EXCEPTION) goto LabelException;
             if(res == KILLED) { m_machine->Sys_SwitchState(this, KILLED); GM_ASSERT(0); } // operator should not kill a thread
@@ -461,9 +539,9 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         }
         else instruction += sizeof(gmptr);
 #endif // !GM_BOOL_OP
-        break;
+        GM_NEXT;
       }
-      case BC_BRNZ :
+      GM_CASE(BC_BRNZ) :
       {
 #if GM_BOOL_OP
         operand = top - 1;
@@ -488,7 +566,7 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
             State res = PushStackFrame(1, &instruction, &code);
             top = GetTop();
             base = GetBase();
-            if(res == RUNNING) break;
+            if(res == RUNNING) GM_NEXT;
             if(res == SYS_YIELD) return RUNNING;
             if(res == SYS_EXCEPTION) goto LabelException;
             if(res == KILLED) { m_machine->Sys_SwitchState(this, KILLED); GM_ASSERT(0); } // operator should not kill a thread
@@ -509,9 +587,9 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         }
         else instruction += sizeof(gmptr);
 #endif // !GM_BOOL_OP
-        break;
+        GM_NEXT;
       }
-      case BC_BRZK :
+      GM_CASE(BC_BRZK) :
       {
 #if GM_BOOL_OP
         operand = top - 1;
@@ -535,7 +613,7 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
             State res = PushStackFrame(1, &instruction, &code);
             top = GetTop();
             base = GetBase();
-            if(res == RUNNING) break;
+            if(res == RUNNING) GM_NEXT;
             if(res == SYS_YIELD) return RUNNING;
             if(res == SYS_EXCEPTION) goto LabelException;
             if(res == KILLED) { m_machine->Sys_SwitchState(this, KILLED); GM_ASSERT(0); } // operator should not kill a thread
@@ -555,9 +633,9 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         }
         else instruction += sizeof(gmptr);
 #endif // !GM_BOOL_OP
-        break;
+        GM_NEXT;
       }
-      case BC_BRNZK :
+      GM_CASE(BC_BRNZK) :
       {
 #if GM_BOOL_OP
         operand = top - 1;
@@ -581,7 +659,7 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
             State res = PushStackFrame(1, &instruction, &code);
             top = GetTop();
             base = GetBase();
-            if(res == RUNNING) break;
+            if(res == RUNNING) GM_NEXT;
             if(res == SYS_YIELD) return RUNNING;
             if(res == SYS_EXCEPTION) goto LabelException;
             if(res == KILLED) { m_machine->Sys_SwitchState(this, KILLED); GM_ASSERT(0); } // operator should not kill a thread
@@ -601,9 +679,9 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         }
         else instruction += sizeof(gmptr);
 #endif // !GM_BOOL_OP
-        break;
+        GM_NEXT;
       }
-      case BC_CALL :
+      GM_CASE(BC_CALL) :
       {
         SetTop(top);
         
@@ -626,7 +704,7 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
 
 #endif // GMDEBUG_SUPPORT
 
-          break;
+          GM_NEXT;
         }
         if(res == SYS_YIELD) return RUNNING;
         if(res == SYS_EXCEPTION) goto LabelException;
@@ -637,11 +715,11 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         }
         return res;
       }
-      case BC_RET :
+      GM_CASE(BC_RET) :
       {
         PUSHNULL;
       }
-      case BC_RETV :
+      GM_CASE(BC_RETV) :
       {
         SetTop(top);
         int res = Sys_PopStackFrame(instruction, code);
@@ -661,18 +739,29 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
 
 #endif // GMDEBUG_SUPPORT
 
-          break;
+          GM_NEXT;
         }
         if(res == KILLED)
         {
           if(a_return) *a_return = *(top - 1);
+          if(m_reusable)
+          {
+            // unwind the base frame like a native call, leaving the return variable for the caller
+            m_stack[0] = *(top - 1);
+            m_top = 1;
+            m_base = 0;
+            m_machine->Sys_FreeStackFrame(m_frame);
+            m_frame = NULL;
+            m_instruction = NULL;
+            return SYS_RETURN;
+          }
           m_machine->Sys_SwitchState(this, KILLED);
           return KILLED;
         }
         if(res == SYS_EXCEPTION) goto LabelException;
-        break;
+        GM_NEXT;
       }
-      case BC_FOREACH :
+      GM_CASE(BC_FOREACH) :
       {
         gmuint32 localvalue = OPCODE_PTR(instruction);
         gmuint32 localkey = localvalue >> 16;
@@ -700,126 +789,126 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
           top->m_type = GM_INT; top->m_value.m_int = 0;
         }
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_POP :
+      GM_CASE(BC_POP) :
       {
         --top;
-        break;
+        GM_NEXT;
       }
-      case BC_POP2 :
+      GM_CASE(BC_POP2) :
       {
         top -= 2;
-        break;
+        GM_NEXT;
       }
-      case BC_DUP :
+      GM_CASE(BC_DUP) :
       {
         top[0] = top[-1]; 
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_DUP2 :
+      GM_CASE(BC_DUP2) :
       {
         top[0] = top[-2];
         top[1] = top[-1];
         top += 2;
-        break;
+        GM_NEXT;
       }
-      case BC_SWAP :
+      GM_CASE(BC_SWAP) :
       {
         top[0] = top[-1];
         top[-1] = top[-2];
         top[-2] = top[0];
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHNULL :
+      GM_CASE(BC_PUSHNULL) :
       {
         PUSHNULL;
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHINT :
+      GM_CASE(BC_PUSHINT) :
       {
         top->m_type = GM_INT;
         top->m_value.m_int = OPCODE_PTR(instruction);
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHINT0 :
+      GM_CASE(BC_PUSHINT0) :
       {
         top->m_type = GM_INT;
         top->m_value.m_int = 0;
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHINT1 :
+      GM_CASE(BC_PUSHINT1) :
       {
         top->m_type = GM_INT;
         top->m_value.m_int = 1;
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHFP :
+      GM_CASE(BC_PUSHFP) :
       {
         top->m_type = GM_FLOAT;
         top->m_value.m_float = OPCODE_FLOAT(instruction);
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHSTR :
+      GM_CASE(BC_PUSHSTR) :
       {
         top->m_type = GM_STRING;
         top->m_value.m_ref = OPCODE_PTR(instruction);
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHTBL :
+      GM_CASE(BC_PUSHTBL) :
       {
         SetTop(top);
         top->m_type = GM_TABLE;
         top->m_value.m_ref = m_machine->AllocTableObject()->GetRef();
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHFN :
+      GM_CASE(BC_PUSHFN) :
       {
         top->m_type = GM_FUNCTION;
         top->m_value.m_ref = OPCODE_PTR(instruction);
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_PUSHTHIS :
+      GM_CASE(BC_PUSHTHIS) :
       {
         *top = *GetThis();
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_GETLOCAL :
+      GM_CASE(BC_GETLOCAL) :
       {
         gmuint32 offset = OPCODE_PTR(instruction);
         *(top++) = base[offset];
-        break;
+        GM_NEXT;
       }
-      case BC_SETLOCAL :
+      GM_CASE(BC_SETLOCAL) :
       {
         gmuint32 offset = OPCODE_PTR(instruction);
         base[offset] = *(--top);
-        break;
+        GM_NEXT;
       }
-      case BC_GETGLOBAL :
+      GM_CASE(BC_GETGLOBAL) :
       {
         top->m_type = GM_STRING;
         top->m_value.m_ref = OPCODE_PTR(instruction);
         *top = m_machine->GetGlobals()->Get(*top); ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_SETGLOBAL :
+      GM_CASE(BC_SETGLOBAL) :
       {
         top->m_type = GM_STRING;
         top->m_value.m_ref = OPCODE_PTR(instruction);
         m_machine->GetGlobals()->Set(m_machine, *top, *(top-1)); --top;
-        break;
+        GM_NEXT;
       }
-      case BC_GETTHIS :
+      GM_CASE(BC_GETTHIS) :
       {
         gmptr member = OPCODE_PTR(instruction);
         const gmVariable * thisVar = GetThis();
@@ -827,21 +916,34 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         top[1].m_type = GM_STRING;
         top[1].m_value.m_ref = member;
         gmOperatorFunction op = OPERATOR(thisVar->m_type, O_GETDOT);
+#if GMMACHINE_MEMBERCACHESIZE
+        int &cacheIndex = m_machine->GetMemberCacheSlot(instruction);
+        if(op == gmTableGetDot)
+        {
+          *top = ((gmTableObject *) GM_MOBJECT(m_machine, thisVar->m_value.m_ref))->GetCached(top[1], cacheIndex);
+          if(top->m_type) { ++top; GM_NEXT; }
+        }
+        else
+#endif // GMMACHINE_MEMBERCACHESIZE
         if(op)
         {
           op(this, top);
-          if(top->m_type) { ++top; break; }
+          if(top->m_type) { ++top; GM_NEXT; }
         }
         if(thisVar->m_type == GM_NULL)
         {
           GMTHREAD_LOG("getthis failed. this is null");
           goto LabelException;
         }
+#if GMMACHINE_MEMBERCACHESIZE
+        *top = m_machine->GetTypeVariableCached(thisVar->m_type, top[1], cacheIndex);
+#else // !GMMACHINE_MEMBERCACHESIZE
         *top = m_machine->GetTypeVariable(thisVar->m_type, top[1]);
+#endif // !GMMACHINE_MEMBERCACHESIZE
         ++top;
-        break;
+        GM_NEXT;
       }
-      case BC_SETTHIS :
+      GM_CASE(BC_SETTHIS) :
       {
         gmptr member = OPCODE_PTR(instruction);
         const gmVariable * thisVar = GetThis();
@@ -852,6 +954,14 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
         top[1].m_value.m_ref = member;
         --top;
         gmOperatorFunction op = OPERATOR(thisVar->m_type, O_SETDOT);
+#if GMMACHINE_MEMBERCACHESIZE
+        if(op == gmTableSetDot)
+        {
+          gmTableObject * table = (gmTableObject *) GM_MOBJECT(m_machine, operand->m_value.m_ref);
+          table->SetCached(m_machine, operand[2], operand[1], m_machine->GetMemberCacheSlot(instruction));
+        }
+        else
+#endif // GMMACHINE_MEMBERCACHESIZE
         if(op)
         {
           op(this, operand);
@@ -861,7 +971,51 @@ gmThread::State gmThread::Sys_Execute(gmVariable * a_return)
           GMTHREAD_LOG("setthis failed.");
           goto LabelException;
         }
-        break;
+        GM_NEXT;
+      }
+
+      //
+      // int constant operators, fallback to the full operator with the constant pushed
+      //
+
+      GM_CASE(BC_OP_ADDI) :
+      {
+        operand = top - 1;
+        int value = (int) OPCODE_PTR(instruction);
+        if(operand->m_type == GM_INT)
+        {
+          operand->m_value.m_int += value;
+          GM_NEXT;
+        }
+        top->m_type = GM_INT; top->m_value.m_int = value; ++top;
+        binaryOp = O_ADD;
+        goto LabelBinaryOperator;
+      }
+      GM_CASE(BC_OP_SUBI) :
+      {
+        operand = top - 1;
+        int value = (int) OPCODE_PTR(instruction);
+        if(operand->m_type == GM_INT)
+        {
+          operand->m_value.m_int -= value;
+          GM_NEXT;
+        }
+        top->m_type = GM_INT; top->m_value.m_int = value; ++top;
+        binaryOp = O_SUB;
+        goto LabelBinaryOperator;
+      }
+      GM_CASE(BC_OP_LTI) :
+      {
+        operand = top - 1;
+        int value = (int) OPCODE_PTR(instruction);
+        if(operand->m_type == GM_INT)
+        {
+          operand->m_value.m_int = (operand->m_value.m_int < value);
+          GM_NEXT;
+        }
+        top->m_type = GM_INT; top->m_value.m_int = value; ++top;
+        binaryOp = O_LT;
+        goto LabelBinaryOperator;
       }
       default :
       {
@@ -923,6 +1077,7 @@ void gmThread::Sys_Reset(int a_id)
   m_startTime = 0;
   m_id = a_id;
   m_numParameters = 0;
+  m_reusable = false;
   m_user = 0;
 }
 
@@ -1020,7 +1175,7 @@ gmThread::State gmThread::PushStackFrame(int a_numParameters, const gmuint8 ** a
 
     if(!m_frame) // C called C function, no stack frame, so signal killed.
     {
-      return KILLED;
+      return m_reusable ? SYS_RETURN : KILLED;
     }
 
     // return result
@@ -61,6 +61,7 @@ public:
     SYS_PENDING,
     SYS_YIELD, 
     SYS_EXCEPTION,
+    SYS_RETURN, //!< a reusable thread returned from its base function, see Sys_SetReusable()
   };
 
   inline const int GetKey() const { return m_id; }
@@ -74,7 +75,7 @@ public:
 
   /// \brief Sys_Execute() will perform execution on this thread.  a this, function references, params and stack
   ///        frame must be pushed before a call to execute will succeed.
-  /// \param a_return will be set to the return variable iff Sys_Execute returns gmThread::KILLED. 
+  /// \param a_return will be set to the return variable iff Sys_Execute returns gmThread::KILLED or SYS_RETURN. 
   /// \return the new thread state.
   State Sys_Execute(gmVariable * a_return = NULL);
 
@@ -84,6 +85,13 @@ public:
   /// \brief Sys_SetState() will set the thread state.
   inline void Sys_SetState(State a_state) { m_state = a_state; }
 
+  /// \brief Sys_SetReusable() lets a native caller run several calls on this thread.  When the base function
+  ///        returns, the thread is left alive with the return variable on top of an otherwise empty stack, and
+  ///        Sys_Execute (or PushStackFrame for a native function) returns SYS_RETURN instead of KILLED.  The
+  ///        caller must pop the return variable before pushing the next call, and clear the flag if the thread
+  ///        yields, blocks or sleeps so the machine can finish and kill it as usual.
+  inline void Sys_SetReusable(bool a_reusable) { m_reusable = a_reusable; }
+
   /// \brief PushStackFrame will push a stack frame and adjust the instruction and code pointers. 
   ///        If the function to be called is a c bound function, the call will occur within PushStackFrame.
   ///        Before PushStackFrame is called, this, fp, and params must be pushed on the stack.
@@ -248,6 +256,7 @@ private:
   gmSignal * m_signals; // list of potentially active signals on this thread.
   gmBlock * m_blocks; // list of active blocks when thread is in BLOCKED state.
   short m_numParameters;
+  bool m_reusable; // return from base function leaves thread alive, see Sys_SetReusable()
 };
 
 
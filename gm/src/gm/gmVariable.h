@@ -141,6 +141,8 @@ struct gmVariable
 
 };
 
+// gmVariable is 8 bytes on all targets, see GM_64BIT_PTR in gmConfig_p.h
+typedef char gmVariableSizeCheck[(sizeof(gmVariable) == 8) ? 1 : -1];
 
 
 /// \class gmObject
@@ -144,6 +144,11 @@ static void PrintByteCode(FILE * a_fp, const void * a_byteCode, int a_byteCodeLe
       case BC_OP_EQ : cp = "eq"; break;
       case BC_OP_NEQ : cp = "neq"; break;
 
+      case BC_OP_ADDI : cp = "add int"; opiptr = true; break;
+      case BC_OP_SUBI : cp = "sub int"; opiptr = true; break;
+      case BC_OP_LTI : cp = "lt int"; opiptr = true; break;
+      case BC_DUPGETDOT : cp = "dup get dot"; opiptr = true; break;
+
       default : cp = "ERROR"; break;
     }
 
@@ -26,6 +26,10 @@
 #define GM_LITTLE_ENDIAN      1
 #define GM_COMPILER_GCC
 #define GM_X86
+#if defined(__SSE2__)
+#define GM_SSE2                           // SSE2 intrinsics are available (emmintrin.h)
+#endif
+#define GM_THREADS                        // worker threads are available (CreateThread on Windows, pthreads elsewhere)
 
 #define GM_CDECL              
 #ifdef _DEBUG
@@ -49,6 +53,15 @@
 
 #define GM_DEFAULT_ALLOC_ALIGNMENT 4
 
+// gmptr stays 32 bit on 64 bit targets, keeping gmVariable at 8 bytes (type + 32 bit value) and matching the 32 bit
+// operands in byte code. gm objects are then allocated below 2GB so their references fit, and so the sign extension
+// when a reference is cast back to a pointer leaves it unchanged (see gmMemChain.cpp). This caps the gm object heap
+// at the free address space below 2GB, shared with whatever else the process maps there. Past that the machine's
+// Alloc*Object() functions return NULL.
+#if defined(_WIN64) || defined(__LP64__)
+#define GM_64BIT_PTR
+#endif
+
 #define GM_MAKE_ID32( a, b, c, d )  ( ((d)<<24) | ((c)<<16) | ((b)<<8) | (a))
 
 #define GM_MIN_FLOAT32        -3.402823466e38f
@@ -92,7 +105,7 @@ typedef unsigned short gmuint16;
 typedef int gmint32;
 typedef unsigned int gmuint32;
 typedef float gmfloat;
-typedef int gmptr; // machine pointer size as int
+typedef int gmptr; // machine pointer size as int, 32 bit references on 64 bit targets (see GM_64BIT_PTR)
 typedef unsigned int gmuptr; // machine pointer size as int
 
 
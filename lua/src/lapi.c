@@ -20,6 +20,7 @@
 #include "ldo.h"
 #include "lfunc.h"
 #include "lgc.h"
+#include "ljit.h"
 #include "lmem.h"
 #include "lobject.h"
 #include "lstate.h"
@@ -920,6 +921,11 @@ LUA_API int lua_gc (lua_State *L, int what, int data) {
     }
     case LUA_GCSTEP: {
       lu_mem a = (cast(lu_mem, data) << 10);
+      if (isgenerational(g)) {  /* a step is a whole minor collection */
+        luaC_step(L);
+        res = 1;
+        break;
+      }
       if (a <= g->totalbytes)
         g->GCthreshold = g->totalbytes - a;
       else
@@ -940,6 +946,30 @@ LUA_API int lua_gc (lua_State *L, int what, int data) {
       g->gcstepmul = data;
       break;
     }
+    case LUA_GCGEN: {
+      luaC_changemode(L, KGC_GEN);
+      break;
+    }
+    case LUA_GCINC: {
+      luaC_changemode(L, KGC_NORMAL);
+      break;
+    }
+    case LUA_GCSETMINORMUL: {
+      res = g->gcminormul;
+      g->gcminormul = data;
+      break;
+    }
+    case LUA_GCSETMAJORMUL: {
+      res = g->gcmajormul;
+      g->gcmajormul = data;
+      break;
+    }
+    case LUA_GCSTRREHASH: {
+      /* strings moved by string table resizes since the last query */
+      res = cast_int(g->strt.rehashwork);
+      g->strt.rehashwork = 0;
+      break;
+    }
     default: res = -1;  /* invalid option */
   }
   lua_unlock(L);
@@ -947,6 +977,24 @@ LUA_API int lua_gc (lua_State *L, int what, int data) {
 }
 
 
+/*
+** JIT function
+*/
+
+LUA_API int lua_jit (lua_State *L, int what, int data) {
+#if defined(LUA_USE_JIT)
+  int res;
+  lua_lock(L);
+  res = luaJ_control(L, what, data);
+  lua_unlock(L);
+  return res;
+#else
+  UNUSED(L); UNUSED(what); UNUSED(data);
+  return -1;  /* JIT not available */
+#endif
+}
+
+
 
 /*
 ** miscellaneous functions
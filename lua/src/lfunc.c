@@ -134,6 +134,10 @@ Proto *luaF_newproto (lua_State *L) {
   f->linedefined = 0;
   f->lastlinedefined = 0;
   f->source = NULL;
+#if defined(LUA_USE_JIT)
+  f->jitcode = NULL;
+  f->jitcalls = 0;
+#endif
   return f;
 }
 
@@ -29,7 +29,7 @@
 #define GCFINALIZECOST	100
 
 
-#define maskmarks	cast_byte(~(bitmask(BLACKBIT)|WHITEBITS))
+#define maskmarks	cast_byte(~(bitmask(BLACKBIT)|WHITEBITS|bitmask(OLDBIT)))
 
 #define makewhite(g,x)	\
    ((x)->gch.marked = cast_byte(((x)->gch.marked & maskmarks) | luaC_white(g)))
@@ -58,6 +58,9 @@
 
 #define setthreshold(g)  (g->GCthreshold = (g->estimate/100) * g->gcpause)
 
+#define setminorthreshold(g)  (g->GCthreshold = g->totalbytes + \
+                                (g->lastmajormem/100) * g->gcminormul)
+
 
 static void removeentry (Node *n) {
   lua_assert(ttisnil(gval(n)));
@@ -131,7 +134,9 @@ size_t luaC_separateudata (lua_State *L, int all) {
   GCObject **p = &g->mainthread->next;
   GCObject *curr;
   while ((curr = *p) != NULL) {
-    if (!(iswhite(curr) || all) || isfinalized(gco2u(curr)))
+    if (isgenerational(g) && isold(curr) && !all)
+      break;  /* old udata are never white */
+    else if (!(iswhite(curr) || all) || isfinalized(gco2u(curr)))
       p = &curr->gch.next;  /* don't bother with them */
     else if (fasttm(L, gco2u(curr)->metatable, TM_GC) == NULL) {
       markfinalized(gco2u(curr));  /* don't need finalization */
@@ -404,16 +409,27 @@ static void freeobj (lua_State *L, GCObject *o) {
 #define sweepwholelist(L,p)	sweeplist(L,p,MAX_LUMEM)
 
 
+/*
+** In generational mode new objects are always linked in front of old
+** ones, so a sweep stops (returning NULL) at the first old object and
+** survivors keep their marks, becoming old themselves
+*/
 static GCObject **sweeplist (lua_State *L, GCObject **p, lu_mem count) {
   GCObject *curr;
   global_State *g = G(L);
   int deadmask = otherwhite(g);
+  int generational = isgenerational(g);
   while ((curr = *p) != NULL && count-- > 0) {
+    if (generational && isold(curr))
+      return NULL;  /* do not sweep old generation */
     if (curr->gch.tt == LUA_TTHREAD)  /* sweep open upvalues of each thread */
       sweepwholelist(L, &gco2th(curr)->openupval);
     if ((curr->gch.marked ^ WHITEBITS) & deadmask) {  /* not dead? */
       lua_assert(!isdead(g, curr) || testbit(curr->gch.marked, FIXEDBIT));
-      makewhite(g, curr);  /* make it white (for next cycle) */
+      if (generational)
+        l_setbit(curr->gch.marked, OLDBIT);  /* it survived; keep its mark */
+      else
+        makewhite(g, curr);  /* make it white (for next cycle) */
       p = &curr->gch.next;
     }
     else {  /* must erase `curr' */
@@ -432,7 +448,7 @@ static void checkSizes (lua_State *L) {
   global_State *g = G(L);
   /* check size of string hash */
   if (g->strt.nuse < cast(lu_int32, g->strt.size/4) &&
-      g->strt.size > MINSTRTABSIZE*2)
+      g->strt.size > MINSTRTABSIZE*2 && g->strt.oldhash == NULL)
     luaS_resize(L, g->strt.size/2);  /* table is too big */
   /* check size of buffer */
   if (luaZ_sizebuffer(&g->buff) > LUA_MINBUFFER*2) {  /* buffer too big? */
@@ -484,9 +500,13 @@ void luaC_freeall (lua_State *L) {
   global_State *g = G(L);
   int i;
   g->currentwhite = WHITEBITS | bitmask(SFIXEDBIT);  /* mask to collect all elements */
+  g->gckind = KGC_NORMAL;  /* sweep old objects too */
   sweepwholelist(L, &g->rootgc);
   for (i = 0; i < g->strt.size; i++)  /* free all string lists */
-    sweepwholelist(L, &g->strt.hash[i]);
+    if (luaS_chainready(&g->strt, i))
+      sweepwholelist(L, &g->strt.hash[i]);
+  for (i = 0; i < g->strt.oldsize; i++)  /* including those not moved yet */
+    sweepwholelist(L, &g->strt.oldhash[i]);
 }
 
 
@@ -558,7 +578,10 @@ static l_mem singlestep (lua_State *L) {
   /*lua_checkmemory(L);*/
   switch (g->gcstate) {
     case GCSpause: {
-      markroot(L);  /* start a new collection */
+      if (isgenerational(g))  /* old objects and gray lists are kept */
+        g->gcstate = GCSpropagate;
+      else
+        markroot(L);  /* start a new collection */
       return 0;
     }
     case GCSpropagate: {
@@ -571,9 +594,22 @@ static l_mem singlestep (lua_State *L) {
     }
     case GCSsweepstring: {
       lu_mem old = g->totalbytes;
-      sweepwholelist(L, &g->strt.hash[g->sweepstrgc++]);
-      if (g->sweepstrgc >= g->strt.size)  /* nothing more to sweep? */
-        g->gcstate = GCSsweep;  /* end sweep-string phase */
+      if (isgenerational(g) && g->strt.nyoung >= 0) {
+        int i;  /* sweep only the chains that received young strings */
+        for (i = 0; i < g->strt.nyoung; i++)
+          sweepwholelist(L, luaS_chain(&g->strt, g->strt.young[i]));
+        g->strt.nyoung = 0;
+        g->gcstate = GCSsweep;
+      }
+      else {
+        int i = g->sweepstrgc++;  /* chains of a table being resized follow */
+        if (i >= g->strt.size || luaS_chainready(&g->strt, i))
+          sweepwholelist(L, luaS_chain(&g->strt, i));
+        if (g->sweepstrgc >= g->strt.size + g->strt.oldsize) {  /* done? */
+          g->gcstate = GCSsweep;  /* end sweep-string phase */
+          g->strt.nyoung = 0;  /* no chain holds young strings now */
+        }
+      }
       lua_assert(old >= g->totalbytes);
       g->estimate -= old - g->totalbytes;
       return GCSWEEPCOST;
@@ -581,7 +617,9 @@ static l_mem singlestep (lua_State *L) {
     case GCSsweep: {
       lu_mem old = g->totalbytes;
       g->sweepgc = sweeplist(L, g->sweepgc, GCSWEEPMAX);
-      if (*g->sweepgc == NULL) {  /* nothing more to sweep? */
+      if (g->sweepgc == NULL)  /* reached old generation? */
+        sweepwholelist(L, &g->mainthread->next);  /* sweep young udata */
+      if (g->sweepgc == NULL || *g->sweepgc == NULL) {  /* nothing more? */
         checkSizes(L);
         g->gcstate = GCSfinalize;  /* end sweep phase */
       }
@@ -607,9 +645,38 @@ static l_mem singlestep (lua_State *L) {
 }
 
 
+/*
+** A minor collection traverses only the objects reachable from the
+** gray lists (threads, weak tables and old objects touched by a barrier)
+** and sweeps only the young objects; when the heap has grown too much
+** since the last major collection the next cycle is a full one
+*/
+static void generationalcollection (lua_State *L) {
+  global_State *g = G(L);
+  if (g->lastmajormem == 0)  /* signal for a major collection? */
+    luaC_fullgc(L);
+  else {
+    lu_mem limit = (g->lastmajormem/100) * (100 + g->gcmajormul);
+    lua_assert(g->gcstate == GCSpause);
+    do {  /* run a complete minor cycle */
+      singlestep(L);
+    } while (g->gcstate != GCSpause);
+    setminorthreshold(g);
+    if (g->totalbytes > limit)
+      g->lastmajormem = 0;  /* signal for a major collection */
+  }
+  g->gcdept = 0;
+}
+
+
 void luaC_step (lua_State *L) {
   global_State *g = G(L);
   l_mem lim = (GCSTEPSIZE/100) * g->gcstepmul;
+  luaS_rehashstep(L, STRREHASHSTEP);  /* keep a pending resize moving */
+  if (isgenerational(g)) {
+    generationalcollection(L);
+    return;
+  }
   if (lim == 0)
     lim = (MAX_LUMEM-1)/2;  /* no limit */
   g->gcdept += g->totalbytes - g->GCthreshold;
@@ -635,6 +702,8 @@ void luaC_step (lua_State *L) {
 
 void luaC_fullgc (lua_State *L) {
   global_State *g = G(L);
+  int kind = g->gckind;
+  g->gckind = KGC_NORMAL;  /* first sweep must turn all objects white */
   if (g->gcstate <= GCSpropagate) {
     /* reset sweep marks to sweep all elements (returning them to white) */
     g->sweepstrgc = 0;
@@ -651,21 +720,29 @@ void luaC_fullgc (lua_State *L) {
     lua_assert(g->gcstate == GCSsweepstring || g->gcstate == GCSsweep);
     singlestep(L);
   }
+  g->gckind = cast_byte(kind);
+  g->strt.nyoung = -1;  /* every string is young again */
   markroot(L);
   while (g->gcstate != GCSpause) {
     singlestep(L);
   }
-  setthreshold(g);
+  if (isgenerational(g)) {  /* every live object is old now */
+    g->lastmajormem = g->totalbytes;
+    setminorthreshold(g);
+  }
+  else
+    setthreshold(g);
 }
 
 
 void luaC_barrierf (lua_State *L, GCObject *o, GCObject *v) {
   global_State *g = G(L);
   lua_assert(isblack(o) && iswhite(v) && !isdead(g, v) && !isdead(g, o));
-  lua_assert(g->gcstate != GCSfinalize && g->gcstate != GCSpause);
+  lua_assert(isgenerational(g) ||
+             (g->gcstate != GCSfinalize && g->gcstate != GCSpause));
   lua_assert(ttype(&o->gch) != LUA_TTABLE);
-  /* must keep invariant? */
-  if (g->gcstate == GCSpropagate)
+  /* must keep invariant? (old objects are not traversed again) */
+  if (g->gcstate == GCSpropagate || isgenerational(g))
     reallymarkobject(g, v);  /* restore invariant */
   else  /* don't mind */
     makewhite(g, o);  /* mark as white just to avoid other barriers */
@@ -676,7 +753,8 @@ void luaC_barrierback (lua_State *L, Table *t) {
   global_State *g = G(L);
   GCObject *o = obj2gco(t);
   lua_assert(isblack(o) && !isdead(g, o));
-  lua_assert(g->gcstate != GCSfinalize && g->gcstate != GCSpause);
+  lua_assert(isgenerational(g) ||
+             (g->gcstate != GCSfinalize && g->gcstate != GCSpause));
   black2gray(o);  /* make table gray (again) */
   t->gclist = g->grayagain;
   g->grayagain = o;
@@ -697,8 +775,9 @@ void luaC_linkupval (lua_State *L, UpVal *uv) {
   GCObject *o = obj2gco(uv);
   o->gch.next = g->rootgc;  /* link upvalue into `rootgc' list */
   g->rootgc = o;
+  resetbit(o->gch.marked, OLDBIT);  /* in front of `rootgc' it must be young */
   if (isgray(o)) { 
-    if (g->gcstate == GCSpropagate) {
+    if (g->gcstate == GCSpropagate || isgenerational(g)) {
       gray2black(o);  /* closed upvalues need barrier */
       luaC_barrier(L, uv, uv->v);
     }
@@ -709,3 +788,28 @@ void luaC_linkupval (lua_State *L, UpVal *uv) {
   }
 }
 
+
+void luaC_changemode (lua_State *L, int mode) {
+  global_State *g = G(L);
+  if (mode == g->gckind) return;  /* nothing to change */
+  if (mode == KGC_GEN) {
+    g->gckind = KGC_GEN;
+    luaC_fullgc(L);  /* a major collection makes all live objects old */
+  }
+  else {
+    /* sweep all objects to turn them back to white (as the white has
+       not changed, nothing extra will be collected) */
+    g->gckind = KGC_NORMAL;
+    g->gray = NULL;
+    g->grayagain = NULL;
+    g->weak = NULL;
+    g->sweepstrgc = 0;
+    g->sweepgc = &g->rootgc;
+    g->gcstate = GCSsweepstring;
+    g->estimate = g->totalbytes;
+    while (g->gcstate != GCSfinalize)
+      singlestep(L);
+    setthreshold(g);
+  }
+}
+
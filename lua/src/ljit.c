@@ -0,0 +1,1381 @@
+/*
+** $Id: ljit.c $
+** Baseline JIT compiler for Lua functions
+** See Copyright Notice in lua.h
+*/
+
+/*
+** The compiler translates the bytecode of a hot function into x86-64
+** machine code, one opcode at a time. Moves, numeric arithmetic and
+** comparisons, numeric for loops and array-part table accesses are
+** expanded inline; every other case calls a helper that does exactly
+** what luaV_execute does for that opcode. Compiled code always leaves
+** through the interpreter: it stores the address of the next instruction
+** to run in L->savedpc and returns, and luaV_execute goes on from there.
+** That happens at OP_RETURN and OP_TAILCALL, and at the top of loops and
+** after calls when a line or count hook has been set.
+*/
+
+
+#include <stddef.h>
+#include <string.h>
+
+#define ljit_c
+#define LUA_CORE
+
+#include "lua.h"
+
+#if defined(LUA_USE_JIT)
+
+#include <sys/mman.h>
+
+#include "ldebug.h"
+#include "ldo.h"
+#include "lfunc.h"
+#include "lgc.h"
+#include "ljit.h"
+#include "lopcodes.h"
+#include "lstate.h"
+#include "lstring.h"
+#include "ltable.h"
+#include "ltm.h"
+#include "lvm.h"
+
+
+#if !defined(LUA_NUMBER_DOUBLE)
+#error "the JIT compiler needs lua_Number to be a double"
+#endif
+
+#if !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS	MAP_ANON
+#endif
+
+
+typedef void (*JitFunction) (lua_State *L, LClosure *cl);
+typedef void (*JitHelper) (void);
+
+
+
+/*
+** {======================================================
+** Helpers called from compiled code
+** =======================================================
+*/
+
+/*
+** Every helper receives the address of the instruction that follows the
+** one it runs, which is what the interpreter keeps in `savedpc' while it
+** runs that instruction.
+*/
+#define RA(i)	(base+GETARG_A(i))
+#define RB(i)	(base+GETARG_B(i))
+#define RKB(i)	(ISK(GETARG_B(i)) ? k+INDEXK(GETARG_B(i)) : base+GETARG_B(i))
+#define RKC(i)	(ISK(GETARG_C(i)) ? k+INDEXK(GETARG_C(i)) : base+GETARG_C(i))
+#define KBx(i)	(k+GETARG_Bx(i))
+
+
+static void jit_getglobal (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  LClosure *cl = &curr_func(L)->l;
+  TValue *k = cl->p->k;
+  StkId base = L->base;
+  TValue g;
+  sethvalue(L, &g, cl->env);
+  L->savedpc = pc;
+  luaV_gettable(L, &g, KBx(i), RA(i));
+}
+
+
+static void jit_gettable (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  TValue *k = curr_func(L)->l.p->k;
+  StkId base = L->base;
+  L->savedpc = pc;
+  luaV_gettable(L, RB(i), RKC(i), RA(i));
+}
+
+
+static void jit_setglobal (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  LClosure *cl = &curr_func(L)->l;
+  TValue *k = cl->p->k;
+  StkId base = L->base;
+  TValue g;
+  sethvalue(L, &g, cl->env);
+  L->savedpc = pc;
+  luaV_settable(L, &g, KBx(i), RA(i));
+}
+
+
+static void jit_setupval (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  UpVal *uv = curr_func(L)->l.upvals[GETARG_B(i)];
+  StkId ra = L->base + GETARG_A(i);
+  setobj(L, uv->v, ra);
+  luaC_barrier(L, uv, ra);
+}
+
+
+static void jit_settable (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  TValue *k = curr_func(L)->l.p->k;
+  StkId base = L->base;
+  L->savedpc = pc;
+  luaV_settable(L, RA(i), RKB(i), RKC(i));
+}
+
+
+static void jit_newtable (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  int b = GETARG_B(i);
+  int c = GETARG_C(i);
+  L->savedpc = pc;
+  sethvalue(L, L->base + GETARG_A(i),
+            luaH_new(L, luaO_fb2int(b), luaO_fb2int(c)));
+  luaC_checkGC(L);
+}
+
+
+static void jit_self (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  TValue *k = curr_func(L)->l.p->k;
+  StkId base = L->base;
+  StkId ra = RA(i);
+  StkId rb = RB(i);
+  setobjs2s(L, ra+1, rb);
+  L->savedpc = pc;
+  luaV_gettable(L, rb, RKC(i), ra);
+}
+
+
+/* OP_ADD to OP_UNM; the operators are in the same order as their events */
+static void jit_arith (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  OpCode op = GET_OPCODE(i);
+  TValue *k = curr_func(L)->l.p->k;
+  StkId base = L->base;
+  TValue *rb = (op == OP_UNM) ? RB(i) : RKB(i);
+  TValue *rc = (op == OP_UNM) ? rb : RKC(i);
+  L->savedpc = pc;
+  luaV_arith(L, RA(i), rb, rc, cast(TMS, TM_ADD + (op - OP_ADD)));
+}
+
+
+static void jit_len (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  StkId base = L->base;
+  L->savedpc = pc;
+  luaV_objlen(L, RA(i), RB(i));
+}
+
+
+static void jit_concat (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  int b = GETARG_B(i);
+  int c = GETARG_C(i);
+  StkId base;
+  L->savedpc = pc;
+  luaV_concat(L, c-b+1, c);
+  luaC_checkGC(L);
+  base = L->base;
+  setobjs2s(L, RA(i), base+b);
+}
+
+
+/* OP_EQ, OP_LT and OP_LE; returns true if the following jump is taken */
+static int jit_compare (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  TValue *k = curr_func(L)->l.p->k;
+  StkId base = L->base;
+  TValue *rb = RKB(i);
+  TValue *rc = RKC(i);
+  int res;
+  L->savedpc = pc;
+  switch (GET_OPCODE(i)) {
+    case OP_EQ: res = equalobj(L, rb, rc); break;
+    case OP_LT: res = luaV_lessthan(L, rb, rc); break;
+    default: res = luaV_lessequal(L, rb, rc); break;
+  }
+  return (res == GETARG_A(i));
+}
+
+
+static void jit_call (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  StkId ra = L->base + GETARG_A(i);
+  int b = GETARG_B(i);
+  int nresults = GETARG_C(i) - 1;
+  if (b != 0) L->top = ra+b;  /* else previous instruction set top */
+  L->savedpc = pc;
+  /* compiled code only runs with nCcalls > 0, so nothing can yield here */
+  if (luaD_precall(L, ra, nresults) == PCRLUA) {
+    L->nCcalls++;
+    luaV_execute(L, 1);
+    L->nCcalls--;
+  }
+  if (nresults >= 0) L->top = L->ci->top;
+}
+
+
+static void jit_forprep (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  StkId ra = L->base + GETARG_A(i);
+  const TValue *init = ra;
+  const TValue *plimit = ra+1;
+  const TValue *pstep = ra+2;
+  L->savedpc = pc;  /* next steps may throw errors */
+  if (!tonumber(init, ra))
+    luaG_runerror(L, LUA_QL("for") " initial value must be a number");
+  else if (!tonumber(plimit, ra+1))
+    luaG_runerror(L, LUA_QL("for") " limit must be a number");
+  else if (!tonumber(pstep, ra+2))
+    luaG_runerror(L, LUA_QL("for") " step must be a number");
+  setnvalue(ra, luai_numsub(nvalue(ra), nvalue(pstep)));
+}
+
+
+/* returns true if the loop goes on */
+static int jit_tforloop (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  StkId ra = L->base + GETARG_A(i);
+  StkId cb = ra + 3;  /* call base */
+  setobjs2s(L, cb+2, ra+2);
+  setobjs2s(L, cb+1, ra+1);
+  setobjs2s(L, cb, ra);
+  L->top = cb+3;  /* func. + 2 args (state and index) */
+  L->savedpc = pc;
+  luaD_call(L, cb, GETARG_C(i));
+  L->top = L->ci->top;
+  cb = L->base + GETARG_A(i) + 3;  /* previous call may change the stack */
+  if (!ttisnil(cb)) {  /* continue loop? */
+    setobjs2s(L, cb-1, cb);  /* save control variable */
+    return 1;
+  }
+  return 0;
+}
+
+
+static void jit_setlist (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  StkId ra = L->base + GETARG_A(i);
+  int n = GETARG_B(i);
+  int c = GETARG_C(i);
+  int last;
+  Table *h;
+  if (n == 0) {
+    n = cast_int(L->top - ra) - 1;
+    L->top = L->ci->top;
+  }
+  if (c == 0) c = cast_int(*pc);
+  if (!ttistable(ra)) return;
+  h = hvalue(ra);
+  last = ((c-1)*LFIELDS_PER_FLUSH) + n;
+  L->savedpc = pc;
+  if (last > h->sizearray)  /* needs more space? */
+    luaH_resizearray(L, h, last);  /* pre-alloc it at once */
+  for (; n > 0; n--) {
+    TValue *val = ra+n;
+    setobj2t(L, luaH_setnum(L, h, last--), val);
+    luaC_barriert(L, h, val);
+  }
+}
+
+
+static void jit_close (lua_State *L, const Instruction *pc) {
+  luaF_close(L, L->base + GETARG_A(pc[-1]));
+}
+
+
+static void jit_closure (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  LClosure *cl = &curr_func(L)->l;
+  StkId base = L->base;
+  Proto *p = cl->p->p[GETARG_Bx(i)];
+  int nup = p->nups;
+  Closure *ncl;
+  int j;
+  L->savedpc = pc;
+  ncl = luaF_newLclosure(L, nup, cl->env);
+  ncl->l.p = p;
+  for (j=0; j<nup; j++, pc++) {
+    if (GET_OPCODE(*pc) == OP_GETUPVAL)
+      ncl->l.upvals[j] = cl->upvals[GETARG_B(*pc)];
+    else {
+      lua_assert(GET_OPCODE(*pc) == OP_MOVE);
+      ncl->l.upvals[j] = luaF_findupval(L, base + GETARG_B(*pc));
+    }
+  }
+  setclvalue(L, RA(i), ncl);
+  L->savedpc = pc;
+  luaC_checkGC(L);
+}
+
+
+static void jit_vararg (lua_State *L, const Instruction *pc) {
+  Instruction i = pc[-1];
+  LClosure *cl = &curr_func(L)->l;
+  StkId ra = L->base + GETARG_A(i);
+  int b = GETARG_B(i) - 1;
+  int j;
+  CallInfo *ci = L->ci;
+  int n = cast_int(ci->base - ci->func) - cl->p->numparams - 1;
+  if (b == LUA_MULTRET) {
+    L->savedpc = pc;
+    luaD_checkstack(L, n);
+    ra = L->base + GETARG_A(i);  /* previous call may change the stack */
+    b = n;
+    L->top = ra + n;
+  }
+  for (j = 0; j < b; j++) {
+    if (j < n) {
+      setobjs2s(L, ra + j, ci->base - n + j);
+    }
+    else {
+      setnilvalue(ra + j);
+    }
+  }
+}
+
+/* }====================================================== */
+
+
+
+/*
+** {======================================================
+** Machine code emitter
+** =======================================================
+*/
+
+enum { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+       R8, R9, R10, R11, R12, R13, R14, R15 };
+
+enum { XMM0, XMM1, XMM2 };
+
+/* condition codes */
+enum { CC_B = 2, CC_AE = 3, CC_E = 4, CC_NE = 5, CC_BE = 6, CC_A = 7,
+       CC_P = 10, CC_GE = 13 };
+
+/*
+** Registers of compiled code: `L' lives in RBX, `base' in R12 (reloaded
+** after each helper call), `k' in R13, the closure in R14 and `code' in R15
+*/
+#define RL	RBX
+#define RBASE	R12
+#define RK	R13
+#define RCL	R14
+#define RCODE	R15
+
+#define TVSIZE	cast_int(sizeof(TValue))
+#define TVVAL	cast_int(offsetof(TValue, value))
+#define TVTT	cast_int(offsetof(TValue, tt))
+
+#define MAXTEMPLATE	512  /* room needed by the longest template */
+
+
+typedef struct JitFixup {
+  size_t pos;  /* position of a rel32 field */
+  int label;  /* label it refers to */
+} JitFixup;
+
+
+typedef struct JitState {
+  lua_State *L;
+  Proto *p;
+  unsigned char *mcode;  /* machine code buffer */
+  size_t sizemcode;
+  size_t pos;  /* next free position in `mcode' */
+  size_t *label;  /* position of each label */
+  int nlabel;
+  int sizelabel;
+  JitFixup *fixup;
+  int nfixup;
+  int sizefixup;
+  lu_byte *loophead;  /* instructions targeted by backward jumps */
+  int failed;  /* out of memory */
+} JitState;
+
+
+/*
+** the compiler works in memory taken straight from the allocator: if it
+** runs out, the function is just not compiled
+*/
+static void *jitrealloc (JitState *J, void *block, size_t osize,
+                         size_t nsize) {
+  global_State *g = G(J->L);
+  void *nblock = (*g->frealloc)(g->ud, block, osize, nsize);
+  if (nblock == NULL && nsize > 0) {
+    J->failed = 1;
+    return block;
+  }
+  return nblock;
+}
+
+
+static int growarray (JitState *J, void **block, int *size, int n,
+                      size_t elemsize) {
+  if (n >= *size) {
+    int newsize = (*size == 0) ? 16 : 2 * (*size);
+    void *nblock = jitrealloc(J, *block, (*size) * elemsize,
+                              newsize * elemsize);
+    if (J->failed) return 0;
+    *block = nblock;
+    *size = newsize;
+  }
+  return 1;
+}
+
+
+static void ensurespace (JitState *J) {
+  if (J->pos + MAXTEMPLATE > J->sizemcode) {
+    size_t newsize = 2 * J->sizemcode + MAXTEMPLATE;
+    unsigned char *nblock = cast(unsigned char *,
+        jitrealloc(J, J->mcode, J->sizemcode, newsize));
+    if (J->failed) return;
+    J->mcode = nblock;
+    J->sizemcode = newsize;
+  }
+}
+
+
+static int newlabel (JitState *J) {
+  if (!growarray(J, cast(void **, &J->label), &J->sizelabel, J->nlabel,
+                 sizeof(size_t)))
+    return 0;
+  J->label[J->nlabel] = 0;
+  return J->nlabel++;
+}
+
+
+static void bindlabel (JitState *J, int label) {
+  J->label[label] = J->pos;
+}
+
+
+static void emit_b (JitState *J, int b) {
+  J->mcode[J->pos++] = cast(unsigned char, b);
+}
+
+
+static void emit_d (JitState *J, int d) {
+  unsigned int u = cast(unsigned int, d);
+  emit_b(J, u & 0xff);
+  emit_b(J, (u >> 8) & 0xff);
+  emit_b(J, (u >> 16) & 0xff);
+  emit_b(J, (u >> 24) & 0xff);
+}
+
+
+static void emit_q (JitState *J, size_t q) {
+  emit_d(J, cast_int(q & 0xffffffffu));
+  emit_d(J, cast_int(q >> 32));
+}
+
+
+/* REX prefix for a 64-bit operation (if `w') on registers `reg' and `rm' */
+static void emit_rex (JitState *J, int w, int reg, int rm) {
+  int rex = 0x40 | (w << 3) | ((reg >> 3) << 2) | (rm >> 3);
+  if (rex != 0x40) emit_b(J, rex);
+}
+
+
+/* opcode with an optional legacy prefix, REX prefix and 0F escape */
+static void emit_opcode (JitState *J, int prefix, int w, int op, int reg,
+                         int rm) {
+  if (prefix) emit_b(J, prefix);
+  emit_rex(J, w, reg, rm);
+  if (op > 0xff) emit_b(J, op >> 8);
+  emit_b(J, op & 0xff);
+}
+
+
+/* `op reg, [base+disp]' */
+static void emit_rm (JitState *J, int prefix, int w, int op, int reg,
+                     int base, int disp) {
+  int small = (-128 <= disp && disp <= 127);
+  emit_opcode(J, prefix, w, op, reg, base);
+  emit_b(J, (small ? 0x40 : 0x80) | ((reg & 7) << 3) | (base & 7));
+  if ((base & 7) == RSP) emit_b(J, 0x24);  /* SIB byte for RSP/R12 */
+  if (small) emit_b(J, disp & 0xff);
+  else emit_d(J, disp);
+}
+
+
+/* `op reg, rm' between registers */
+static void emit_rr (JitState *J, int prefix, int w, int op, int reg,
+                     int rm) {
+  emit_opcode(J, prefix, w, op, reg, rm);
+  emit_b(J, 0xc0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+
+#define emit_loadq(J,r,b,d)	emit_rm(J, 0, 1, 0x8b, r, b, d)
+#define emit_storeq(J,r,b,d)	emit_rm(J, 0, 1, 0x89, r, b, d)
+#define emit_movq(J,dst,src)	emit_rr(J, 0, 1, 0x89, src, dst)
+#define emit_leaq(J,r,b,d)	emit_rm(J, 0, 1, 0x8d, r, b, d)
+#define emit_movsd(J,x,b,d)	emit_rm(J, 0xf2, 0, 0x0f10, x, b, d)
+#define emit_storesd(J,x,b,d)	emit_rm(J, 0xf2, 0, 0x0f11, x, b, d)
+#define emit_sse(J,op,x,b,d)	emit_rm(J, 0xf2, 0, op, x, b, d)
+#define emit_ucomisd(J,x,b,d)	emit_rm(J, 0x66, 0, 0x0f2e, x, b, d)
+#define emit_ucomisdrr(J,x,y)	emit_rr(J, 0x66, 0, 0x0f2e, x, y)
+
+
+/* `mov dword [base+disp], imm' */
+static void emit_storei (JitState *J, int base, int disp, int imm) {
+  emit_rm(J, 0, 0, 0xc7, 0, base, disp);
+  emit_d(J, imm);
+}
+
+
+/* `cmp dword [base+disp], imm' */
+static void emit_cmpi (JitState *J, int base, int disp, int imm) {
+  if (-128 <= imm && imm <= 127) {
+    emit_rm(J, 0, 0, 0x83, 7, base, disp);
+    emit_b(J, imm & 0xff);
+  }
+  else {
+    emit_rm(J, 0, 0, 0x81, 7, base, disp);
+    emit_d(J, imm);
+  }
+}
+
+
+static void emit_movimm (JitState *J, int r, size_t imm) {
+  emit_rex(J, 1, 0, r);
+  emit_b(J, 0xb8 + (r & 7));
+  emit_q(J, imm);
+}
+
+
+static void emit_push (JitState *J, int r) {
+  emit_rex(J, 0, 0, r);
+  emit_b(J, 0x50 + (r & 7));
+}
+
+
+static void emit_pop (JitState *J, int r) {
+  emit_rex(J, 0, 0, r);
+  emit_b(J, 0x58 + (r & 7));
+}
+
+
+static void addfixup (JitState *J, int label) {
+  if (!growarray(J, cast(void **, &J->fixup), &J->sizefixup, J->nfixup,
+                 sizeof(JitFixup)))
+    return;
+  J->fixup[J->nfixup].pos = J->pos;
+  J->fixup[J->nfixup].label = label;
+  J->nfixup++;
+  emit_d(J, 0);
+}
+
+
+static void emit_jmp (JitState *J, int label) {
+  emit_b(J, 0xe9);
+  addfixup(J, label);
+}
+
+
+static void emit_jcc (JitState *J, int cc, int label) {
+  emit_b(J, 0x0f);
+  emit_b(J, 0x80 + cc);
+  addfixup(J, label);
+}
+
+
+/* operand of an RK argument */
+static void rkoperand (int x, int *base, int *disp) {
+  if (ISK(x)) {
+    *base = RK;
+    *disp = INDEXK(x) * TVSIZE;
+  }
+  else {
+    *base = RBASE;
+    *disp = x * TVSIZE;
+  }
+}
+
+
+/* constant value of an RK argument (NULL if it is a register) */
+static const TValue *rkconstant (JitState *J, int x) {
+  return ISK(x) ? &J->p->k[INDEXK(x)] : NULL;
+}
+
+
+/* jump to `fail' unless the RK argument `x' is a number */
+static void emit_checknum (JitState *J, int x, int fail) {
+  if (!ISK(x)) {  /* constants are checked when compiling */
+    emit_cmpi(J, RBASE, x * TVSIZE + TVTT, LUA_TNUMBER);
+    emit_jcc(J, CC_NE, fail);
+  }
+}
+
+
+/* a number constant, or a register (which may hold a number) */
+static int maybenumber (JitState *J, int x) {
+  const TValue *o = rkconstant(J, x);
+  return (o == NULL || ttisnumber(o));
+}
+
+
+/* copy a whole TValue through XMM0 */
+static void emit_copy (JitState *J, int dbase, int ddisp, int sbase,
+                       int sdisp) {
+  emit_rm(J, 0, 0, 0x0f10, XMM0, sbase, sdisp);  /* movups */
+  emit_rm(J, 0, 0, 0x0f11, XMM0, dbase, ddisp);
+}
+
+
+/* call a helper with `L' and the address of instruction `n' */
+static void emit_call (JitState *J, JitHelper f, int n) {
+  emit_movq(J, RDI, RL);
+  emit_leaq(J, RSI, RCODE, n * cast_int(sizeof(Instruction)));
+  emit_movimm(J, RAX, cast(size_t, f));
+  emit_b(J, 0xff); emit_b(J, 0xd0);  /* call rax */
+  emit_loadq(J, RBASE, RL, cast_int(offsetof(lua_State, base)));
+}
+
+
+/* leave compiled code; the interpreter goes on at instruction `n' */
+static void emit_exit (JitState *J, int n) {
+  emit_leaq(J, RAX, RCODE, n * cast_int(sizeof(Instruction)));
+  emit_storeq(J, RAX, RL, cast_int(offsetof(lua_State, savedpc)));
+  emit_jmp(J, J->p->sizecode);
+}
+
+
+/* leave at instruction `n' if a line or count hook is set */
+static void emit_hookcheck (JitState *J, int n) {
+  int go = newlabel(J);
+  emit_rm(J, 0, 0, 0xf6, 0, RL, cast_int(offsetof(lua_State, hookmask)));
+  emit_b(J, LUA_MASKLINE | LUA_MASKCOUNT);  /* test byte [L+hookmask] */
+  emit_jcc(J, CC_E, go);
+  emit_exit(J, n);
+  bindlabel(J, go);
+}
+
+
+/*
+** Branch to `f' if register `x' is false and to `t' otherwise; labels
+** that are -1 are reached by falling through
+*/
+static void emit_truth (JitState *J, int x, int t, int f) {
+  int tl = (t < 0) ? newlabel(J) : t;
+  int fl = (f < 0) ? newlabel(J) : f;
+  emit_cmpi(J, RBASE, x * TVSIZE + TVTT, LUA_TNIL);
+  emit_jcc(J, CC_E, fl);
+  emit_cmpi(J, RBASE, x * TVSIZE + TVTT, LUA_TBOOLEAN);
+  emit_jcc(J, CC_NE, tl);
+  emit_cmpi(J, RBASE, x * TVSIZE + TVVAL, 0);
+  emit_jcc(J, CC_E, fl);
+  if (t >= 0) emit_jmp(J, t);
+  else bindlabel(J, tl);
+  if (f < 0) bindlabel(J, fl);
+}
+
+
+/*
+** Leave RAX pointing to the slot of the array part of the table whose
+** pointer is in RDX, at the RK key `c'; jumps to `fail' if the key is not
+** an integer inside the array part
+*/
+static int emit_arrayslot (JitState *J, int c, int fail) {
+  const TValue *key = rkconstant(J, c);
+  if (key != NULL) {
+    lua_Number n;
+    int idx;
+    if (!ttisnumber(key)) return 0;
+    n = nvalue(key);
+    lua_number2int(idx, n);
+    if (cast_num(idx) != n || idx < 1 || idx > (MAX_INT / TVSIZE))
+      return 0;
+    emit_cmpi(J, RDX, cast_int(offsetof(Table, sizearray)), idx - 1);
+    emit_jcc(J, CC_BE, fail);
+    emit_loadq(J, RAX, RDX, cast_int(offsetof(Table, array)));
+    if (idx > 1) {
+      emit_rr(J, 0, 1, 0x81, 0, RAX);  /* add rax, imm32 */
+      emit_d(J, (idx - 1) * TVSIZE);
+    }
+    return 1;
+  }
+  emit_cmpi(J, RBASE, c * TVSIZE + TVTT, LUA_TNUMBER);
+  emit_jcc(J, CC_NE, fail);
+  emit_movsd(J, XMM0, RBASE, c * TVSIZE + TVVAL);
+  emit_rr(J, 0xf2, 1, 0x0f2c, RAX, XMM0);  /* cvttsd2si rax, xmm0 */
+  emit_rr(J, 0xf2, 1, 0x0f2a, XMM1, RAX);  /* cvtsi2sd xmm1, rax */
+  emit_ucomisdrr(J, XMM0, XMM1);
+  emit_jcc(J, CC_NE, fail);
+  emit_jcc(J, CC_P, fail);
+  emit_rr(J, 0, 1, 0x83, 5, RAX);  /* sub rax, 1 */
+  emit_b(J, 1);
+  emit_rm(J, 0, 0, 0x8b, RCX, RDX, cast_int(offsetof(Table, sizearray)));
+  emit_rr(J, 0, 1, 0x3b, RAX, RCX);  /* cmp rax, rcx */
+  emit_jcc(J, CC_AE, fail);
+  emit_rr(J, 0, 1, 0xc1, 4, RAX);  /* shl rax, 4 */
+  emit_b(J, 4);
+  emit_rm(J, 0, 1, 0x03, RAX, RDX, cast_int(offsetof(Table, array)));
+  return 1;
+}
+
+/* }====================================================== */
+
+
+
+/*
+** {======================================================
+** Opcode templates
+** =======================================================
+*/
+
+static void arithop (JitState *J, Instruction i, int n) {
+  int b = GETARG_B(i);
+  int c = GETARG_C(i);
+  int a = GETARG_A(i) * TVSIZE;
+  int slow, done, bb, bd, cb, cd;
+  static const int sseop[] = {0x0f58, 0x0f5c, 0x0f59, 0x0f5e};
+  if (!maybenumber(J, b) || !maybenumber(J, c)) {
+    emit_call(J, cast(JitHelper, jit_arith), n+1);
+    return;
+  }
+  slow = newlabel(J);
+  done = newlabel(J);
+  emit_checknum(J, b, slow);
+  emit_checknum(J, c, slow);
+  rkoperand(b, &bb, &bd);
+  rkoperand(c, &cb, &cd);
+  emit_movsd(J, XMM0, bb, bd + TVVAL);
+  emit_sse(J, sseop[GET_OPCODE(i) - OP_ADD], XMM0, cb, cd + TVVAL);
+  emit_storesd(J, XMM0, RBASE, a + TVVAL);
+  emit_storei(J, RBASE, a + TVTT, LUA_TNUMBER);
+  emit_jmp(J, done);
+  bindlabel(J, slow);
+  emit_call(J, cast(JitHelper, jit_arith), n+1);
+  bindlabel(J, done);
+}
+
+
+static void compareop (JitState *J, Instruction i, int n) {
+  int b = GETARG_B(i);
+  int c = GETARG_C(i);
+  int target = n + 2 + GETARG_sBx(J->p->code[n+1]);
+  int next = n + 2;
+  int jt = GETARG_A(i) ? target : next;  /* where to go if true */
+  int jf = GETARG_A(i) ? next : target;  /* where to go if false */
+  const TValue *kb = rkconstant(J, b);
+  const TValue *kc = rkconstant(J, c);
+  int slow = newlabel(J);
+  OpCode op = GET_OPCODE(i);
+  if (op == OP_EQ && (kb == NULL) != (kc == NULL) &&
+      (ttisnil(kb ? kb : kc) || ttisboolean(kb ? kb : kc))) {
+    /* comparison of a register against nil or a boolean */
+    const TValue *o = kb ? kb : kc;
+    int x = (kb ? c : b) * TVSIZE;
+    emit_cmpi(J, RBASE, x + TVTT, ttype(o));
+    emit_jcc(J, CC_NE, jf);
+    if (ttisboolean(o)) {
+      emit_cmpi(J, RBASE, x + TVVAL, bvalue(o));
+      emit_jcc(J, CC_NE, jf);
+    }
+    emit_jmp(J, jt);
+    return;
+  }
+  if (maybenumber(J, b) && maybenumber(J, c)) {
+    int bb, bd, cb, cd;
+    emit_checknum(J, b, slow);
+    emit_checknum(J, c, slow);
+    rkoperand(b, &bb, &bd);
+    rkoperand(c, &cb, &cd);
+    if (op == OP_EQ) {
+      emit_movsd(J, XMM0, bb, bd + TVVAL);
+      emit_ucomisd(J, XMM0, cb, cd + TVVAL);
+      emit_jcc(J, CC_P, jf);  /* NaN is not equal to anything */
+      emit_jcc(J, CC_NE, jf);
+      emit_jmp(J, jt);
+    }
+    else {
+      /* compare c with b, so that an unordered result means false */
+      emit_movsd(J, XMM0, cb, cd + TVVAL);
+      emit_ucomisd(J, XMM0, bb, bd + TVVAL);
+      emit_jcc(J, (op == OP_LT) ? CC_A : CC_AE, jt);
+      emit_jmp(J, jf);
+    }
+  }
+  bindlabel(J, slow);
+  emit_call(J, cast(JitHelper, jit_compare), n+1);
+  emit_b(J, 0x85); emit_b(J, 0xc0);  /* test eax, eax */
+  emit_jcc(J, CC_NE, target);
+  emit_jmp(J, next);
+}
+
+
+static void forloopop (JitState *J, Instruction i, int n) {
+  int a = GETARG_A(i) * TVSIZE;
+  int target = n + 1 + GETARG_sBx(i);
+  int pos = newlabel(J);
+  int loop = newlabel(J);
+  emit_movsd(J, XMM0, RBASE, a + TVVAL);
+  emit_sse(J, 0x0f58, XMM0, RBASE, a + 2*TVSIZE + TVVAL);  /* idx+step */
+  emit_movsd(J, XMM2, RBASE, a + 2*TVSIZE + TVVAL);
+  emit_rr(J, 0x66, 0, 0x0f57, XMM1, XMM1);  /* xorpd xmm1, xmm1 */
+  emit_ucomisdrr(J, XMM2, XMM1);
+  emit_jcc(J, CC_A, pos);  /* 0 < step? */
+  emit_ucomisd(J, XMM0, RBASE, a + TVSIZE + TVVAL);  /* limit <= idx? */
+  emit_jcc(J, CC_AE, loop);
+  emit_jmp(J, n+1);
+  bindlabel(J, pos);
+  emit_movsd(J, XMM1, RBASE, a + TVSIZE + TVVAL);
+  emit_ucomisdrr(J, XMM1, XMM0);  /* idx <= limit? */
+  emit_jcc(J, CC_AE, loop);
+  emit_jmp(J, n+1);
+  bindlabel(J, loop);
+  emit_storesd(J, XMM0, RBASE, a + TVVAL);  /* update internal index... */
+  emit_storesd(J, XMM0, RBASE, a + 3*TVSIZE + TVVAL);  /* ...and external */
+  emit_storei(J, RBASE, a + 3*TVSIZE + TVTT, LUA_TNUMBER);
+  emit_jmp(J, target);
+}
+
+
+static void gettableop (JitState *J, Instruction i, int n) {
+  int a = GETARG_A(i) * TVSIZE;
+  int b = GETARG_B(i) * TVSIZE;
+  int slow = newlabel(J);
+  int done = newlabel(J);
+  if (!maybenumber(J, GETARG_C(i))) {  /* no array access */
+    emit_call(J, cast(JitHelper, jit_gettable), n+1);
+    return;
+  }
+  emit_cmpi(J, RBASE, b + TVTT, LUA_TTABLE);
+  emit_jcc(J, CC_NE, slow);
+  emit_loadq(J, RDX, RBASE, b + TVVAL);
+  if (emit_arrayslot(J, GETARG_C(i), slow)) {
+    /* a nil entry may have to go through __index */
+    emit_cmpi(J, RAX, TVTT, LUA_TNIL);
+    emit_jcc(J, CC_E, slow);
+    emit_copy(J, RBASE, a, RAX, 0);
+    emit_jmp(J, done);
+  }
+  bindlabel(J, slow);
+  emit_call(J, cast(JitHelper, jit_gettable), n+1);
+  bindlabel(J, done);
+}
+
+
+static void settableop (JitState *J, Instruction i, int n) {
+  int a = GETARG_A(i) * TVSIZE;
+  int c = GETARG_C(i);
+  const TValue *kc = rkconstant(J, c);
+  int slow = newlabel(J);
+  int done = newlabel(J);
+  /* values that need no write barrier are set inline */
+  if (maybenumber(J, GETARG_B(i)) && (kc == NULL || !iscollectable(kc))) {
+    int cb, cd;
+    rkoperand(c, &cb, &cd);
+    emit_cmpi(J, RBASE, a + TVTT, LUA_TTABLE);
+    emit_jcc(J, CC_NE, slow);
+    if (kc == NULL) {
+      emit_cmpi(J, RBASE, cd + TVTT, LUA_TSTRING);
+      emit_jcc(J, CC_GE, slow);
+    }
+    emit_loadq(J, RDX, RBASE, a + TVVAL);
+    if (emit_arrayslot(J, GETARG_B(i), slow)) {
+      /* a nil entry may have to go through __newindex */
+      emit_cmpi(J, RAX, TVTT, LUA_TNIL);
+      emit_jcc(J, CC_E, slow);
+      emit_copy(J, RAX, 0, cb, cd);
+      emit_rm(J, 0, 0, 0xc6, 0, RDX, cast_int(offsetof(Table, flags)));
+      emit_b(J, 0);  /* mov byte [rdx+flags], 0 (as luaH_set does) */
+      emit_jmp(J, done);
+    }
+  }
+  bindlabel(J, slow);
+  emit_call(J, cast(JitHelper, jit_settable), n+1);
+  bindlabel(J, done);
+}
+
+/* }====================================================== */
+
+
+
+/*
+** {======================================================
+** Compiler
+** =======================================================
+*/
+
+/* mark the targets of backward jumps; they get a hook check */
+static void findloops (JitState *J) {
+  Proto *p = J->p;
+  int n;
+  for (n = 0; n < p->sizecode; n++) {
+    Instruction i = p->code[n];
+    switch (GET_OPCODE(i)) {
+      case OP_JMP: case OP_FORLOOP: {
+        int target = n + 1 + GETARG_sBx(i);
+        if (target <= n) J->loophead[target] = 1;
+        break;
+      }
+      case OP_SETLIST: {
+        if (GETARG_C(i) == 0) n++;  /* skip data word */
+        break;
+      }
+      case OP_CLOSURE: {
+        n += p->p[GETARG_Bx(i)]->nups;  /* skip upvalue pseudo-instructions */
+        break;
+      }
+      default: break;
+    }
+  }
+}
+
+
+static void prologue (JitState *J) {
+  emit_push(J, RBP);
+  emit_movq(J, RBP, RSP);
+  emit_push(J, RBX);
+  emit_push(J, R12);
+  emit_push(J, R13);
+  emit_push(J, R14);
+  emit_push(J, R15);
+  emit_b(J, 0x48); emit_b(J, 0x83); emit_b(J, 0xec); emit_b(J, 8);  /* sub rsp, 8 */
+  emit_movq(J, RL, RDI);
+  emit_movq(J, RCL, RSI);
+  emit_loadq(J, RBASE, RL, cast_int(offsetof(lua_State, base)));
+  emit_movimm(J, RK, cast(size_t, J->p->k));
+  emit_movimm(J, RCODE, cast(size_t, J->p->code));
+}
+
+
+static void epilogue (JitState *J) {
+  emit_b(J, 0x48); emit_b(J, 0x83); emit_b(J, 0xc4); emit_b(J, 8);  /* add rsp, 8 */
+  emit_pop(J, R15);
+  emit_pop(J, R14);
+  emit_pop(J, R13);
+  emit_pop(J, R12);
+  emit_pop(J, RBX);
+  emit_pop(J, RBP);
+  emit_b(J, 0xc3);  /* ret */
+}
+
+
+static void compileop (JitState *J, int n) {
+  Instruction i = J->p->code[n];
+  int a = GETARG_A(i) * TVSIZE;
+  if (J->loophead[n])  /* leave if a hook wants to see this iteration */
+    emit_hookcheck(J, n);
+  switch (GET_OPCODE(i)) {
+    case OP_MOVE: {
+      emit_copy(J, RBASE, a, RBASE, GETARG_B(i) * TVSIZE);
+      break;
+    }
+    case OP_LOADK: {
+      emit_copy(J, RBASE, a, RK, GETARG_Bx(i) * TVSIZE);
+      break;
+    }
+    case OP_LOADBOOL: {
+      emit_storei(J, RBASE, a + TVVAL, GETARG_B(i));
+      emit_storei(J, RBASE, a + TVTT, LUA_TBOOLEAN);
+      if (GETARG_C(i)) emit_jmp(J, n+2);  /* skip next instruction */
+      break;
+    }
+    case OP_LOADNIL: {
+      int x;
+      for (x = GETARG_A(i); x <= GETARG_B(i) && !J->failed; x++) {
+        ensurespace(J);
+        if (!J->failed) emit_storei(J, RBASE, x * TVSIZE + TVTT, LUA_TNIL);
+      }
+      break;
+    }
+    case OP_GETUPVAL: {
+      emit_loadq(J, RAX, RCL, cast_int(offsetof(LClosure, upvals)) +
+                              GETARG_B(i) * cast_int(sizeof(UpVal *)));
+      emit_loadq(J, RAX, RAX, cast_int(offsetof(UpVal, v)));
+      emit_copy(J, RBASE, a, RAX, 0);
+      break;
+    }
+    case OP_GETGLOBAL: {
+      emit_call(J, cast(JitHelper, jit_getglobal), n+1);
+      break;
+    }
+    case OP_GETTABLE: {
+      gettableop(J, i, n);
+      break;
+    }
+    case OP_SETGLOBAL: {
+      emit_call(J, cast(JitHelper, jit_setglobal), n+1);
+      break;
+    }
+    case OP_SETUPVAL: {
+      emit_call(J, cast(JitHelper, jit_setupval), n+1);
+      break;
+    }
+    case OP_SETTABLE: {
+      settableop(J, i, n);
+      break;
+    }
+    case OP_NEWTABLE: {
+      emit_call(J, cast(JitHelper, jit_newtable), n+1);
+      break;
+    }
+    case OP_SELF: {
+      emit_call(J, cast(JitHelper, jit_self), n+1);
+      break;
+    }
+    case OP_ADD: case OP_SUB: case OP_MUL: case OP_DIV: {
+      arithop(J, i, n);
+      break;
+    }
+    case OP_MOD: case OP_POW: case OP_UNM: {
+      emit_call(J, cast(JitHelper, jit_arith), n+1);
+      break;
+    }
+    case OP_NOT: {
+      int f = newlabel(J);
+      int done = newlabel(J);
+      emit_truth(J, GETARG_B(i), -1, f);
+      emit_storei(J, RBASE, a + TVVAL, 0);
+      emit_jmp(J, done);
+      bindlabel(J, f);
+      emit_storei(J, RBASE, a + TVVAL, 1);
+      bindlabel(J, done);
+      emit_storei(J, RBASE, a + TVTT, LUA_TBOOLEAN);
+      break;
+    }
+    case OP_LEN: {
+      emit_call(J, cast(JitHelper, jit_len), n+1);
+      break;
+    }
+    case OP_CONCAT: {
+      emit_call(J, cast(JitHelper, jit_concat), n+1);
+      break;
+    }
+    case OP_JMP: {
+      emit_jmp(J, n + 1 + GETARG_sBx(i));
+      break;
+    }
+    case OP_EQ: case OP_LT: case OP_LE: {
+      compareop(J, i, n);
+      break;
+    }
+    case OP_TEST: {
+      int target = n + 2 + GETARG_sBx(J->p->code[n+1]);
+      if (GETARG_C(i))
+        emit_truth(J, GETARG_A(i), target, n+2);
+      else
+        emit_truth(J, GETARG_A(i), n+2, target);
+      break;
+    }
+    case OP_TESTSET: {
+      int target = n + 2 + GETARG_sBx(J->p->code[n+1]);
+      int jump = newlabel(J);
+      if (GETARG_C(i))
+        emit_truth(J, GETARG_B(i), jump, n+2);
+      else
+        emit_truth(J, GETARG_B(i), n+2, jump);
+      bindlabel(J, jump);
+      emit_copy(J, RBASE, a, RBASE, GETARG_B(i) * TVSIZE);
+      emit_jmp(J, target);
+      break;
+    }
+    case OP_CALL: {
+      emit_call(J, cast(JitHelper, jit_call), n+1);
+      emit_hookcheck(J, n+1);  /* the callee may have set a hook */
+      break;
+    }
+    case OP_TAILCALL: case OP_RETURN: {
+      emit_exit(J, n);  /* the interpreter unwinds the frame */
+      break;
+    }
+    case OP_FORLOOP: {
+      forloopop(J, i, n);
+      break;
+    }
+    case OP_FORPREP: {
+      emit_call(J, cast(JitHelper, jit_forprep), n+1);
+      emit_jmp(J, n + 1 + GETARG_sBx(i));
+      break;
+    }
+    case OP_TFORLOOP: {
+      emit_call(J, cast(JitHelper, jit_tforloop), n+1);
+      emit_b(J, 0x85); emit_b(J, 0xc0);  /* test eax, eax */
+      emit_jcc(J, CC_NE, n + 2 + GETARG_sBx(J->p->code[n+1]));
+      emit_jmp(J, n+2);
+      break;
+    }
+    case OP_SETLIST: {
+      emit_call(J, cast(JitHelper, jit_setlist), n+1);
+      break;
+    }
+    case OP_CLOSE: {
+      emit_call(J, cast(JitHelper, jit_close), n+1);
+      break;
+    }
+    case OP_CLOSURE: {
+      emit_call(J, cast(JitHelper, jit_closure), n+1);
+      break;
+    }
+    case OP_VARARG: {
+      emit_call(J, cast(JitHelper, jit_vararg), n+1);
+      break;
+    }
+  }
+}
+
+
+/* number of data words after instruction `n' that are not instructions */
+static int datawords (Proto *p, int n) {
+  Instruction i = p->code[n];
+  switch (GET_OPCODE(i)) {
+    case OP_SETLIST: return (GETARG_C(i) == 0);
+    case OP_CLOSURE: return p->p[GETARG_Bx(i)]->nups;
+    default: return 0;
+  }
+}
+
+/* }====================================================== */
+
+
+
+/*
+** {======================================================
+** Executable memory
+** =======================================================
+*/
+
+/*
+** Compiled code lives in chunks of memory mapped from the system. A
+** chunk is made writable only while code is copied into it. All chunks
+** are released when the state is closed.
+*/
+#define JIT_CHUNKSIZE	(64*1024)
+#define JIT_CODEOFFSET	256  /* code starts after the chunk header */
+
+
+typedef struct JitChunk {
+  struct JitChunk *next;
+  size_t size;  /* size of the whole mapping */
+  size_t used;  /* bytes in use (header included) */
+#if defined(__cplusplus)
+  unsigned char ehframe[128];  /* unwind information for the chunk */
+#endif
+} JitChunk;
+
+
+#if defined(__cplusplus)
+
+/*
+** When Lua is built as C++, errors are C++ exceptions, which must be able
+** to unwind through compiled code. All compiled functions have the same
+** frame layout, so one DWARF frame description covers the whole chunk.
+*/
+extern "C" void __register_frame (void *begin);
+extern "C" void __deregister_frame (void *begin);
+
+
+static unsigned char *putword (unsigned char *p, unsigned int w) {
+  memcpy(p, &w, sizeof(w));
+  return p + sizeof(w);
+}
+
+
+static unsigned char *putaddr (unsigned char *p, size_t a) {
+  memcpy(p, &a, sizeof(a));
+  return p + sizeof(a);
+}
+
+
+static void registerchunk (JitChunk *c) {
+  static const unsigned char cie[] = {
+    1, 'z', 'R', 0,  /* version, augmentation */
+    1, 0x78, 16,  /* code align 1, data align -8, return address is rip */
+    1, 0,  /* augmentation data: absolute pointers */
+    0x0c, 7, 8,  /* DW_CFA_def_cfa: rsp + 8 */
+    0x80 | 16, 1,  /* DW_CFA_offset: rip at cfa - 8 */
+    0, 0  /* padding */
+  };
+  static const unsigned char fde[] = {
+    0,  /* no augmentation data */
+    0x0c, 6, 16,  /* DW_CFA_def_cfa: rbp + 16 */
+    0x80 | 6, 2,  /* rbp at cfa - 16 */
+    0x80 | 3, 3,  /* rbx at cfa - 24 */
+    0x80 | 12, 4,  /* r12 at cfa - 32 */
+    0x80 | 13, 5,  /* r13 at cfa - 40 */
+    0x80 | 14, 6,  /* r14 at cfa - 48 */
+    0x80 | 15, 7  /* r15 at cfa - 56 */
+  };
+  unsigned char *p = c->ehframe;
+  p = putword(p, 4 + sizeof(cie));
+  p = putword(p, 0);  /* CIE id */
+  memcpy(p, cie, sizeof(cie));
+  p += sizeof(cie);
+  p = putword(p, 4 + 2*sizeof(size_t) + sizeof(fde));
+  p = putword(p, cast(unsigned int, p - c->ehframe));  /* CIE pointer */
+  p = putaddr(p, cast(size_t, c) + JIT_CODEOFFSET);
+  p = putaddr(p, c->size - JIT_CODEOFFSET);
+  memcpy(p, fde, sizeof(fde));
+  p += sizeof(fde);
+  putword(p, 0);  /* end of the table */
+  lua_assert(p + 4 <= c->ehframe + sizeof(c->ehframe));
+  __register_frame(c->ehframe);
+}
+
+
+static void deregisterchunk (JitChunk *c) {
+  __deregister_frame(c->ehframe);
+}
+
+#else
+
+#define registerchunk(c)	((void)0)
+#define deregisterchunk(c)	((void)0)
+
+#endif
+
+
+static JitChunk *newchunk (lua_State *L, size_t size) {
+  global_State *g = G(L);
+  JitChunk *c;
+  void *m;
+  lua_assert(sizeof(JitChunk) <= JIT_CODEOFFSET);
+  size = (size + JIT_CODEOFFSET + JIT_CHUNKSIZE - 1) & ~cast(size_t, JIT_CHUNKSIZE - 1);
+  m = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+           -1, 0);
+  if (m == MAP_FAILED) return NULL;
+  c = cast(JitChunk *, m);
+  c->size = size;
+  c->used = JIT_CODEOFFSET;
+  c->next = cast(JitChunk *, g->jitchunks);
+  g->jitchunks = c;
+  registerchunk(c);
+  return c;
+}
+
+
+/* copy `size' bytes of code into executable memory */
+static void *install (lua_State *L, const unsigned char *code, size_t size) {
+  JitChunk *c = cast(JitChunk *, G(L)->jitchunks);
+  void *dest;
+  if (c == NULL || c->size - c->used < size) {
+    c = newchunk(L, size);
+    if (c == NULL) return NULL;
+  }
+  else if (mprotect(c, c->size, PROT_READ | PROT_WRITE) != 0)
+    return NULL;
+  dest = cast(unsigned char *, c) + c->used;
+  memcpy(dest, code, size);
+  c->used = (c->used + size + 15) & ~cast(size_t, 15);
+  if (c->used > c->size) c->used = c->size;
+  if (mprotect(c, c->size, PROT_READ | PROT_EXEC) != 0)
+    return NULL;
+  return dest;
+}
+
+/* }====================================================== */
+
+
+
+static int compile (lua_State *L, Proto *p) {
+  JitState J;
+  int n;
+  void *code = NULL;
+  memset(&J, 0, sizeof(J));
+  J.L = L;
+  J.p = p;
+  J.loophead = cast(lu_byte *, jitrealloc(&J, NULL, 0, p->sizecode));
+  if (J.failed) return 0;
+  memset(J.loophead, 0, p->sizecode);
+  findloops(&J);
+  /* labels 0 to `sizecode'-1 are the instructions; `sizecode' is the exit */
+  for (n = 0; n <= p->sizecode && !J.failed; n++) newlabel(&J);
+  ensurespace(&J);
+  if (!J.failed) prologue(&J);
+  for (n = 0; n < p->sizecode && !J.failed; n++) {
+    int d = datawords(p, n);
+    ensurespace(&J);
+    if (J.failed) break;
+    bindlabel(&J, n);
+    compileop(&J, n);
+    for (; d > 0; d--) bindlabel(&J, ++n);  /* data words are not code */
+  }
+  ensurespace(&J);
+  if (!J.failed) {
+    int f;
+    bindlabel(&J, p->sizecode);
+    epilogue(&J);
+    for (f = 0; f < J.nfixup; f++) {
+      size_t pos = J.fixup[f].pos;
+      int rel = cast_int(J.label[J.fixup[f].label]) - cast_int(pos + 4);
+      memcpy(J.mcode + pos, &rel, sizeof(rel));
+    }
+    code = install(L, J.mcode, J.pos);
+  }
+  jitrealloc(&J, J.mcode, J.sizemcode, 0);
+  jitrealloc(&J, J.label, J.sizelabel * sizeof(size_t), 0);
+  jitrealloc(&J, J.fixup, J.sizefixup * sizeof(JitFixup), 0);
+  jitrealloc(&J, J.loophead, p->sizecode, 0);
+  if (code == NULL) return 0;
+  p->jitcode = code;
+  G(L)->jitcount++;
+  return 1;
+}
+
+
+int luaJ_enter (lua_State *L, LClosure *cl) {
+  global_State *g = G(L);
+  Proto *p = cl->p;
+  if (!g->jiton || (L->hookmask & (LUA_MASKLINE | LUA_MASKCOUNT)))
+    return 0;
+  /* with nCcalls == 0 the code may yield, which needs the interpreter */
+  if (L->nCcalls == 0 || L->nCcalls >= LUAI_JITMAXCCALLS)
+    return 0;
+  if (p->jitcode == NULL) {
+    if (p->jitcalls < 0 || ++p->jitcalls < g->jitthreshold)
+      return 0;
+    if (!compile(L, p)) {
+      p->jitcalls = -1;  /* do not try again */
+      return 0;
+    }
+  }
+  (*cast(JitFunction, p->jitcode))(L, cl);
+  return 1;
+}
+
+
+int luaJ_control (lua_State *L, int what, int data) {
+  global_State *g = G(L);
+  int res = 0;
+  switch (what) {
+    case LUA_JITSTOP: {
+      g->jiton = 0;
+      break;
+    }
+    case LUA_JITRESTART: {
+      g->jiton = 1;
+      break;
+    }
+    case LUA_JITTHRESHOLD: {
+      res = g->jitthreshold;
+      if (data > 0) g->jitthreshold = data;
+      break;
+    }
+    case LUA_JITCOUNT: {
+      res = g->jitcount;
+      break;
+    }
+    default: res = -1;  /* invalid option */
+  }
+  return res;
+}
+
+
+void luaJ_close (lua_State *L) {
+  global_State *g = G(L);
+  JitChunk *c = cast(JitChunk *, g->jitchunks);
+  while (c != NULL) {
+    JitChunk *next = c->next;
+    deregisterchunk(c);
+    munmap(c, c->size);
+    c = next;
+  }
+  g->jitchunks = NULL;
+}
+
+#endif
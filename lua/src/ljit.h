@@ -0,0 +1,22 @@
+/*
+** $Id: ljit.h $
+** Baseline JIT compiler for Lua functions
+** See Copyright Notice in lua.h
+*/
+
+#ifndef ljit_h
+#define ljit_h
+
+
+#include "lobject.h"
+
+
+#if defined(LUA_USE_JIT)
+
+LUAI_FUNC int luaJ_enter (lua_State *L, LClosure *cl);
+LUAI_FUNC int luaJ_control (lua_State *L, int what, int data);
+LUAI_FUNC void luaJ_close (lua_State *L);
+
+#endif
+
+#endif
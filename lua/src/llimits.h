@@ -100,6 +100,12 @@ typedef lu_int32 Instruction;
 #endif
 
 
+/* number of chains moved per new string while the string table resizes */
+#ifndef STRREHASHSTEP
+#define STRREHASHSTEP	4
+#endif
+
+
 /* minimum size for string buffer */
 #ifndef LUA_MINBUFFER
 #define LUA_MINBUFFER	32
@@ -68,8 +68,42 @@ typedef union {
 ** Tagged Values
 */
 
+#if defined(LUA_NANBOXING)
+
+/*
+** NaN boxing: a TValue is a single 8-byte word. Numbers are stored as
+** plain doubles; every other value is a negative quiet NaN that has the
+** type tag in bits 47-50 and the payload (pointer or boolean) in bits
+** 0-46. Numeric NaNs keep their sign but are stored canonically so they
+** never look like a boxed value: positive ones as the quiet NaN 0x7FF8...,
+** negative ones as the signaling NaN 0xFFF4... (every negative quiet NaN
+** is in the boxed range).
+*/
+#if !defined(LUA_NUMBER_DOUBLE)
+#error "LUA_NANBOXING requires LUA_NUMBER_DOUBLE"
+#endif
+
+typedef unsigned long long lu_nanbits;
+
+#define NB_TAGSHIFT	47
+#define NB_PAYLOAD	((((lu_nanbits)1) << NB_TAGSHIFT) - 1)
+#define NB_BOXTAG	((lu_nanbits)0x1FFF)  /* sign, exponent and quiet bit */
+#define NB_SIGNBIT	(((lu_nanbits)1) << 63)
+#define NB_CANONNAN	(((lu_nanbits)0x7FF8) << 48)
+#define NB_CANONNEGNAN	(((lu_nanbits)0xFFF4) << 48)
+
+#define nbbox(t,p)	((NB_BOXTAG << 51) | (((lu_nanbits)(t)) << NB_TAGSHIFT) | (p))
+#define nbisboxed(o)	(((o)->v.u >> 51) == NB_BOXTAG)
+#define nbpayload(o)	((o)->v.u & NB_PAYLOAD)
+
+#define TValuefields	union { lu_nanbits u; lua_Number n; } v
+
+#else
+
 #define TValuefields	Value value; int tt
 
+#endif
+
 typedef struct lua_TValue {
   TValuefields;
 } TValue;
@@ -77,7 +111,11 @@ typedef struct lua_TValue {
 
 /* Macros to test type */
 #define ttisnil(o)	(ttype(o) == LUA_TNIL)
+#if defined(LUA_NANBOXING)
+#define ttisnumber(o)	(!nbisboxed(o))
+#else
 #define ttisnumber(o)	(ttype(o) == LUA_TNUMBER)
+#endif
 #define ttisstring(o)	(ttype(o) == LUA_TSTRING)
 #define ttistable(o)	(ttype(o) == LUA_TTABLE)
 #define ttisfunction(o)	(ttype(o) == LUA_TFUNCTION)
@@ -87,18 +125,29 @@ typedef struct lua_TValue {
 #define ttislightuserdata(o)	(ttype(o) == LUA_TLIGHTUSERDATA)
 
 /* Macros to access values */
+#if defined(LUA_NANBOXING)
+#define ttype(o)	(nbisboxed(o) ? cast_int(((o)->v.u >> NB_TAGSHIFT) & 0xF) \
+                                      : LUA_TNUMBER)
+#define rawgcvalue(o)	cast(GCObject *, cast(size_t, nbpayload(o)))
+#define pvalue(o)	check_exp(ttislightuserdata(o), \
+                                  cast(void *, cast(size_t, nbpayload(o))))
+#define nvalue(o)	check_exp(ttisnumber(o), (o)->v.n)
+#define bvalue(o)	check_exp(ttisboolean(o), cast_int(nbpayload(o)))
+#else
 #define ttype(o)	((o)->tt)
-#define gcvalue(o)	check_exp(iscollectable(o), (o)->value.gc)
+#define rawgcvalue(o)	((o)->value.gc)
 #define pvalue(o)	check_exp(ttislightuserdata(o), (o)->value.p)
 #define nvalue(o)	check_exp(ttisnumber(o), (o)->value.n)
-#define rawtsvalue(o)	check_exp(ttisstring(o), &(o)->value.gc->ts)
+#define bvalue(o)	check_exp(ttisboolean(o), (o)->value.b)
+#endif
+#define gcvalue(o)	check_exp(iscollectable(o), rawgcvalue(o))
+#define rawtsvalue(o)	check_exp(ttisstring(o), &rawgcvalue(o)->ts)
 #define tsvalue(o)	(&rawtsvalue(o)->tsv)
-#define rawuvalue(o)	check_exp(ttisuserdata(o), &(o)->value.gc->u)
+#define rawuvalue(o)	check_exp(ttisuserdata(o), &rawgcvalue(o)->u)
 #define uvalue(o)	(&rawuvalue(o)->uv)
-#define clvalue(o)	check_exp(ttisfunction(o), &(o)->value.gc->cl)
-#define hvalue(o)	check_exp(ttistable(o), &(o)->value.gc->h)
-#define bvalue(o)	check_exp(ttisboolean(o), (o)->value.b)
-#define thvalue(o)	check_exp(ttisthread(o), &(o)->value.gc->th)
+#define clvalue(o)	check_exp(ttisfunction(o), &rawgcvalue(o)->cl)
+#define hvalue(o)	check_exp(ttistable(o), &rawgcvalue(o)->h)
+#define thvalue(o)	check_exp(ttisthread(o), &rawgcvalue(o)->th)
 
 #define l_isfalse(o)	(ttisnil(o) || (ttisboolean(o) && bvalue(o) == 0))
 
@@ -106,14 +155,61 @@ typedef struct lua_TValue {
 ** for internal debug only
 */
 #define checkconsistency(obj) \
-  lua_assert(!iscollectable(obj) || (ttype(obj) == (obj)->value.gc->gch.tt))
+  lua_assert(!iscollectable(obj) || (ttype(obj) == rawgcvalue(obj)->gch.tt))
 
 #define checkliveness(g,obj) \
   lua_assert(!iscollectable(obj) || \
-  ((ttype(obj) == (obj)->value.gc->gch.tt) && !isdead(g, (obj)->value.gc)))
+  ((ttype(obj) == rawgcvalue(obj)->gch.tt) && !isdead(g, rawgcvalue(obj))))
 
 
 /* Macros to set values */
+#if defined(LUA_NANBOXING)
+
+#define NILCONSTANT	{nbbox(LUA_TNIL, 0)}
+
+#define setnilvalue(obj) ((obj)->v.u=nbbox(LUA_TNIL, 0))
+
+#define setnvalue(obj,x) \
+  { TValue *i_o=(obj); i_o->v.n=(x); \
+    if (luai_numisnan(i_o->v.n)) \
+      i_o->v.u=(i_o->v.u & NB_SIGNBIT) ? NB_CANONNEGNAN : NB_CANONNAN; }
+
+#define setpvalue(obj,x) \
+  { TValue *i_o=(obj); \
+    i_o->v.u=nbbox(LUA_TLIGHTUSERDATA, cast(lu_nanbits, cast(size_t, (x)))); \
+    lua_assert(pvalue(i_o) == (x)); }
+
+#define setbvalue(obj,x) \
+  { TValue *i_o=(obj); \
+    i_o->v.u=nbbox(LUA_TBOOLEAN, cast(lu_nanbits, cast(unsigned int, (x)))); }
+
+#define setgcvalue(L,obj,x,t) \
+  { TValue *i_o=(obj); \
+    i_o->v.u=nbbox(t, cast(lu_nanbits, cast(size_t, (x)))); \
+    checkliveness(G(L),i_o); }
+
+#define setsvalue(L,obj,x)	setgcvalue(L,obj,x,LUA_TSTRING)
+#define setuvalue(L,obj,x)	setgcvalue(L,obj,x,LUA_TUSERDATA)
+#define setthvalue(L,obj,x)	setgcvalue(L,obj,x,LUA_TTHREAD)
+#define setclvalue(L,obj,x)	setgcvalue(L,obj,x,LUA_TFUNCTION)
+#define sethvalue(L,obj,x)	setgcvalue(L,obj,x,LUA_TTABLE)
+#define setptvalue(L,obj,x)	setgcvalue(L,obj,x,LUA_TPROTO)
+
+#define setobj(L,obj1,obj2) \
+  { const TValue *o2=(obj2); TValue *o1=(obj1); \
+    o1->v.u = o2->v.u; \
+    checkliveness(G(L),o1); }
+
+/* copy a value into the key of a node (keeps its `next' field) */
+#define setnodekey(k,obj)	((k)->v.u = (obj)->v.u)
+
+#define setttype(obj, tt) \
+  ((obj)->v.u = nbbox(tt, nbpayload(obj)))
+
+#else
+
+#define NILCONSTANT	{NULL}, LUA_TNIL
+
 #define setnilvalue(obj) ((obj)->tt=LUA_TNIL)
 
 #define setnvalue(obj,x) \
@@ -163,6 +259,14 @@ typedef struct lua_TValue {
     o1->value = o2->value; o1->tt=o2->tt; \
     checkliveness(G(L),o1); }
 
+/* copy a value into the key of a node (keeps its `next' field) */
+#define setnodekey(k,obj) \
+  { (k)->value = (obj)->value; (k)->tt = (obj)->tt; }
+
+#define setttype(obj, tt) (ttype(obj) = (tt))
+
+#endif
+
 
 /*
 ** different types of sets, according to destination
@@ -183,8 +287,6 @@ typedef struct lua_TValue {
 #define setobj2n	setobj
 #define setsvalue2n	setsvalue
 
-#define setttype(obj, tt) (ttype(obj) = (tt))
-
 
 #define iscollectable(o)	(ttype(o) >= LUA_TSTRING)
 
@@ -250,6 +352,10 @@ typedef struct Proto {
   lu_byte numparams;
   lu_byte is_vararg;
   lu_byte maxstacksize;
+#if defined(LUA_USE_JIT)
+  void *jitcode;  /* compiled code (NULL if not compiled) */
+  int jitcalls;  /* calls so far (-1 if it cannot be compiled) */
+#endif
 } Proto;
 
 
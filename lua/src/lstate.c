@@ -16,6 +16,7 @@
 #include "ldo.h"
 #include "lfunc.h"
 #include "lgc.h"
+#include "ljit.h"
 #include "llex.h"
 #include "lmem.h"
 #include "lstate.h"
@@ -109,8 +110,13 @@ static void close_state (lua_State *L) {
   lua_assert(g->rootgc == obj2gco(L));
   lua_assert(g->strt.nuse == 0);
   luaM_freearray(L, G(L)->strt.hash, G(L)->strt.size, TString *);
+  luaM_freearray(L, G(L)->strt.oldhash, G(L)->strt.oldsize, TString *);
+  luaM_freearray(L, G(L)->strt.young, G(L)->strt.sizeyoung, int);
   luaZ_freebuffer(L, &g->buff);
   freestack(L, L);
+#if defined(LUA_USE_JIT)
+  luaJ_close(L);  /* release compiled code */
+#endif
   lua_assert(g->totalbytes == sizeof(LG));
   (*g->frealloc)(g->ud, fromstate(L), state_size(LG), 0);
 }
@@ -163,6 +169,13 @@ LUA_API lua_State *lua_newstate (lua_Alloc f, void *ud) {
   g->strt.size = 0;
   g->strt.nuse = 0;
   g->strt.hash = NULL;
+  g->strt.young = NULL;
+  g->strt.nyoung = 0;
+  g->strt.sizeyoung = 0;
+  g->strt.oldhash = NULL;
+  g->strt.oldsize = 0;
+  g->strt.rehashpos = 0;
+  g->strt.rehashwork = 0;
   setnilvalue(registry(L));
   luaZ_initbuffer(L, &g->buff);
   g->panic = NULL;
@@ -178,6 +191,16 @@ LUA_API lua_State *lua_newstate (lua_Alloc f, void *ud) {
   g->gcpause = LUAI_GCPAUSE;
   g->gcstepmul = LUAI_GCMUL;
   g->gcdept = 0;
+  g->gckind = KGC_NORMAL;
+  g->gcminormul = LUAI_GCMINORMUL;
+  g->gcmajormul = LUAI_GCMAJORMUL;
+  g->lastmajormem = 0;
+#if defined(LUA_USE_JIT)
+  g->jitchunks = NULL;
+  g->jitthreshold = LUAI_JITTHRESHOLD;
+  g->jitcount = 0;
+  g->jiton = 0;
+#endif
   for (i=0; i<NUM_TAGS; i++) g->mt[i] = NULL;
   if (luaD_rawrunprotected(L, f_luaopen, NULL) != 0) {
     /* memory allocation error: free partial state */
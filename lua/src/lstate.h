@@ -39,6 +39,13 @@ typedef struct stringtable {
   GCObject **hash;
   lu_int32 nuse;  /* number of elements */
   int size;
+  int *young;  /* chains holding young strings (generational mode) */
+  int nyoung;  /* number of chains in `young' (-1 means all chains) */
+  int sizeyoung;
+  GCObject **oldhash;  /* table being emptied into `hash' by a resize */
+  int oldsize;
+  int rehashpos;  /* next chain of `oldhash' to move */
+  lu_int32 rehashwork;  /* strings moved since last LUA_GCSTRREHASH */
 } stringtable;
 
 
@@ -85,12 +92,22 @@ typedef struct global_State {
   lu_mem gcdept;  /* how much GC is `behind schedule' */
   int gcpause;  /* size of pause between successive GCs */
   int gcstepmul;  /* GC `granularity' */
+  lu_byte gckind;  /* kind of GC running (incremental or generational) */
+  int gcminormul;  /* young-generation size between minor collections */
+  int gcmajormul;  /* heap growth that triggers a major collection */
+  lu_mem lastmajormem;  /* heap size after last major collection */
   lua_CFunction panic;  /* to be called in unprotected errors */
   TValue l_registry;
   struct lua_State *mainthread;
   UpVal uvhead;  /* head of double-linked list of all open upvalues */
   struct Table *mt[NUM_TAGS];  /* metatables for basic types */
   TString *tmname[TM_N];  /* array with tag-method names */
+#if defined(LUA_USE_JIT)
+  void *jitchunks;  /* list of executable memory chunks */
+  int jitthreshold;  /* calls before a function is compiled */
+  int jitcount;  /* number of functions compiled */
+  lu_byte jiton;  /* true if the JIT compiler is enabled */
+#endif
 } global_State;
 
 
@@ -19,40 +19,135 @@
 
 
 
+/*
+** move the string at `*p' into chain `h' of `hash'; in generational mode
+** old strings go after the young ones of the chain, so that minor sweeps
+** can still stop at the first old string
+*/
+static void movestr (lua_State *L, GCObject **p, GCObject **hash, int h) {
+  stringtable *tb = &G(L)->strt;
+  GCObject *o = *p;
+  GCObject **q = &hash[h];
+  if (isgenerational(G(L))) {
+    if (isold(o)) {
+      while (*q != NULL && !isold(*q))  /* skip young strings */
+        q = &(*q)->gch.next;
+    }
+    else if (tb->nyoung >= 0 && (*q == NULL || isold(*q))) {
+      /* first young string in this chain; minor collections must sweep it */
+      luaM_growvector(L, tb->young, tb->nyoung, tb->sizeyoung, int, MAX_INT, "");
+      tb->young[tb->nyoung++] = h;
+    }
+  }
+  *p = o->gch.next;  /* unchain it from old list */
+  o->gch.next = *q;  /* chain it */
+  *q = o;
+}
+
+
+/*
+** move up to `n' chains of the table being resized into the new one
+*/
+void luaS_rehashstep (lua_State *L, int n) {
+  stringtable *tb = &G(L)->strt;
+  if (tb->oldhash == NULL || G(L)->gcstate == GCSsweepstring)
+    return;  /* nothing to move, or the GC is traversing both tables */
+  for (; n > 0 && tb->rehashpos < tb->oldsize; n--) {
+    GCObject **p = &tb->oldhash[tb->rehashpos];
+    GCObject *o;
+    int i = 0;
+    if (isgenerational(G(L)) && tb->nyoung >= 0) {
+      /* reserve `young' entries, so that moving the chain cannot fail */
+      for (o = *p; o != NULL && !isold(o); o = o->gch.next) i++;
+      if (tb->nyoung + i > tb->sizeyoung) {
+        i = (tb->nyoung + i > 2*tb->sizeyoung) ? tb->nyoung + i : 2*tb->sizeyoung;
+        luaM_reallocvector(L, tb->young, tb->sizeyoung, i, int);
+        tb->sizeyoung = i;
+      }
+    }
+    /* clear the new chains this is the first old chain to move into */
+    for (i = tb->rehashpos; i < tb->size; i += tb->oldsize)
+      tb->hash[i] = NULL;
+    while (*p != NULL) {
+      movestr(L, p, tb->hash, lmod(gco2ts(*p)->hash, tb->size));
+      tb->rehashwork++;
+    }
+    tb->rehashpos++;
+  }
+  if (tb->rehashpos >= tb->oldsize) {  /* old table is empty? */
+    int i, j = 0;
+    for (i = 0; i < tb->nyoung; i++)  /* forget its chains */
+      if (tb->young[i] < tb->size)
+        tb->young[j++] = tb->young[i];
+    tb->nyoung = j;
+    luaM_freearray(L, tb->oldhash, tb->oldsize, TString *);
+    tb->oldhash = NULL;
+    tb->oldsize = 0;
+    tb->rehashpos = 0;
+  }
+}
+
+
+/*
+** resize the string table; when growing, strings are moved to the new
+** table a few chains at a time (see luaS_rehashstep) and both tables are
+** used meanwhile; a shrink (from the GC sweep, which must not raise the
+** heap) moves them all at once and frees the old table right away
+*/
 void luaS_resize (lua_State *L, int newsize) {
   GCObject **newhash;
   stringtable *tb;
   int i;
   if (G(L)->gcstate == GCSsweepstring)
     return;  /* cannot resize during GC traverse */
-  newhash = luaM_newvector(L, newsize, GCObject *);
   tb = &G(L)->strt;
-  for (i=0; i<newsize; i++) newhash[i] = NULL;
-  /* rehash */
-  for (i=0; i<tb->size; i++) {
-    GCObject *p = tb->hash[i];
-    while (p) {  /* for each node in the list */
-      GCObject *next = p->gch.next;  /* save next */
-      unsigned int h = gco2ts(p)->hash;
-      int h1 = lmod(h, newsize);  /* new position */
-      lua_assert(cast_int(h%newsize) == lmod(h, newsize));
-      p->gch.next = newhash[h1];  /* chain it */
-      newhash[h1] = p;
-      p = next;
+  luaS_rehashstep(L, MAX_INT);  /* finish a previous resize */
+  newhash = luaM_newvector(L, newsize, GCObject *);
+  if (tb->size == 0) {  /* initial table? */
+    for (i=0; i<newsize; i++) newhash[i] = NULL;
+  }
+  else if (newsize < tb->size) {  /* shrink? */
+    for (i=0; i<newsize; i++) newhash[i] = NULL;
+    if (tb->nyoung > 0)
+      tb->nyoung = 0;  /* young chains are recorded again as they move */
+    for (i=0; i<tb->size; i++) {
+      GCObject **p = &tb->hash[i];
+      while (*p != NULL) {
+        movestr(L, p, newhash, lmod(gco2ts(*p)->hash, newsize));
+        tb->rehashwork++;
+      }
     }
+    luaM_freearray(L, tb->hash, tb->size, TString *);
+  }
+  else {
+    for (i=0; i<tb->nyoung; i++)  /* young chains now belong to `oldhash' */
+      tb->young[i] += newsize;
+    tb->oldhash = tb->hash;
+    tb->oldsize = tb->size;
+    tb->rehashpos = 0;
   }
-  luaM_freearray(L, tb->hash, tb->size, TString *);
-  tb->size = newsize;
   tb->hash = newhash;
+  tb->size = newsize;
 }
 
 
 static TString *newlstr (lua_State *L, const char *str, size_t l,
                                        unsigned int h) {
   TString *ts;
-  stringtable *tb;
+  stringtable *tb = &G(L)->strt;
+  int h1 = lmod(h, tb->size);
+  GCObject **chain;
   if (l+1 > (MAX_SIZET - sizeof(TString))/sizeof(char))
     luaM_toobig(L);
+  if (!luaS_chainready(tb, h1))  /* resizing? */
+    h1 = tb->size + lmod(h, tb->oldsize);  /* use chain of old table */
+  chain = luaS_chain(tb, h1);
+  if (isgenerational(G(L)) && tb->nyoung >= 0 &&
+      (*chain == NULL || isold(*chain))) {
+    /* first young string in this chain; minor collections must sweep it */
+    luaM_growvector(L, tb->young, tb->nyoung, tb->sizeyoung, int, MAX_INT, "");
+    tb->young[tb->nyoung++] = h1;
+  }
   ts = cast(TString *, luaM_malloc(L, (l+1)*sizeof(char)+sizeof(TString)));
   ts->tsv.len = l;
   ts->tsv.hash = h;
@@ -61,27 +156,19 @@ static TString *newlstr (lua_State *L, const char *str, size_t l,
   ts->tsv.reserved = 0;
   memcpy(ts+1, str, l*sizeof(char));
   ((char *)(ts+1))[l] = '\0';  /* ending 0 */
-  tb = &G(L)->strt;
-  h = lmod(h, tb->size);
-  ts->tsv.next = tb->hash[h];  /* chain new entry */
-  tb->hash[h] = obj2gco(ts);
+  ts->tsv.next = *chain;  /* chain new entry */
+  *chain = obj2gco(ts);
   tb->nuse++;
+  luaS_rehashstep(L, STRREHASHSTEP);
   if (tb->nuse > cast(lu_int32, tb->size) && tb->size <= MAX_INT/2)
     luaS_resize(L, tb->size*2);  /* too crowded */
   return ts;
 }
 
 
-TString *luaS_newlstr (lua_State *L, const char *str, size_t l) {
-  GCObject *o;
-  unsigned int h = cast(unsigned int, l);  /* seed */
-  size_t step = (l>>5)+1;  /* if string is too long, don't hash all its chars */
-  size_t l1;
-  for (l1=l; l1>=step; l1-=step)  /* compute hash */
-    h = h ^ ((h<<5)+(h>>2)+cast(unsigned char, str[l1-1]));
-  for (o = G(L)->strt.hash[lmod(h, G(L)->strt.size)];
-       o != NULL;
-       o = o->gch.next) {
+static TString *findstr (lua_State *L, GCObject *o, const char *str,
+                                       size_t l) {
+  for (; o != NULL; o = o->gch.next) {
     TString *ts = rawgco2ts(o);
     if (ts->tsv.len == l && (memcmp(str, getstr(ts), l) == 0)) {
       /* string may be dead */
@@ -89,6 +176,28 @@ TString *luaS_newlstr (lua_State *L, const char *str, size_t l) {
       return ts;
     }
   }
+  return NULL;
+}
+
+
+TString *luaS_newlstr (lua_State *L, const char *str, size_t l) {
+  stringtable *tb = &G(L)->strt;
+  TString *ts;
+  unsigned int h = cast(unsigned int, l);  /* seed */
+  size_t step = (l>>5)+1;  /* if string is too long, don't hash all its chars */
+  size_t l1;
+  int h1;
+  for (l1=l; l1>=step; l1-=step)  /* compute hash */
+    h = h ^ ((h<<5)+(h>>2)+cast(unsigned char, str[l1-1]));
+  h1 = lmod(h, tb->size);
+  ts = luaS_chainready(tb, h1) ? findstr(L, tb->hash[h1], str, l) : NULL;
+  if (ts == NULL && tb->oldhash != NULL) {  /* resizing? */
+    h1 = lmod(h, tb->oldsize);
+    if (h1 >= tb->rehashpos)  /* chain not moved yet? */
+      ts = findstr(L, tb->oldhash[h1], str, l);
+  }
+  if (ts != NULL)
+    return ts;
   return newlstr(L, str, l, h);  /* not found */
 }
 
@@ -23,7 +23,18 @@
 
 #define luaS_fix(s)	l_setbit((s)->tsv.marked, FIXEDBIT)
 
+/*
+** while the string table is resized, chains numbered from `size' on are
+** those of `oldhash'; a chain of the new table is cleared (and used) only
+** when the first old chain moving into it is moved
+*/
+#define luaS_chain(tb,i)	((i) < (tb)->size ? &(tb)->hash[i] : \
+                                 &(tb)->oldhash[(i) - (tb)->size])
+#define luaS_chainready(tb,i)	((tb)->oldhash == NULL || \
+                                 lmod(i, (tb)->oldsize) < (tb)->rehashpos)
+
 LUAI_FUNC void luaS_resize (lua_State *L, int newsize);
+LUAI_FUNC void luaS_rehashstep (lua_State *L, int n);
 LUAI_FUNC Udata *luaS_newudata (lua_State *L, size_t s, Table *e);
 LUAI_FUNC TString *luaS_newlstr (lua_State *L, const char *str, size_t l);
 
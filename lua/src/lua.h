@@ -225,10 +225,28 @@ LUA_API int  (lua_status) (lua_State *L);
 #define LUA_GCSTEP		5
 #define LUA_GCSETPAUSE		6
 #define LUA_GCSETSTEPMUL	7
+#define LUA_GCGEN		8
+#define LUA_GCINC		9
+#define LUA_GCSETMINORMUL	10
+#define LUA_GCSETMAJORMUL	11
+#define LUA_GCSTRREHASH		12
 
 LUA_API int (lua_gc) (lua_State *L, int what, int data);
 
 
+/*
+** JIT compiler function and options (the compiler is only available when
+** the core is built with LUA_USE_JIT; otherwise 'lua_jit' returns -1)
+*/
+
+#define LUA_JITSTOP		0
+#define LUA_JITRESTART		1
+#define LUA_JITTHRESHOLD	2
+#define LUA_JITCOUNT		3
+
+LUA_API int (lua_jit) (lua_State *L, int what, int data);
+
+
 /*
 ** miscellaneous functions
 */
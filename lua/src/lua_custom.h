@@ -3,6 +3,6 @@
 #define lua_custom_h
 
 typedef void (*lua_print_callback_func)(lua_State* L, const char* text);
-extern lua_print_callback_func lua_print_callback;
+LUA_EXTERN lua_print_callback_func lua_print_callback;
 
 #endif // lua_custom_h
\ No newline at end of file
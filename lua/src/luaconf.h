@@ -150,18 +150,27 @@
 ** For instance, if you want to create one Windows DLL with the core and
 ** the libraries, you may want to use the following definition (define
 ** LUA_BUILD_AS_DLL to get it).
+** LUA_EXTERN gives them C linkage also when the core is compiled as C++
+** (to use exceptions instead of long jumps, see LUAI_THROW), so C and C++
+** builds of the core can be linked against the same code.
 */
+#if defined(__cplusplus)
+#define LUA_EXTERN	extern "C"
+#else
+#define LUA_EXTERN	extern
+#endif
+
 #if defined(LUA_BUILD_AS_DLL)
 
 #if defined(LUA_CORE) || defined(LUA_LIB)
-#define LUA_API __declspec(dllexport)
+#define LUA_API LUA_EXTERN __declspec(dllexport)
 #else
-#define LUA_API __declspec(dllimport)
+#define LUA_API LUA_EXTERN __declspec(dllimport)
 #endif
 
 #else
 
-#define LUA_API		extern
+#define LUA_API		LUA_EXTERN
 
 #endif
 
@@ -313,6 +322,68 @@
 #define LUAI_GCMUL	200 /* GC runs 'twice the speed' of memory allocation */
 
 
+/*
+@@ LUAI_GCMINORMUL defines how much memory (as a percentage of the heap
+@* size after the last major collection) may be allocated between two
+@* minor collections when the collector runs in generational mode.
+@@ LUAI_GCMAJORMUL defines how much the heap may grow (as a percentage of
+@* its size after the last major collection) before the generational
+@* collector does a major (full) collection.
+** CHANGE them if your program keeps a large heap of long-lived objects
+** and allocates short-lived ones at a high rate. You can also change
+** these values dynamically (see LUA_GCSETMINORMUL/LUA_GCSETMAJORMUL).
+*/
+#define LUAI_GCMINORMUL	20   /* minor collection every 20% of heap allocated */
+#define LUAI_GCMAJORMUL	100  /* major collection when heap doubles */
+
+
+/*
+@@ LUAI_USE_COMPUTEDGOTO makes luaV_execute dispatch opcodes through a
+@* table of label addresses instead of a single 'switch'.
+** CHANGE it (define LUA_NOCOMPUTEDGOTO) if your compiler claims to be GCC
+** but does not support labels as values. Each opcode ends with its own
+** copy of the dispatch code, which gives the branch predictor one
+** indirect jump per opcode instead of a single shared one.
+*/
+#if defined(__GNUC__) && !defined(LUA_NOCOMPUTEDGOTO)
+#define LUAI_USE_COMPUTEDGOTO
+#endif
+
+
+/*
+@@ LUA_NANBOXING packs every TValue into a single 8-byte word.
+** CHANGE it (define it) to halve the size of stack slots, table nodes
+** and array parts on 64-bit machines. Numbers are stored as plain
+** doubles and all other values live in the payload of a quiet NaN, so
+** it requires LUA_NUMBER_DOUBLE and user-space pointers that fit in
+** 47 bits (true for current x86-64 and ARM64 systems). Light userdata
+** above that range is truncated. Precompiled chunks are unaffected.
+*/
+/* #define LUA_NANBOXING */
+
+
+/*
+@@ LUA_USE_JIT builds the baseline JIT in ljit.c, which translates the
+@* bytecode of hot Lua functions to x86-64 machine code.
+** CHANGE it (define it) to get the JIT. It is only built on x86-64 Unix
+** systems with a GCC-compatible compiler and the default value
+** representation; elsewhere the option is ignored. Even when built, the
+** JIT stays off until enabled with 'lua_jit'.
+@@ LUAI_JITTHRESHOLD is the default number of calls after which a
+@* function is compiled.
+@@ LUAI_JITMAXCCALLS limits how deeply compiled functions may nest on
+@* the C stack (calls from compiled code run through a C helper).
+*/
+/* #define LUA_USE_JIT */
+#if defined(LUA_USE_JIT) && !(defined(__x86_64__) && defined(__GNUC__) && \
+    defined(__unix__) && !defined(LUA_NANBOXING))
+#undef LUA_USE_JIT
+#endif
+
+#define LUAI_JITTHRESHOLD	50
+#define LUAI_JITMAXCCALLS	100
+
+
 
 /*
 @@ LUA_COMPAT_GETN controls compatibility with old getn behavior.
@@ -0,0 +1,66 @@
+-- opcode dispatch microbenchmark: times typical opcode mixes
+-- compare builds with and without LUA_NOCOMPUTEDGOTO
+
+local N = tonumber(arg and arg[1]) or 1
+
+-- numeric loop: FORLOOP, ADD, MUL, MOD, LT, JMP
+local function loops(n)
+  local s = 0
+  for i = 1, n do
+    local x = i * 3
+    if x % 7 < 3 then s = s + x else s = s - 1 end
+  end
+  return s
+end
+
+-- table access: NEWTABLE, SETTABLE, GETTABLE, LEN, SELF
+local function tables(n)
+  local t = {}
+  for i = 1, 1000 do t[i] = i end
+  local p = {x = 0, y = 0}
+  local s = 0
+  for j = 1, n / 1000 do
+    for i = 1, #t do
+      p.x = p.x + t[i]
+      p.y = p.x - p.y
+    end
+    s = s + p.y
+  end
+  return s
+end
+
+-- calls: CALL, RETURN, GETUPVAL, GETGLOBAL, TAILCALL
+local function add(a, b) return a + b end
+local function fib(n) if n < 2 then return n end return fib(n-1) + fib(n-2) end
+local function calls(n)
+  local s = 0
+  for i = 1, n do s = add(s, i) end
+  return s + fib(24)
+end
+
+-- string/closure mix: CLOSURE, CONCAT, MOVE, TEST
+local function mixed(n)
+  local s, k = 0, nil
+  for i = 1, n / 10 do
+    local f = function(a) return a and i or k end
+    if f(i) then s = s + #("a" .. i) end
+  end
+  return s
+end
+
+local benchmarks = {
+  {"loops", loops, 10000000},
+  {"tables", tables, 5000000},
+  {"calls", calls, 5000000},
+  {"mixed", mixed, 5000000},
+}
+
+local total = 0
+for _, b in ipairs(benchmarks) do
+  local start = os.clock()
+  b[2](b[3] * N)
+  local elapsed = os.clock() - start
+  total = total + elapsed
+  io.write(string.format("%-8s %8.3f s\n", b[1], elapsed))
+end
+io.write(string.format("%-8s %8.3f s\n", "total", total))
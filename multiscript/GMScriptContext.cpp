@@ -11,7 +11,8 @@ struct GMClassInfo;
 //-----------------------------------------------------------
 
 GMScriptContext::GMScriptContext() :
-	m_machine(NULL)
+	m_machine(NULL),
+	m_stringRehashWork(0)
 {}
 
 GMScriptContext::~GMScriptContext()
@@ -41,20 +42,35 @@ void GMScriptContext::CollectGarbage(bool full)
 	m_machine->CollectGarbage(full);
 }
 
+bool GMScriptContext::SetOption(ScriptContextOption option, int value)
+{
+	switch (option)
+	{
+		case ScriptContextOption_GcBackgroundFree:
+			return m_machine->SetBackgroundFree(value != 0);
+		default:
+			return false;
+	}
+}
+
+bool GMScriptContext::GetGcStats(ScriptGcStats& stats)
+{
+	stats.m_majorCollections = m_machine->GetStatsGCNumFullCollects() + m_machine->GetStatsGCNumIncCollects();
+	stats.m_heapSize = m_machine->GetCurrentMemoryUsage();
+	stats.m_stringCount = m_machine->GetStatsStringCount();
+	stats.m_stringTableSize = m_machine->GetStatsStringTableSize();
+	const int rehashWork = m_machine->GetStatsStringRehashWork();
+	stats.m_stringRehashWork = rehashWork - m_stringRehashWork;
+	m_stringRehashWork = rehashWork;
+	return true;
+}
+
 bool GMScriptContext::ExecuteString(const char* string)
 {
 	const int errors = m_machine->ExecuteString(string);
 	if (errors)
 	{
-		bool first = true;
-		const char* message;
-		while (message = m_machine->GetLog().GetEntry(first))
-		{
-			char buffer[1024];
-			MultiScriptSprintf(buffer, 1024, "%s\n", message);
-			m_logger->Output(buffer);
-		}
-		m_machine->GetLog().Reset();
+		FlushLog();
 		return false;
 	}
 
@@ -93,14 +109,22 @@ bool GMScriptContext::RegisterUserClass(ClassDesc* desc)
 	MultiScriptAssert(desc->m_constructor);
 	MultiScriptAssert(desc->m_destructor);
 
+	desc->AssignTypeId();
+
 	// Create class info
 	GMClassInfo* classInfo = new GMClassInfo();
 	classInfo->m_desc = desc;
 	classInfo->m_context = this;
 	classInfo->m_gmTypeId = m_machine->CreateUserType(desc->m_name);
 
+	// Resolve inherited methods once so that the type library holds the whole flat method table
+	desc->GetAllMethods(classInfo->m_methods);
+	desc->GetAllOperators(classInfo->m_operators);
+	desc->GetAllFields(classInfo->m_fields);
+	classInfo->m_toStringMethod = desc->GetToStringMethod();
+
 	// Create info for each method
-	for (unsigned int i = 0; i < desc->m_methods.size(); ++i)
+	for (unsigned int i = 0; i < classInfo->m_methods.size(); ++i)
 	{
 		GMMethodInfo methodInfo;
 		methodInfo.m_classInfo = classInfo;
@@ -109,10 +133,10 @@ bool GMScriptContext::RegisterUserClass(ClassDesc* desc)
 	}
 
 	// Create an array of methods
-	for (unsigned int i = 0; i < desc->m_methods.size(); ++i)
+	for (unsigned int i = 0; i < classInfo->m_methods.size(); ++i)
 	{
 		gmFunctionEntry functionEntry;
-		functionEntry.m_name = desc->m_methods[i].m_name;
+		functionEntry.m_name = classInfo->m_methods[i].m_name;
 		functionEntry.m_function = GMClassMethodCallback;
 		functionEntry.m_userData = &classInfo->m_methodInfos[i];
 		classInfo->m_gmMethods.push_back(functionEntry);
@@ -142,6 +166,55 @@ bool GMScriptContext::RegisterUserClass(ClassDesc* desc)
 		&classInfo->m_gmMethods[0],
 		(int) classInfo->m_gmMethods.size());
 
+	// Register operators; there are no length and call operators in GM
+	static const struct
+	{
+		ClassOperator m_operator;
+		gmOperator m_gmOperator;
+		bool m_negateResult;
+	} operatorBindings[] =
+	{
+		{ClassOperator_Add, O_ADD, false},
+		{ClassOperator_Sub, O_SUB, false},
+		{ClassOperator_Mul, O_MUL, false},
+		{ClassOperator_Eq, O_EQ, false},
+		{ClassOperator_Eq, O_NEQ, true},
+		{ClassOperator_Lt, O_LT, false},
+		{ClassOperator_Index, O_GETIND, false},
+		{ClassOperator_NewIndex, O_SETIND, false}
+	};
+	const int numOperatorBindings = sizeof(operatorBindings) / sizeof(operatorBindings[0]);
+
+	for (int i = 0; i < numOperatorBindings; ++i)
+		if (classInfo->m_operators[operatorBindings[i].m_operator])
+		{
+			GMOperatorInfo operatorInfo;
+			operatorInfo.m_classInfo = classInfo;
+			operatorInfo.m_operator = operatorBindings[i].m_operator;
+			operatorInfo.m_negateResult = operatorBindings[i].m_negateResult;
+			classInfo->m_operatorInfos.push_back(operatorInfo);
+		}
+
+	for (unsigned int i = 0, j = 0; i < classInfo->m_operatorInfos.size(); ++j)
+		if (classInfo->m_operators[operatorBindings[j].m_operator])
+		{
+			// Operator functions aren't referenced from any gm object so keep them alive explicitly
+			gmFunctionObject* function = m_machine->AllocFunctionObject(GMClassOperatorCallback);
+			function->m_cUserData = &classInfo->m_operatorInfos[i++];
+			m_machine->AddCPPOwnedGMObject(function);
+			m_machine->RegisterTypeOperator(classInfo->m_gmTypeId, operatorBindings[j].m_gmOperator, function);
+		}
+
+	// Register fields; these are accessed via native get-dot and set-dot operators which don't need any stack frame
+	if (classInfo->m_fields.size())
+	{
+		for (unsigned int i = 0; i < classInfo->m_fields.size(); ++i)
+			classInfo->m_gmFieldNames.push_back(m_machine->AllocPermanantStringObject(classInfo->m_fields[i].m_name)->GetRef());
+
+		m_machine->RegisterTypeOperator(classInfo->m_gmTypeId, O_GETDOT, NULL, GMClassGetDotOperator);
+		m_machine->RegisterTypeOperator(classInfo->m_gmTypeId, O_SETDOT, NULL, GMClassSetDotOperator);
+	}
+
 	// Register GC callbacks and to-string method
 	m_machine->RegisterUserCallbacks(
 		classInfo->m_gmTypeId,
@@ -151,6 +224,11 @@ bool GMScriptContext::RegisterUserClass(ClassDesc* desc)
 
 	// Add class info
 	m_classes.push_back(classInfo);
+
+	const unsigned int typeIndex = classInfo->m_gmTypeId - GM_USER;
+	if (typeIndex >= m_classesByType.size())
+		m_classesByType.resize(typeIndex + 1, NULL);
+	m_classesByType[typeIndex] = classInfo;
 	return true;
 }
 
@@ -162,6 +240,115 @@ GMClassInfo* GMScriptContext::FindClassInfo(ClassDesc* classDesc)
 	return NULL;
 }
 
+GMClassInfo* GMScriptContext::FindClassInfo(gmType type)
+{
+	const unsigned int typeIndex = type - GM_USER;
+	return typeIndex < m_classesByType.size() ? m_classesByType[typeIndex] : NULL;
+}
+
+void GMScriptContext::FlushLog()
+{
+	bool first = true;
+	const char* message;
+	while (message = m_machine->GetLog().GetEntry(first))
+	{
+		if (!m_logger)
+			continue;
+		char buffer[1024];
+		MultiScriptSprintf(buffer, 1024, "%s\n", message);
+		m_logger->Output(buffer);
+	}
+	m_machine->GetLog().Reset();
+}
+
+int GMScriptContext::InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args, int numArgs, bool* results)
+{
+	// Method name is only needed for lookups, so it's kept alive just for the duration of the call
+	gmStringObject* methodNameObject = m_machine->AllocStringObject(methodName);
+	m_machine->AddCPPOwnedGMObject(methodNameObject);
+	gmVariable methodNameVar;
+	methodNameVar.SetString(methodNameObject);
+
+	GMClassInfo* currentClass = NULL;
+	gmFunctionObject* method = NULL;
+	gmThread* thread = NULL;
+	int numSucceeded = 0;
+	for (int i = 0; i < numObjects; ++i)
+	{
+		bool succeeded = false;
+		GMScriptObject* scriptObject = (GMScriptObject*) objects[i];
+		if (scriptObject && scriptObject->m_objectPtr)
+		{
+			// Objects are usually grouped by class, so method is only looked up when class changes
+			if (scriptObject->m_classInfo != currentClass)
+			{
+				currentClass = scriptObject->m_classInfo;
+
+				// Class methods take precedence over global functions called with object as 'this'
+				gmVariable function = m_machine->GetTypeVariable(currentClass->m_gmTypeId, methodNameVar);
+				if (function.m_type != GM_FUNCTION)
+					function = m_machine->GetGlobals()->Get(methodNameVar);
+				method = (function.m_type == GM_FUNCTION) ? (gmFunctionObject*) GM_MOBJECT(m_machine, function.m_value.m_ref) : NULL;
+
+				if (!method && m_logger)
+					m_logger->Output("Method '%s' not found in class '%s'\n", methodName, currentClass->m_desc->m_name);
+			}
+
+			if (method)
+			{
+				// All calls run on one thread that survives returns from its base function
+				if (!thread)
+				{
+					thread = m_machine->CreateThread();
+					thread->Sys_SetReusable(true);
+				}
+				thread->Touch(2 + numArgs);
+				thread->Push(gmVariable(scriptObject->m_gmUserObject));
+				thread->PushFunction(method);
+				for (int j = 0; j < numArgs; ++j)
+					thread->PushInt(args[j]);
+
+				gmThread::State state = thread->PushStackFrame(numArgs);
+				if (state == gmThread::RUNNING)
+					state = thread->Sys_Execute();
+				else if (state == gmThread::KILLED || state == gmThread::SYS_EXCEPTION)
+					m_machine->Sys_SwitchState(thread, gmThread::KILLED); // Native method failed or killed its thread
+
+				switch (state)
+				{
+				case gmThread::SYS_RETURN:
+					thread->Pop(); // Discard return value
+					succeeded = true;
+					break;
+				case gmThread::RUNNING:
+				case gmThread::SLEEPING:
+				case gmThread::BLOCKED:
+					// Method yielded, slept or blocked without failing; the machine finishes and kills its thread
+					thread->Sys_SetReusable(false);
+					thread = NULL;
+					succeeded = true;
+					break;
+				default:
+					// Thread was killed (exception or exit) or kept for the debugger without the method returning
+					thread = NULL;
+					FlushLog();
+					break;
+				}
+			}
+		}
+
+		if (results)
+			results[i] = succeeded;
+		if (succeeded)
+			numSucceeded++;
+	}
+
+	if (thread)
+		m_machine->Sys_SwitchState(thread, gmThread::KILLED);
+	m_machine->RemoveCPPOwnedGMObject(methodNameObject);
+	return numSucceeded;
+}
+
 void GMScriptContext::GMPrintCallback(gmMachine* machine, const char* string)
 {
 	GMScriptContext* context = (GMScriptContext*) machine->GetUserData();
@@ -233,16 +420,16 @@ int GMScriptContext::GMClassToStringMethodCallback(gmThread* thread)
 	GMClassInfo* classInfo = scriptObject->m_classInfo;
 
 	char buffer[1 << 8];
-	if (classInfo->m_desc->m_toStringMethod)
+	if (classInfo->m_toStringMethod)
 	{
 		GMScriptStack stack(thread);
-		const bool result = classInfo->m_desc->m_toStringMethod(scriptObject, buffer, 1 << 8);
+		const bool result = classInfo->m_toStringMethod(scriptObject, buffer, 1 << 8);
 		MultiScriptAssert( result );
 	}
 	else
 		MultiScriptSprintf(buffer, 1 << 8, "[%s]", classInfo->m_desc->m_name);
 
-	thread->PushNewString(buffer, 1 << 8);
+	thread->PushNewString(buffer);
 
 	return GM_OK;
 }
@@ -254,9 +441,9 @@ void GMScriptContext::GMClassToStringCallback(gmUserObject* object, char* buffer
 
 	GMClassInfo* classInfo = scriptObject->m_classInfo;
 
-	if (classInfo->m_desc->m_toStringMethod)
+	if (classInfo->m_toStringMethod)
 	{
-		const bool result = classInfo->m_desc->m_toStringMethod(scriptObject, buffer, bufferSize);
+		const bool result = classInfo->m_toStringMethod(scriptObject, buffer, bufferSize);
 		MultiScriptAssert( result );
 	}
 	else
@@ -271,12 +458,105 @@ int GMScriptContext::GMClassMethodCallback(gmThread* thread)
 	MultiScriptAssert( scriptObject->m_objectPtr );
 
 	GMScriptStack stack(thread);
-	const bool result = methodInfo->m_classInfo->m_desc->m_methods[methodInfo->m_methodIndex].m_method(scriptObject, &stack);
+	const bool result = methodInfo->m_classInfo->m_methods[methodInfo->m_methodIndex].m_method(scriptObject, &stack);
 	MultiScriptAssert( result );
 
 	return GM_OK;
 }
 
+int GMScriptContext::GMClassOperatorCallback(gmThread* thread)
+{
+	GMOperatorInfo* operatorInfo = (GMOperatorInfo*) thread->GetFunctionObject()->m_cUserData;
+	GMScriptContext* context = (GMScriptContext*) thread->GetMachine()->GetUserData();
+
+	// Binary operators are dispatched on the greater type of both operands so use the left operand's class
+	GMClassInfo* classInfo = context->FindClassInfo(thread->ParamType(0));
+	if (!classInfo || !classInfo->m_operators[operatorInfo->m_operator])
+	{
+		thread->GetMachine()->GetLog().LogEntry("left operand is required to be an object of class %s", operatorInfo->m_classInfo->m_desc->m_name);
+		return GM_EXCEPTION;
+	}
+
+	gmUserObject* userObject = NULL;
+	thread->ParamUserObject(0, userObject);
+	GMScriptObject* scriptObject = (GMScriptObject*) userObject->m_user;
+	MultiScriptAssert( scriptObject->m_objectPtr );
+
+	// Operands are passed as parameters; hide the left one
+	GMScriptStack stack(thread, NULL, 1);
+	const bool result = classInfo->m_operators[operatorInfo->m_operator](scriptObject, &stack);
+	MultiScriptAssert( result );
+
+	if (operatorInfo->m_negateResult)
+	{
+		MultiScriptAssert( thread->GetTop()[-1].m_type == GM_INT );
+		const int isEqual = thread->Pop().m_value.m_int;
+		thread->PushInt(!isEqual);
+	}
+
+	return GM_OK;
+}
+
+int GMScriptContext::FindField(GMClassInfo* classInfo, gmptr name)
+{
+	// Strings are interned so comparing references is enough
+	for (unsigned int i = 0; i < classInfo->m_gmFieldNames.size(); ++i)
+		if (classInfo->m_gmFieldNames[i] == name)
+			return i;
+	return -1;
+}
+
+void GM_CDECL GMScriptContext::GMClassGetDotOperator(gmThread* thread, gmVariable* operands)
+{
+	gmMachine* machine = thread->GetMachine();
+	GMClassInfo* classInfo = ((GMScriptContext*) machine->GetUserData())->FindClassInfo(operands[0].m_type);
+
+	const int fieldIndex = FindField(classInfo, operands[1].m_value.m_ref);
+	if (fieldIndex == -1)
+	{
+		// Not a field; let the machine look up the method
+		operands[0].Nullify();
+		return;
+	}
+
+	const ClassFieldDesc& field = classInfo->m_fields[fieldIndex];
+
+	GMScriptObject* scriptObject = (GMScriptObject*) ((gmUserObject*) GM_MOBJECT(machine, operands[0].m_value.m_ref))->m_user;
+	MultiScriptAssert( scriptObject->m_objectPtr );
+	void* fieldPtr = field.GetFieldPtr(scriptObject->m_objectPtr);
+
+	switch (field.m_type)
+	{
+		case ClassFieldType_Int: operands[0].SetInt(*(int*) fieldPtr); break;
+		case ClassFieldType_Float: operands[0].SetFloat(*(float*) fieldPtr); break;
+		case ClassFieldType_Bool: operands[0].SetInt(*(bool*) fieldPtr ? 1 : 0); break;
+	}
+}
+
+void GM_CDECL GMScriptContext::GMClassSetDotOperator(gmThread* thread, gmVariable* operands)
+{
+	gmMachine* machine = thread->GetMachine();
+	GMClassInfo* classInfo = ((GMScriptContext*) machine->GetUserData())->FindClassInfo(operands[0].m_type);
+
+	// Native operators can't raise exceptions so setting unknown member is ignored
+	const int fieldIndex = FindField(classInfo, operands[2].m_value.m_ref);
+	if (fieldIndex == -1)
+		return;
+
+	const ClassFieldDesc& field = classInfo->m_fields[fieldIndex];
+
+	GMScriptObject* scriptObject = (GMScriptObject*) ((gmUserObject*) GM_MOBJECT(machine, operands[0].m_value.m_ref))->m_user;
+	MultiScriptAssert( scriptObject->m_objectPtr );
+	void* fieldPtr = field.GetFieldPtr(scriptObject->m_objectPtr);
+
+	switch (field.m_type)
+	{
+		case ClassFieldType_Int: *(int*) fieldPtr = operands[1].GetIntSafe(); break;
+		case ClassFieldType_Float: *(float*) fieldPtr = operands[1].GetFloatSafe(); break;
+		case ClassFieldType_Bool: *(bool*) fieldPtr = operands[1].GetIntSafe() != 0; break;
+	}
+}
+
 int GMScriptContext::GMFunctionCallback(gmThread* thread)
 {
 	GMFunctionInfo* info = (GMFunctionInfo*) thread->GetFunctionObject()->m_cUserData;
@@ -37,12 +37,25 @@ struct GMMethodInfo
 	int m_methodIndex;
 };
 
+struct GMOperatorInfo
+{
+	GMClassInfo* m_classInfo;
+	ClassOperator m_operator;
+	bool m_negateResult; //!< Used to implement inequality via equality operator
+};
+
 struct GMClassInfo
 {
 	ScriptContext* m_context;
 	ClassDesc* m_desc;
 
+	vector<ClassMethodDesc> m_methods; //!< Flattened methods of the class and all of its super classes
 	vector<GMMethodInfo> m_methodInfos;
+	GenericClassMethod m_operators[ClassOperator_Count]; //!< Overloaded operators of the class and all of its super classes
+	vector<GMOperatorInfo> m_operatorInfos;
+	vector<ClassFieldDesc> m_fields; //!< Flattened fields of the class and all of its super classes
+	vector<gmptr> m_gmFieldNames; //!< References to interned field names; field lookup only compares these
+	GenericClassToStringMethod m_toStringMethod; //!< To-string method of the class or of its nearest super class that has one
 
 	gmType m_gmTypeId;
 	vector<gmFunctionEntry> m_gmMethods;
@@ -52,10 +65,13 @@ struct GMClassInfo
 class GMScriptContext : public ScriptContext
 {
 	friend class GMScriptStack;
+	friend class GMScriptTableView;
 private:
 	gmMachine* m_machine;
 	std::vector<GMFunctionInfo*> m_functions;
 	std::vector<GMClassInfo*> m_classes;
+	std::vector<GMClassInfo*> m_classesByType; //!< Registered classes indexed by their gm type id (offset by GM_USER)
+	int m_stringRehashWork; //!< String intern table rehash work already reported by GetGcStats()
 
 	GMScriptContext();
 	~GMScriptContext();
@@ -65,14 +81,19 @@ public:
 
 	void SetLogger(ScriptLogger* logger);
 	void CollectGarbage(bool full);
+	bool SetOption(ScriptContextOption option, int value);
+	bool GetGcStats(ScriptGcStats& stats);
 	bool ExecuteString(const char* string);
 	ScriptStack* BeginCall(FunctionDesc* desc);
 	ScriptStack* BeginCall(const char* name);
 	bool RegisterFunction(FunctionDesc* desc);
 	bool RegisterUserClass(ClassDesc* desc);
+	int InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args, int numArgs, bool* results);
 
 protected:
 	GMClassInfo* FindClassInfo(ClassDesc* classDesc);
+	GMClassInfo* FindClassInfo(gmType type);
+	void FlushLog();
 
 	static void GMPrintCallback(gmMachine* machine, const char* string);
 	static bool GMClassTraceCallback(gmMachine* machine, gmUserObject* object, gmGarbageCollector* gc, const int workLeftToGo, int& workDone);
@@ -82,5 +103,9 @@ protected:
 	static int GMClassToStringMethodCallback(gmThread* thread);
 	static void GMClassToStringCallback(gmUserObject* object, char* buffer, int bufferSize);
 	static int GMClassMethodCallback(gmThread* thread);
+	static int GMClassOperatorCallback(gmThread* thread);
+	static int FindField(GMClassInfo* classInfo, gmptr name);
+	static void GM_CDECL GMClassGetDotOperator(gmThread* thread, gmVariable* operands);
+	static void GM_CDECL GMClassSetDotOperator(gmThread* thread, gmVariable* operands);
 	static int GMFunctionCallback(gmThread* thread);
 };
\ No newline at end of file
@@ -6,13 +6,15 @@
 #include "GMScriptContext.h"
 #include "GMScriptStack.h"
 
-GMScriptStack::GMScriptStack(gmThread* thread, gmCall* call) :
+GMScriptStack::GMScriptStack(gmThread* thread, gmCall* call, int firstParam) :
 	m_thread(thread),
+	m_firstParam(firstParam),
 	m_numPopped(0),
 	m_numPushed(0),
 	m_call(call)
 {
-	m_numParams = m_call ? 0 : m_thread->GetNumParams();
+	m_numParams = m_call ? 0 : (m_thread->GetNumParams() - m_firstParam);
+	m_context = (GMScriptContext*) (m_call ? m_call->GetThread() : m_thread)->GetMachine()->GetUserData();
 }
 
 GMScriptStack::~GMScriptStack()
@@ -35,7 +37,7 @@ bool GMScriptStack::PopInt(int& value)
 		if (!m_call->GetReturnedInt(value))
 			return false;
 	}
-	else if (!m_thread->ParamInt(m_numParams - m_numPopped - 1, value, 0))
+	else if (!m_thread->ParamInt(m_firstParam + m_numParams - m_numPopped - 1, value, 0))
 		return false;
 	
 	m_numPopped++;
@@ -44,22 +46,50 @@ bool GMScriptStack::PopInt(int& value)
 
 ScriptObject* GMScriptStack::PopScriptObject()
 {
-	if (m_numPopped == m_numParams) return false;
+	if (m_numPopped == m_numParams) return NULL;
 
 	gmUserObject* userObject = NULL;
 	if (m_call)
 	{
 		const gmVariable& variable = m_call->GetReturnedVariable();
-		if (variable.m_type != GM_USER) return false;
+		if (variable.m_type < GM_USER) return NULL;
 		userObject = (gmUserObject*) variable.m_value.m_ref;
 	}
-	else if (!m_thread->ParamUserObject(m_numParams - m_numPopped - 1, userObject))
-		return false;
+	else if (!m_thread->ParamUserObject(m_firstParam + m_numParams - m_numPopped - 1, userObject))
+		return NULL;
 
 	m_numPopped++;
 	return (ScriptObject*) userObject->m_user;
 }
 
+ScriptObject* GMScriptStack::PopScriptObject(ClassDesc* expected)
+{
+	if (m_numPopped == m_numParams) return NULL;
+
+	const gmType type = m_call ? m_call->GetReturnedVariable().m_type : m_thread->ParamType(m_firstParam + m_numParams - m_numPopped - 1);
+	GMClassInfo* classInfo = m_context->FindClassInfo(type);
+	if (!classInfo || !classInfo->m_desc->IsKindOf(expected)) return NULL;
+	return PopScriptObject();
+}
+
+ScriptTableView* GMScriptStack::PopTable()
+{
+	if (m_numPopped == m_numParams) return NULL;
+
+	gmTableObject* table = NULL;
+	if (m_call)
+	{
+		const gmVariable& variable = m_call->GetReturnedVariable();
+		if (variable.m_type != GM_TABLE) return NULL;
+		table = variable.GetTableObjectSafe();
+	}
+	else if (!(table = m_thread->ParamTable(m_firstParam + m_numParams - m_numPopped - 1)))
+		return NULL;
+
+	m_numPopped++;
+	return new GMScriptTableView(m_context, table);
+}
+
 bool GMScriptStack::PushInt(int value)
 {
 	if (m_call)
@@ -111,6 +141,85 @@ ScriptObject* GMScriptStack::PushNewScriptObject(ClassDesc* classDesc, void* obj
 	return scriptObject;
 }
 
+gmTableObject* GMScriptStack::PushNewTable(int count)
+{
+	gmMachine* machine = m_context->m_machine;
+
+	// Push the table before filling it, so it's reachable while its strings are allocated
+	gmTableObject* table = machine->AllocTableObject();
+	if (m_call)
+		m_call->AddParamTable(table);
+	else
+		m_thread->PushTable(table);
+	table->Reserve(machine, count);
+	return table;
+}
+
+// Sets a single array or table element
+static inline void GMSetValue(gmMachine* machine, gmVariable& variable, int value) { variable.SetInt(value); }
+static inline void GMSetValue(gmMachine* machine, gmVariable& variable, float value) { variable.SetFloat(value); }
+static inline void GMSetValue(gmMachine* machine, gmVariable& variable, const char* value) { variable.SetString(machine, value); }
+
+template <typename T>
+static void GMFillArray(gmMachine* machine, gmTableObject* table, const T* values, int count)
+{
+	gmVariable value;
+	for (int i = 0; i < count; i++)
+	{
+		GMSetValue(machine, value, values[i]);
+		table->Set(machine, i, value);
+	}
+}
+
+template <typename T>
+static void GMFillTable(gmMachine* machine, gmTableObject* table, const char** keys, const T* values, int count)
+{
+	gmVariable key;
+	gmVariable value;
+	for (int i = 0; i < count; i++)
+	{
+		key.SetString(machine, keys[i]);
+		GMSetValue(machine, value, values[i]);
+		table->Set(machine, key, value);
+	}
+}
+
+bool GMScriptStack::PushArray(const int* values, int count)
+{
+	GMFillArray(m_context->m_machine, PushNewTable(count), values, count);
+	return true;
+}
+
+bool GMScriptStack::PushArray(const float* values, int count)
+{
+	GMFillArray(m_context->m_machine, PushNewTable(count), values, count);
+	return true;
+}
+
+bool GMScriptStack::PushArray(const char** strings, int count)
+{
+	GMFillArray(m_context->m_machine, PushNewTable(count), strings, count);
+	return true;
+}
+
+bool GMScriptStack::PushTable(const char** keys, const int* values, int count)
+{
+	GMFillTable(m_context->m_machine, PushNewTable(count), keys, values, count);
+	return true;
+}
+
+bool GMScriptStack::PushTable(const char** keys, const float* values, int count)
+{
+	GMFillTable(m_context->m_machine, PushNewTable(count), keys, values, count);
+	return true;
+}
+
+bool GMScriptStack::PushTable(const char** keys, const char** values, int count)
+{
+	GMFillTable(m_context->m_machine, PushNewTable(count), keys, values, count);
+	return true;
+}
+
 bool GMScriptStack::EndCall()
 {
 	MultiScriptAssert(m_call);
@@ -126,4 +235,121 @@ void GMScriptStack::ReleaseAfterCall()
 {
 	MultiScriptAssert(m_call);
 	delete this;
+}
+
+//---------------------------------------------------------
+// Table view
+//---------------------------------------------------------
+
+// Reads key or value of a table node
+static void GMGetValue(const gmVariable& variable, ScriptValue& value)
+{
+	switch (variable.m_type)
+	{
+	case GM_NULL:
+		value.m_type = ScriptValueType_Null;
+		break;
+	case GM_INT:
+		value.m_type = ScriptValueType_Int;
+		value.m_int = variable.m_value.m_int;
+		break;
+	case GM_FLOAT:
+		value.m_type = ScriptValueType_Float;
+		value.m_float = variable.m_value.m_float;
+		break;
+	case GM_STRING:
+	{
+		const gmStringObject* string = variable.GetStringObjectSafe();
+		value.m_type = ScriptValueType_String;
+		value.m_string = string->GetString();
+		value.m_length = string->GetLength();
+		break;
+	}
+	default:
+		value.m_type = ScriptValueType_Other;
+		break;
+	}
+}
+
+// Fills the object from the table in a single pass over its nodes
+static int GMExtract(const gmTableObject* table, ScriptFieldMatcher& matcher, void* objectPtr)
+{
+	int numFilled = 0;
+	ScriptValue value;
+	gmTableIterator it;
+	for (const gmTableNode* node = table->GetFirst(it); node; node = table->GetNext(it))
+	{
+		if (node->m_key.m_type != GM_STRING) continue;
+
+		const gmStringObject* name = node->m_key.GetStringObjectSafe();
+		const ClassFieldDesc* field = matcher.Find(name->GetString(), name->GetLength());
+		if (field)
+		{
+			GMGetValue(node->m_value, value);
+			if (ScriptFieldMatcher::Store(field, value, objectPtr))
+				numFilled++;
+		}
+	}
+	return numFilled;
+}
+
+GMScriptTableView::GMScriptTableView(GMScriptContext* context, gmTableObject* table) :
+	m_context(context),
+	m_table(table),
+	m_iterator(0),
+	m_started(false)
+{
+	m_context->m_machine->AddCPPOwnedGMObject(m_table);
+}
+
+int GMScriptTableView::GetCount()
+{
+	return m_table->Count();
+}
+
+void GMScriptTableView::Reset()
+{
+	m_started = false;
+}
+
+bool GMScriptTableView::Next(ScriptValue& key, ScriptValue& value)
+{
+	const gmTableNode* node = m_started ? m_table->GetNext(m_iterator) : m_table->GetFirst(m_iterator);
+	m_started = true;
+	if (!node) return false;
+
+	GMGetValue(node->m_key, key);
+	GMGetValue(node->m_value, value);
+	return true;
+}
+
+int GMScriptTableView::Extract(const ClassFieldDesc* fields, int numFields, void* objectPtr)
+{
+	ScriptFieldMatcher matcher(fields, numFields);
+	return GMExtract(m_table, matcher, objectPtr);
+}
+
+int GMScriptTableView::ExtractRows(const ClassFieldDesc* fields, int numFields, void* objects, int objectSize, int numObjects)
+{
+	ScriptFieldMatcher matcher(fields, numFields);
+	int numRows = 0;
+
+	gmTableIterator it;
+	for (const gmTableNode* node = m_table->GetFirst(it); node; node = m_table->GetNext(it))
+	{
+		if (node->m_key.m_type != GM_INT || node->m_value.m_type != GM_TABLE) continue;
+
+		const int index = node->m_key.m_value.m_int;
+		if (index < 0 || index >= numObjects) continue;
+
+		GMExtract(node->m_value.GetTableObjectSafe(), matcher, (char*) objects + index * objectSize);
+		numRows++;
+	}
+	return numRows;
+}
+
+void GMScriptTableView::Release()
+{
+	m_context->m_machine->RemoveCPPOwnedGMObject(m_table);
+	delete this;
 }
\ No newline at end of file
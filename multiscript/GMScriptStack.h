@@ -2,33 +2,68 @@
 
 class gmThread;
 class gmCall;
+class gmTableObject;
+class GMScriptContext;
 
 //! GM Script Stack implementation
 class GMScriptStack : public ScriptStack
 {
 	friend class GMScriptContext;
 private:
+	GMScriptContext* m_context;
 	gmThread* m_thread;
+	int m_firstParam; //!< Index of the first parameter accessible via this stack
 	int m_numParams;
 	int m_numPushed;
 	int m_numPopped;
 
 	gmCall* m_call;
 
+	//! Pushes a new table sized for count entries and returns it for filling
+	gmTableObject* PushNewTable(int count);
+
 public:
-	GMScriptStack(gmThread* thread, gmCall* call = NULL);
+	GMScriptStack(gmThread* thread, gmCall* call = NULL, int firstParam = 0);
 	~GMScriptStack();
 
 	int GetNumParams();
 
 	bool PopInt(int& value);
 	ScriptObject* PopScriptObject();
+	ScriptObject* PopScriptObject(ClassDesc* expected);
+	ScriptTableView* PopTable();
 
 	bool PushInt(int value);
 	bool PushString(const char* string, int length);
 	bool PushScriptObject(ScriptObject* abstractScriptObject);
 	ScriptObject* PushNewScriptObject(ClassDesc* classDesc, void* objectPtr);
+	bool PushArray(const int* values, int count);
+	bool PushArray(const float* values, int count);
+	bool PushArray(const char** strings, int count);
+	bool PushTable(const char** keys, const int* values, int count);
+	bool PushTable(const char** keys, const float* values, int count);
+	bool PushTable(const char** keys, const char** values, int count);
 
 	bool EndCall();
 	void ReleaseAfterCall();
+};
+
+//! GM table view implementation
+class GMScriptTableView : public ScriptTableView
+{
+private:
+	GMScriptContext* m_context;
+	gmTableObject* m_table; //!< Viewed table; owned by C++ until the view is released
+	int m_iterator; //!< gmTableIterator of the current entry
+	bool m_started;
+
+public:
+	GMScriptTableView(GMScriptContext* context, gmTableObject* table);
+
+	int GetCount();
+	void Reset();
+	bool Next(ScriptValue& key, ScriptValue& value);
+	int Extract(const ClassFieldDesc* fields, int numFields, void* objectPtr);
+	int ExtractRows(const ClassFieldDesc* fields, int numFields, void* objects, int objectSize, int numObjects);
+	void Release();
 };
\ No newline at end of file
@@ -18,7 +18,8 @@ void LuaScriptObject::Release()
 }
 
 LuaScriptContext::LuaScriptContext() :
-	L(NULL)
+	L(NULL),
+	m_objectsRef(LUA_NOREF)
 {}
 
 LuaScriptContext::~LuaScriptContext()
@@ -38,6 +39,15 @@ LuaScriptContext* LuaScriptContext::CreateContext(int stackSize)
 
 	context->L = L;
 
+	// Weak valued table used to find userdata of script objects owned by the script
+	lua_newtable(L);
+	lua_newtable(L);
+	lua_pushliteral(L, "__mode");
+	lua_pushliteral(L, "v");
+	lua_rawset(L, -3);
+	lua_setmetatable(L, -2);
+	context->m_objectsRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
 	return context;
 }
 
@@ -51,6 +61,33 @@ void LuaScriptContext::CollectGarbage(bool full)
 	lua_gc(L, full ? LUA_GCCOLLECT : LUA_GCSTEP, 0);
 }
 
+bool LuaScriptContext::SetOption(ScriptContextOption option, int value)
+{
+	switch (option)
+	{
+		case ScriptContextOption_Jit:
+			return lua_jit(L, value ? LUA_JITRESTART : LUA_JITSTOP, 0) != -1;
+		case ScriptContextOption_JitThreshold:
+			return value > 0 && lua_jit(L, LUA_JITTHRESHOLD, value) != -1;
+		case ScriptContextOption_GcGenerational:
+			lua_gc(L, value ? LUA_GCGEN : LUA_GCINC, 0);
+			return true;
+		case ScriptContextOption_GcMinorMul:
+			return value > 0 && lua_gc(L, LUA_GCSETMINORMUL, value) != -1;
+		case ScriptContextOption_GcMajorMul:
+			return value > 0 && lua_gc(L, LUA_GCSETMAJORMUL, value) != -1;
+		default:
+			return false;
+	}
+}
+
+bool LuaScriptContext::GetGcStats(ScriptGcStats& stats)
+{
+	stats.m_heapSize = (size_t) lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+	stats.m_stringRehashWork = lua_gc(L, LUA_GCSTRREHASH, 0);
+	return true;
+}
+
 bool LuaScriptContext::ExecuteString(const char* string)
 {
 	//lua_pushcfunction(L, LuaErrorHandlerCallback);
@@ -103,10 +140,18 @@ bool LuaScriptContext::RegisterUserClass(ClassDesc* desc)
 	MultiScriptAssert(desc->m_constructor);
 	MultiScriptAssert(desc->m_destructor);
 
+	desc->AssignTypeId();
+
 	LuaClassInfo* info = new LuaClassInfo();
 	info->m_desc = desc;
 	info->m_context = this;
 
+	// Resolve inherited methods once so that method lookup never walks super classes at call time
+	desc->GetAllMethods(info->m_methods);
+	desc->GetAllOperators(info->m_operators);
+	desc->GetAllFields(info->m_fields);
+	info->m_toStringMethod = desc->GetToStringMethod();
+
 	lua_newtable(L);
 	int methods = lua_gettop(L);
 
@@ -119,12 +164,65 @@ bool LuaScriptContext::RegisterUserClass(ClassDesc* desc)
 	lua_pushvalue(L, methods);
 	lua_settable(L, LUA_GLOBALSINDEX);
 
+	lua_pushvalue(L, methods);
+	info->m_methodsRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
 	lua_pushliteral(L, "__metatable");
 	lua_pushvalue(L, methods);
 	lua_settable(L, metatable);  // hide metatable from Lua getmetatable()
 
+	// Map field names to field indices
+	lua_newtable(L);
+	int fields = lua_gettop(L);
+	for (unsigned int i = 0; i < info->m_fields.size(); ++i)
+	{
+		lua_pushstring(L, info->m_fields[i].m_name);
+		lua_pushinteger(L, i);
+		lua_rawset(L, fields);
+	}
+
 	lua_pushliteral(L, "__index");
-	lua_pushvalue(L, methods);
+	if (info->m_fields.size() || info->m_operators[ClassOperator_Index])
+	{
+		// Look up methods first, then fields and finally fall back to index operator
+		lua_pushlightuserdata(L, info);
+		lua_pushinteger(L, ClassOperator_Index);
+		lua_pushvalue(L, methods);
+		lua_pushvalue(L, fields);
+		lua_pushcclosure(L, LuaClassIndexCallback, 4);
+	}
+	else
+		lua_pushvalue(L, methods);
+	lua_settable(L, metatable);
+
+	if (info->m_fields.size() || info->m_operators[ClassOperator_NewIndex])
+	{
+		// Set fields first, then fall back to new-index operator
+		lua_pushliteral(L, "__newindex");
+		lua_pushlightuserdata(L, info);
+		lua_pushinteger(L, ClassOperator_NewIndex);
+		lua_pushvalue(L, fields);
+		lua_pushcclosure(L, LuaClassNewIndexCallback, 3);
+		lua_settable(L, metatable);
+	}
+
+	lua_pop(L, 1); // drop fields table
+
+	// Overloaded operators
+	static const char* operatorEvents[ClassOperator_Count] = {"__add", "__sub", "__mul", "__eq", "__lt", NULL, NULL, "__len", "__call"};
+	for (int i = 0; i < ClassOperator_Count; ++i)
+		if (info->m_operators[i] && operatorEvents[i])
+		{
+			lua_pushstring(L, operatorEvents[i]);
+			lua_pushlightuserdata(L, info);
+			lua_pushinteger(L, i);
+			lua_pushcclosure(L, LuaClassOperatorCallback, 2);
+			lua_settable(L, metatable);
+		}
+
+	// Class info used to identify objects of this class
+	lua_pushliteral(L, "__classinfo");
+	lua_pushlightuserdata(L, info);
 	lua_settable(L, metatable);
 
 	lua_pushliteral(L, "__tostring");
@@ -161,10 +259,10 @@ bool LuaScriptContext::RegisterUserClass(ClassDesc* desc)
 	// Set mt as a metatable for methods table
 	lua_setmetatable(L, methods);
 
-	// fill method table with methods from class T
-	for (unsigned int i = 0; i < desc->m_methods.size(); ++i)
+	// fill method table with methods from class T and its super classes
+	for (unsigned int i = 0; i < info->m_methods.size(); ++i)
 	{
-		lua_pushstring(L, desc->m_methods[i].m_name);
+		lua_pushstring(L, info->m_methods[i].m_name);
 		lua_pushlightuserdata(L, info);
 		lua_pushinteger(L, i);
 		lua_pushcclosure(L, LuaClassMethodCallback, 2);
@@ -180,6 +278,61 @@ bool LuaScriptContext::RegisterUserClass(ClassDesc* desc)
 	return true;
 }
 
+int LuaScriptContext::InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args, int numArgs, bool* results)
+{
+	const int base = lua_gettop(L);
+	lua_rawgeti(L, LUA_REGISTRYINDEX, m_objectsRef);
+	const int objectsTable = base + 1;
+	lua_pushnil(L);
+	const int method = base + 2; // method resolved for the current class
+
+	LuaClassInfo* currentClass = NULL;
+	int numSucceeded = 0;
+	for (int i = 0; i < numObjects; ++i)
+	{
+		bool succeeded = false;
+		LuaScriptObject* scriptObject = (LuaScriptObject*) objects[i];
+		if (scriptObject && scriptObject->m_objectPtr)
+		{
+			lua_pushlightuserdata(L, scriptObject);
+			lua_rawget(L, objectsTable);
+			LuaClassInfo* classInfo = GetObjectClassInfo(L, -1);
+
+			// Objects are usually grouped by class, so method is only looked up when class changes
+			if (classInfo && classInfo != currentClass)
+			{
+				currentClass = classInfo;
+				lua_rawgeti(L, LUA_REGISTRYINDEX, classInfo->m_methodsRef);
+				lua_getfield(L, -1, methodName);
+				lua_replace(L, method);
+				lua_pop(L, 1);
+
+				if (!lua_isfunction(L, method) && m_logger)
+					m_logger->Output("Method '%s' not found in class '%s'\n", methodName, classInfo->m_desc->m_name);
+			}
+
+			if (classInfo && lua_isfunction(L, method))
+			{
+				lua_pushvalue(L, method);
+				lua_insert(L, -2);
+				for (int j = 0; j < numArgs; ++j)
+					lua_pushinteger(L, args[j]);
+				succeeded = LuaCall(1 + numArgs, 0);
+			}
+
+			lua_settop(L, method);
+		}
+
+		if (results)
+			results[i] = succeeded;
+		if (succeeded)
+			numSucceeded++;
+	}
+
+	lua_settop(L, base);
+	return numSucceeded;
+}
+
 LuaClassInfo* LuaScriptContext::FindClassInfo(ClassDesc* classDesc)
 {
 	for (unsigned int i = 0; i < m_classes.size(); ++i)
@@ -188,6 +341,31 @@ LuaClassInfo* LuaScriptContext::FindClassInfo(ClassDesc* classDesc)
 	return NULL;
 }
 
+void LuaScriptContext::PushNewObjectData(LuaClassInfo* classInfo, LuaScriptObject* scriptObject)
+{
+	void** scriptObjectData = (void**) lua_newuserdata(L, sizeof(void*));
+	*scriptObjectData = scriptObject;
+	luaL_getmetatable(L, classInfo->m_desc->m_name);
+	MultiScriptAssert( lua_type(L, -1) == LUA_TTABLE );
+	lua_setmetatable(L, -2);
+
+	// Remember userdata so that the object can be pushed back to script
+	lua_rawgeti(L, LUA_REGISTRYINDEX, m_objectsRef);
+	lua_pushlightuserdata(L, scriptObject);
+	lua_pushvalue(L, -3);
+	lua_rawset(L, -3);
+	lua_pop(L, 1);
+}
+
+bool LuaScriptContext::PushObjectData(ScriptObject* scriptObject)
+{
+	lua_rawgeti(L, LUA_REGISTRYINDEX, m_objectsRef);
+	lua_pushlightuserdata(L, scriptObject);
+	lua_rawget(L, -2);
+	lua_remove(L, -2);
+	return lua_isuserdata(L, -1) != 0;
+}
+
 bool LuaScriptContext::LuaCall(int numArgs, int numResults)
 {
 	const int statusCode = lua_pcall(L, numArgs, numResults, 0);
@@ -261,6 +439,17 @@ LuaScriptObject* LuaScriptContext::PopObjectData(lua_State* L)
 	return (LuaScriptObject*) *scriptObjectData;
 }
 
+LuaClassInfo* LuaScriptContext::GetObjectClassInfo(lua_State* L, int index)
+{
+	if (!lua_isuserdata(L, index) || !lua_getmetatable(L, index))
+		return NULL;
+
+	lua_getfield(L, -1, "__classinfo");
+	LuaClassInfo* classInfo = (LuaClassInfo*) lua_touserdata(L, -1);
+	lua_pop(L, 2); // Pop class info and metatable
+	return classInfo;
+}
+
 int LuaScriptContext::LuaClassConstructorCallback(lua_State* L)
 {
 	MultiScriptAssert( lua_isuserdata(L, lua_upvalueindex(1)) );
@@ -277,12 +466,7 @@ int LuaScriptContext::LuaClassConstructorCallback(lua_State* L)
 	MultiScriptAssert( scriptObject->m_objectPtr );
 	MultiScriptAssert( stack.m_numPushed == 0 );
 
-	void** scriptObjectData = (void**) lua_newuserdata(L, sizeof(void*));
-	*scriptObjectData = scriptObject;
-	luaL_getmetatable(L, classInfo->m_desc->m_name);
-	MultiScriptAssert( lua_type(L, -1) == LUA_TTABLE );
-	lua_setmetatable(L, -2);
-
+	classInfo->m_context->PushNewObjectData(classInfo, scriptObject);
 	return 1;
 }
 
@@ -334,10 +518,10 @@ int LuaScriptContext::LuaClassToStringMethodCallback(lua_State* L)
 	LuaScriptObject* scriptObject = PopObjectData(L);
 
 	char buffer[1 << 8];
-	if (info->m_desc->m_toStringMethod)
+	if (info->m_toStringMethod)
 	{
 		LuaScriptStack stack(info->m_context, false);
-		const bool result = info->m_desc->m_toStringMethod(scriptObject, buffer, 1 << 8);
+		const bool result = info->m_toStringMethod(scriptObject, buffer, 1 << 8);
 		MultiScriptAssert( result );
 		MultiScriptAssert( stack.m_numPushed == 0 );
 	}
@@ -359,12 +543,113 @@ int LuaScriptContext::LuaClassMethodCallback(lua_State* L)
 	LuaScriptObject* scriptObject = PopObjectData(L);
 
 	LuaScriptStack stack(info->m_context, false);
-	const bool result = info->m_desc->m_methods[methodIndex].m_method(scriptObject, &stack);
+	const bool result = info->m_methods[methodIndex].m_method(scriptObject, &stack);
 	MultiScriptAssert( result );
 
 	return stack.m_numPushed;
 }
 
+int LuaScriptContext::LuaClassOperatorCallback(lua_State* L)
+{
+	MultiScriptAssert( lua_isuserdata(L, lua_upvalueindex(1)) );
+	LuaClassInfo* info = (LuaClassInfo*) lua_touserdata(L, lua_upvalueindex(1));
+
+	MultiScriptAssert( lua_isnumber(L, lua_upvalueindex(2)) );
+	const int operatorIndex = (int) lua_tointeger(L, lua_upvalueindex(2));
+
+	// Arithmetic metamethods are also invoked when only the right operand is our object
+	if (GetObjectClassInfo(L, 1) != info)
+		return luaL_error(L, "left operand is required to be an object of class %s", info->m_desc->m_name);
+
+	// Lua passes the object twice to __len
+	if (operatorIndex == ClassOperator_Len)
+		lua_settop(L, 1);
+
+	LuaScriptObject* scriptObject = PopObjectData(L);
+
+	LuaScriptStack stack(info->m_context, false);
+	const bool result = info->m_operators[operatorIndex](scriptObject, &stack);
+	MultiScriptAssert( result );
+
+	if (operatorIndex == ClassOperator_Eq || operatorIndex == ClassOperator_Lt)
+	{
+		MultiScriptAssert( stack.m_numPushed == 1 );
+		lua_pushboolean(L, lua_tointeger(L, -1) != 0);
+		return 1;
+	}
+
+	return stack.m_numPushed;
+}
+
+int LuaScriptContext::LuaClassIndexCallback(lua_State* L)
+{
+	MultiScriptAssert( lua_isuserdata(L, lua_upvalueindex(1)) );
+	LuaClassInfo* info = (LuaClassInfo*) lua_touserdata(L, lua_upvalueindex(1));
+
+	// Methods take precedence over fields and index operator
+	lua_pushvalue(L, 2);
+	lua_rawget(L, lua_upvalueindex(3));
+	if (!lua_isnil(L, -1))
+		return 1;
+	lua_pop(L, 1);
+
+	// Read the field directly from object's memory
+	lua_pushvalue(L, 2);
+	lua_rawget(L, lua_upvalueindex(4));
+	if (!lua_isnil(L, -1))
+	{
+		const ClassFieldDesc& field = info->m_fields[lua_tointeger(L, -1)];
+
+		LuaScriptObject* scriptObject = *(LuaScriptObject**) lua_touserdata(L, 1);
+		MultiScriptAssert( scriptObject->m_objectPtr );
+		void* fieldPtr = field.GetFieldPtr(scriptObject->m_objectPtr);
+
+		switch (field.m_type)
+		{
+			case ClassFieldType_Int: lua_pushinteger(L, *(int*) fieldPtr); break;
+			case ClassFieldType_Float: lua_pushnumber(L, *(float*) fieldPtr); break;
+			case ClassFieldType_Bool: lua_pushboolean(L, *(bool*) fieldPtr); break;
+		}
+		return 1;
+	}
+	lua_pop(L, 1);
+
+	if (!info->m_operators[ClassOperator_Index])
+		return 0;
+	return LuaClassOperatorCallback(L);
+}
+
+int LuaScriptContext::LuaClassNewIndexCallback(lua_State* L)
+{
+	MultiScriptAssert( lua_isuserdata(L, lua_upvalueindex(1)) );
+	LuaClassInfo* info = (LuaClassInfo*) lua_touserdata(L, lua_upvalueindex(1));
+
+	// Write the field directly to object's memory
+	lua_pushvalue(L, 2);
+	lua_rawget(L, lua_upvalueindex(3));
+	if (!lua_isnil(L, -1))
+	{
+		const ClassFieldDesc& field = info->m_fields[lua_tointeger(L, -1)];
+
+		LuaScriptObject* scriptObject = *(LuaScriptObject**) lua_touserdata(L, 1);
+		MultiScriptAssert( scriptObject->m_objectPtr );
+		void* fieldPtr = field.GetFieldPtr(scriptObject->m_objectPtr);
+
+		switch (field.m_type)
+		{
+			case ClassFieldType_Int: *(int*) fieldPtr = (int) luaL_checkinteger(L, 3); break;
+			case ClassFieldType_Float: *(float*) fieldPtr = (float) luaL_checknumber(L, 3); break;
+			case ClassFieldType_Bool: *(bool*) fieldPtr = lua_toboolean(L, 3) != 0; break;
+		}
+		return 0;
+	}
+	lua_pop(L, 1);
+
+	if (!info->m_operators[ClassOperator_NewIndex])
+		return luaL_error(L, "no field '%s' in class %s", lua_tostring(L, 2), info->m_desc->m_name);
+	return LuaClassOperatorCallback(L);
+}
+
 int LuaScriptContext::LuaFunctionCallback(lua_State* L)
 {
 	MultiScriptAssert( lua_isuserdata(L, lua_upvalueindex(1)) );
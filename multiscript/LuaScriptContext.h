@@ -12,6 +12,12 @@ struct LuaClassInfo
 {
 	LuaScriptContext* m_context;
 	ClassDesc* m_desc;
+
+	vector<ClassMethodDesc> m_methods; //!< Flattened methods of the class and all of its super classes
+	GenericClassMethod m_operators[ClassOperator_Count]; //!< Overloaded operators of the class and all of its super classes
+	vector<ClassFieldDesc> m_fields; //!< Flattened fields of the class and all of its super classes
+	GenericClassToStringMethod m_toStringMethod; //!< To-string method of the class or of its nearest super class that has one
+	int m_methodsRef; //!< Registry reference to the methods table of the class
 };
 
 class LuaScriptObject : public ScriptObject
@@ -30,10 +36,12 @@ class LuaScriptContext : public ScriptContext
 {
 	friend class LuaScriptCall;
 	friend class LuaScriptStack;
+	friend class LuaScriptTableView;
 private:
 	lua_State* L;
 	std::vector<LuaFunctionInfo*> m_functions;
 	std::vector<LuaClassInfo*> m_classes;
+	int m_objectsRef; //!< Registry reference to weak table mapping script objects to their userdata
 
 	LuaScriptContext();
 	~LuaScriptContext();
@@ -43,24 +51,33 @@ public:
 
 	void SetLogger(ScriptLogger* logger);
 	void CollectGarbage(bool full);
+	bool SetOption(ScriptContextOption option, int value);
+	bool GetGcStats(ScriptGcStats& stats);
 	bool ExecuteString(const char* string);
 	ScriptStack* BeginCall(FunctionDesc* desc);
 	ScriptStack* BeginCall(const char* name);
 	bool RegisterFunction(FunctionDesc* desc);
 	bool RegisterUserClass(ClassDesc* desc);
+	int InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args, int numArgs, bool* results);
 
 protected:
 	LuaClassInfo* FindClassInfo(ClassDesc* classDesc);
 	bool LuaCall(int numArgs, int numResults);
+	void PushNewObjectData(LuaClassInfo* classInfo, LuaScriptObject* scriptObject);
+	bool PushObjectData(ScriptObject* scriptObject);
 
 	static void LuaPrintCallback(lua_State* L, const char* text);
 	static int LuaErrorHandlerCallback(lua_State* L);
 	static LuaScriptObject* PopObjectData(lua_State* L);
+	static LuaClassInfo* GetObjectClassInfo(lua_State* L, int index);
 
 	static int LuaClassConstructorCallback(lua_State* L);
 	static int LuaClassDestructorCallback(lua_State* L);
 	static int LuaClassGCCallback(lua_State* L);
 	static int LuaClassToStringMethodCallback(lua_State* L);
 	static int LuaClassMethodCallback(lua_State* L);
+	static int LuaClassOperatorCallback(lua_State* L);
+	static int LuaClassIndexCallback(lua_State* L);
+	static int LuaClassNewIndexCallback(lua_State* L);
 	static int LuaFunctionCallback(lua_State* L);
 };
\ No newline at end of file
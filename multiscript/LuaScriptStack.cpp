@@ -26,7 +26,7 @@ bool LuaScriptStack::PopInt(int& value)
 
 ScriptObject* LuaScriptStack::PopScriptObject()
 {
-	if (!lua_isuserdata(m_context->L, -1)) return false;
+	if (!lua_isuserdata(m_context->L, -1)) return NULL;
 	void** scriptObjectPtr = (void**) lua_touserdata(m_context->L, -1);
 	MultiScriptAssert(scriptObjectPtr && *scriptObjectPtr);
 	lua_pop(m_context->L, 1);
@@ -35,6 +35,22 @@ ScriptObject* LuaScriptStack::PopScriptObject()
 	return (LuaScriptObject*) *scriptObjectPtr;
 }
 
+ScriptObject* LuaScriptStack::PopScriptObject(ClassDesc* expected)
+{
+	LuaClassInfo* classInfo = LuaScriptContext::GetObjectClassInfo(m_context->L, -1);
+	if (!classInfo || !classInfo->m_desc->IsKindOf(expected)) return NULL;
+	return PopScriptObject();
+}
+
+ScriptTableView* LuaScriptStack::PopTable()
+{
+	if (!lua_istable(m_context->L, -1)) return NULL;
+	const int tableRef = luaL_ref(m_context->L, LUA_REGISTRYINDEX);
+	m_numParams--;
+
+	return new LuaScriptTableView(m_context, tableRef);
+}
+
 bool LuaScriptStack::PushInt(int value)
 {
 	lua_pushinteger(m_context->L, value);
@@ -52,11 +68,9 @@ bool LuaScriptStack::PushString(const char* string, int length)
 
 bool LuaScriptStack::PushScriptObject(ScriptObject* object)
 {
-	MultiScriptAssert(false);
-	// TODO: Implement me!!!
-
+	const bool result = m_context->PushObjectData(object);
 	m_numPushed++;
-	return false;
+	return result;
 }
 
 ScriptObject* LuaScriptStack::PushNewScriptObject(ClassDesc* classDesc, void* objectPtr)
@@ -71,17 +85,82 @@ ScriptObject* LuaScriptStack::PushNewScriptObject(ClassDesc* classDesc, void* ob
 	LuaScriptObject* scriptObject = new LuaScriptObject();
 	scriptObject->m_objectPtr = objectPtr;
 
-	void** scriptObjectData = (void**) lua_newuserdata(m_context->L, sizeof(void*));
-	*scriptObjectData = scriptObject;
-	luaL_getmetatable(m_context->L, classInfo->m_desc->m_name);
-	MultiScriptAssert( lua_type(m_context->L, -1) == LUA_TTABLE );
-	lua_setmetatable(m_context->L, -2);
-
+	m_context->PushNewObjectData(classInfo, scriptObject);
 	m_numPushed++;
 
 	return scriptObject;
 }
 
+// Pushes a single array or table element
+static inline void LuaPushValue(lua_State* L, int value) { lua_pushinteger(L, value); }
+static inline void LuaPushValue(lua_State* L, float value) { lua_pushnumber(L, value); }
+static inline void LuaPushValue(lua_State* L, const char* value) { lua_pushstring(L, value); }
+
+template <typename T>
+static void LuaPushArray(lua_State* L, const T* values, int count)
+{
+	lua_createtable(L, count, 0);
+	for (int i = 0; i < count; i++)
+	{
+		LuaPushValue(L, values[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+}
+
+template <typename T>
+static void LuaPushTable(lua_State* L, const char** keys, const T* values, int count)
+{
+	lua_createtable(L, 0, count);
+	for (int i = 0; i < count; i++)
+	{
+		lua_pushstring(L, keys[i]);
+		LuaPushValue(L, values[i]);
+		lua_rawset(L, -3);
+	}
+}
+
+bool LuaScriptStack::PushArray(const int* values, int count)
+{
+	LuaPushArray(m_context->L, values, count);
+	m_numPushed++;
+	return true;
+}
+
+bool LuaScriptStack::PushArray(const float* values, int count)
+{
+	LuaPushArray(m_context->L, values, count);
+	m_numPushed++;
+	return true;
+}
+
+bool LuaScriptStack::PushArray(const char** strings, int count)
+{
+	LuaPushArray(m_context->L, strings, count);
+	m_numPushed++;
+	return true;
+}
+
+bool LuaScriptStack::PushTable(const char** keys, const int* values, int count)
+{
+	LuaPushTable(m_context->L, keys, values, count);
+	m_numPushed++;
+	return true;
+}
+
+bool LuaScriptStack::PushTable(const char** keys, const float* values, int count)
+{
+	LuaPushTable(m_context->L, keys, values, count);
+	m_numPushed++;
+	return true;
+}
+
+bool LuaScriptStack::PushTable(const char** keys, const char** values, int count)
+{
+	LuaPushTable(m_context->L, keys, values, count);
+	m_numPushed++;
+	return true;
+}
+
 bool LuaScriptStack::EndCall()
 {
 	MultiScriptAssert(m_isCall);
@@ -97,4 +176,158 @@ void LuaScriptStack::ReleaseAfterCall()
 {
 	MultiScriptAssert(m_isCall);
 	delete this;
+}
+
+//---------------------------------------------------------
+// Table view
+//---------------------------------------------------------
+
+// Reads key or value of a table entry without converting it on the stack
+static void LuaGetValue(lua_State* L, int index, ScriptValue& value)
+{
+	switch (lua_type(L, index))
+	{
+	case LUA_TNIL:
+		value.m_type = ScriptValueType_Null;
+		break;
+	case LUA_TNUMBER:
+	{
+		const lua_Number number = lua_tonumber(L, index);
+		value.m_int = (int) number;
+		value.m_float = (float) number;
+		value.m_type = (lua_Number) value.m_int == number ? ScriptValueType_Int : ScriptValueType_Float;
+		break;
+	}
+	case LUA_TBOOLEAN:
+		value.m_type = ScriptValueType_Bool;
+		value.m_int = lua_toboolean(L, index);
+		break;
+	case LUA_TSTRING:
+	{
+		size_t length;
+		value.m_type = ScriptValueType_String;
+		value.m_string = lua_tolstring(L, index, &length);
+		value.m_length = (int) length;
+		break;
+	}
+	default:
+		value.m_type = ScriptValueType_Other;
+		break;
+	}
+}
+
+// Fills the object from the table on top of the stack in a single lua_next traversal
+static int LuaExtract(lua_State* L, ScriptFieldMatcher& matcher, void* objectPtr)
+{
+	int numFilled = 0;
+	ScriptValue value;
+	lua_pushnil(L);
+	while (lua_next(L, -2))
+	{
+		if (lua_type(L, -2) == LUA_TSTRING)
+		{
+			size_t length;
+			const char* name = lua_tolstring(L, -2, &length);
+			const ClassFieldDesc* field = matcher.Find(name, (int) length);
+			if (field)
+			{
+				LuaGetValue(L, -1, value);
+				if (ScriptFieldMatcher::Store(field, value, objectPtr))
+					numFilled++;
+			}
+		}
+		lua_pop(L, 1);
+	}
+	return numFilled;
+}
+
+LuaScriptTableView::LuaScriptTableView(LuaScriptContext* context, int tableRef) :
+	m_context(context),
+	m_tableRef(tableRef),
+	m_keyRef(LUA_NOREF),
+	m_finished(false)
+{}
+
+int LuaScriptTableView::GetCount()
+{
+	lua_rawgeti(m_context->L, LUA_REGISTRYINDEX, m_tableRef);
+	const int count = (int) lua_objlen(m_context->L, -1);
+	lua_pop(m_context->L, 1);
+	return count;
+}
+
+void LuaScriptTableView::Reset()
+{
+	luaL_unref(m_context->L, LUA_REGISTRYINDEX, m_keyRef);
+	m_keyRef = LUA_NOREF;
+	m_finished = false;
+}
+
+bool LuaScriptTableView::Next(ScriptValue& key, ScriptValue& value)
+{
+	if (m_finished) return false;
+
+	lua_State* L = m_context->L;
+	lua_rawgeti(L, LUA_REGISTRYINDEX, m_tableRef);
+	if (m_keyRef == LUA_NOREF) lua_pushnil(L);
+	else lua_rawgeti(L, LUA_REGISTRYINDEX, m_keyRef);
+	luaL_unref(L, LUA_REGISTRYINDEX, m_keyRef);
+	m_keyRef = LUA_NOREF;
+
+	if (!lua_next(L, -2))
+	{
+		lua_pop(L, 1);
+		m_finished = true;
+		return false;
+	}
+
+	// Strings stay valid after popping since the table references them
+	LuaGetValue(L, -2, key);
+	LuaGetValue(L, -1, value);
+	lua_pop(L, 1);
+	m_keyRef = luaL_ref(L, LUA_REGISTRYINDEX);
+	lua_pop(L, 1);
+	return true;
+}
+
+int LuaScriptTableView::Extract(const ClassFieldDesc* fields, int numFields, void* objectPtr)
+{
+	ScriptFieldMatcher matcher(fields, numFields);
+	lua_rawgeti(m_context->L, LUA_REGISTRYINDEX, m_tableRef);
+	const int numFilled = LuaExtract(m_context->L, matcher, objectPtr);
+	lua_pop(m_context->L, 1);
+	return numFilled;
+}
+
+int LuaScriptTableView::ExtractRows(const ClassFieldDesc* fields, int numFields, void* objects, int objectSize, int numObjects)
+{
+	lua_State* L = m_context->L;
+	ScriptFieldMatcher matcher(fields, numFields);
+	int numRows = 0;
+
+	lua_rawgeti(L, LUA_REGISTRYINDEX, m_tableRef);
+	lua_pushnil(L);
+	while (lua_next(L, -2))
+	{
+		if (lua_type(L, -2) == LUA_TNUMBER && lua_istable(L, -1))
+		{
+			const lua_Number key = lua_tonumber(L, -2);
+			const int index = (int) key - 1;
+			if ((lua_Number) (index + 1) == key && index >= 0 && index < numObjects)
+			{
+				LuaExtract(L, matcher, (char*) objects + index * objectSize);
+				numRows++;
+			}
+		}
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+	return numRows;
+}
+
+void LuaScriptTableView::Release()
+{
+	luaL_unref(m_context->L, LUA_REGISTRYINDEX, m_keyRef);
+	luaL_unref(m_context->L, LUA_REGISTRYINDEX, m_tableRef);
+	delete this;
 }
\ No newline at end of file
@@ -16,12 +16,39 @@ public:
 
 	bool PopInt(int& value);
 	ScriptObject* PopScriptObject();
+	ScriptObject* PopScriptObject(ClassDesc* expected);
+	ScriptTableView* PopTable();
 
 	bool PushInt(int value);
 	bool PushString(const char* string, int length);
 	bool PushScriptObject(ScriptObject* object);
 	ScriptObject* PushNewScriptObject(ClassDesc* classDesc, void* objectPtr);
+	bool PushArray(const int* values, int count);
+	bool PushArray(const float* values, int count);
+	bool PushArray(const char** strings, int count);
+	bool PushTable(const char** keys, const int* values, int count);
+	bool PushTable(const char** keys, const float* values, int count);
+	bool PushTable(const char** keys, const char** values, int count);
 
 	bool EndCall();
 	void ReleaseAfterCall();
 };
+
+class LuaScriptTableView : public ScriptTableView
+{
+private:
+	LuaScriptContext* m_context;
+	int m_tableRef; //!< Registry reference keeping the table alive
+	int m_keyRef; //!< Registry reference to the key of the current entry; LUA_NOREF before the first entry
+	bool m_finished;
+
+public:
+	LuaScriptTableView(LuaScriptContext* context, int tableRef);
+
+	int GetCount();
+	void Reset();
+	bool Next(ScriptValue& key, ScriptValue& value);
+	int Extract(const ClassFieldDesc* fields, int numFields, void* objectPtr);
+	int ExtractRows(const ClassFieldDesc* fields, int numFields, void* objects, int objectSize, int numObjects);
+	void Release();
+};
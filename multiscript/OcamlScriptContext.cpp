@@ -20,7 +20,8 @@ void OcamlScriptObject::Release()
 }
 
 OcamlScriptContext::OcamlScriptContext() :
-	m_dirtyFakedDLL(true)
+	m_dirtyFakedDLL(true),
+	m_gcStepWork(0)
 {}
 
 OcamlScriptContext::~OcamlScriptContext()
@@ -48,7 +49,56 @@ void OcamlScriptContext::SetLogger(ScriptLogger* logger)
 
 void OcamlScriptContext::CollectGarbage(bool full)
 {
-	
+	if (full)
+		custom_caml_gc_full_major();
+	else
+		custom_caml_gc_major_slice(m_gcStepWork);
+}
+
+bool OcamlScriptContext::SetOption(ScriptContextOption option, int value)
+{
+	if (value <= 0)
+		return false;
+
+	caml_gc_params params;
+	custom_caml_gc_get_params(&params);
+	switch (option)
+	{
+		case ScriptContextOption_GcStepWork:
+			m_gcStepWork = value;
+			return true;
+		case ScriptContextOption_GcMinorHeapSize:
+			params.minor_heap_size = Wsize_bsize((uintnat) value * 1024);
+			break;
+		case ScriptContextOption_GcSpaceOverhead:
+			params.space_overhead = value;
+			break;
+		case ScriptContextOption_GcHeapIncrement:
+			params.major_heap_increment = Wsize_bsize((uintnat) value * 1024);
+			break;
+		default:
+			return false;
+	}
+
+	// The runtime clamps the values to its limits (e.g. Minor_heap_min)
+	custom_caml_gc_set_params(&params);
+	return true;
+}
+
+bool OcamlScriptContext::GetGcStats(ScriptGcStats& stats)
+{
+	caml_gc_stats caml;
+	custom_caml_gc_get_stats(&caml);
+
+	stats.m_minorBytes = caml.minor_words * sizeof(value);
+	stats.m_promotedBytes = caml.promoted_words * sizeof(value);
+	stats.m_majorBytes = caml.major_words * sizeof(value);
+	stats.m_minorCollections = (int) caml.minor_collections;
+	stats.m_majorCollections = (int) caml.major_collections;
+	stats.m_compactions = (int) caml.compactions;
+	stats.m_heapSize = Bsize_wsize(caml.heap_size);
+	stats.m_topHeapSize = Bsize_wsize(caml.top_heap_size);
+	return true;
 }
 
 static string m_ocamlc_path = "C:/Program Files/Objective Caml/bin/ocamlc.exe";
@@ -169,6 +219,8 @@ bool OcamlScriptContext::RegisterUserClass(ClassDesc* desc)
 	MultiScriptAssert(desc->m_constructor);
 	MultiScriptAssert(desc->m_destructor);
 
+	desc->AssignTypeId();
+
 	OcamlClassInfo* classInfo = new OcamlClassInfo();
 	classInfo->m_desc = desc;
 	classInfo->m_context = this;
@@ -178,6 +230,12 @@ bool OcamlScriptContext::RegisterUserClass(ClassDesc* desc)
 	return true;
 }
 
+int OcamlScriptContext::InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args, int numArgs, bool* results)
+{
+	MultiScriptAssert(!"Will not implement - ocaml doesn't support class binding.");
+	return 0;
+}
+
 OcamlClassInfo* OcamlScriptContext::FindClassInfo(ClassDesc* classDesc)
 {
 	for (unsigned int i = 0; i < m_classes.size(); ++i)
@@ -10,6 +10,7 @@ extern "C"
 	#include "ocaml_io.h"
 	#include "misc.h"
 	#include "memory.h"
+	#include "gc_ctrl.h"
 };
 
 class OcamlScriptContext;
@@ -48,6 +49,7 @@ private:
 	std::vector<OcamlClassInfo*> m_classes;
 
 	bool m_dirtyFakedDLL;
+	int m_gcStepWork; //!< Words of major heap work done by one collection step; 0 lets the runtime compute it
 
 	static OcamlScriptContext* s_instance;
 
@@ -59,11 +61,14 @@ public:
 
 	void SetLogger(ScriptLogger* logger);
 	void CollectGarbage(bool full);
+	bool SetOption(ScriptContextOption option, int value);
+	bool GetGcStats(ScriptGcStats& stats);
 	bool ExecuteString(const char* string);
 	ScriptStack* BeginCall(FunctionDesc* desc);
 	ScriptStack* BeginCall(const char* name);
 	bool RegisterFunction(FunctionDesc* desc);
 	bool RegisterUserClass(ClassDesc* desc);
+	int InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args, int numArgs, bool* results);
 
 protected:
 	void RebuildFakeDLL();
@@ -48,6 +48,18 @@ ScriptObject* OcamlScriptStack::PopScriptObject()
 	return NULL;
 }
 
+ScriptObject* OcamlScriptStack::PopScriptObject(ClassDesc* expected)
+{
+	MultiScriptAssert(!"Will not implement - ocaml doesn't support class binding.");
+	return NULL;
+}
+
+ScriptTableView* OcamlScriptStack::PopTable()
+{
+	MultiScriptAssert(!"Will not implement - ocaml doesn't have tables.");
+	return NULL;
+}
+
 bool OcamlScriptStack::PushInt(int value)
 {
 	if (m_isCall)
@@ -84,6 +96,42 @@ ScriptObject* OcamlScriptStack::PushNewScriptObject(ClassDesc* classDesc, void*
 	return false;
 }
 
+bool OcamlScriptStack::PushArray(const int* values, int count)
+{
+	MultiScriptAssert(!"Not yet implemented.");
+	return false;
+}
+
+bool OcamlScriptStack::PushArray(const float* values, int count)
+{
+	MultiScriptAssert(!"Not yet implemented.");
+	return false;
+}
+
+bool OcamlScriptStack::PushArray(const char** strings, int count)
+{
+	MultiScriptAssert(!"Not yet implemented.");
+	return false;
+}
+
+bool OcamlScriptStack::PushTable(const char** keys, const int* values, int count)
+{
+	MultiScriptAssert(!"Will not implement - ocaml doesn't have tables.");
+	return false;
+}
+
+bool OcamlScriptStack::PushTable(const char** keys, const float* values, int count)
+{
+	MultiScriptAssert(!"Will not implement - ocaml doesn't have tables.");
+	return false;
+}
+
+bool OcamlScriptStack::PushTable(const char** keys, const char** values, int count)
+{
+	MultiScriptAssert(!"Will not implement - ocaml doesn't have tables.");
+	return false;
+}
+
 bool OcamlScriptStack::EndCall()
 {
 	MultiScriptAssert(m_isCall);
@@ -24,11 +24,19 @@ public:
 
 	bool PopInt(int& value);
 	ScriptObject* PopScriptObject();
+	ScriptObject* PopScriptObject(ClassDesc* expected);
+	ScriptTableView* PopTable();
 
 	bool PushInt(int value);
 	bool PushString(const char* string, int length);
 	bool PushScriptObject(ScriptObject* object);
 	ScriptObject* PushNewScriptObject(ClassDesc* classDesc, void* objectPtr);
+	bool PushArray(const int* values, int count);
+	bool PushArray(const float* values, int count);
+	bool PushArray(const char** strings, int count);
+	bool PushTable(const char** keys, const int* values, int count);
+	bool PushTable(const char** keys, const float* values, int count);
+	bool PushTable(const char** keys, const char** values, int count);
 
 	bool EndCall();
 	void ReleaseAfterCall();
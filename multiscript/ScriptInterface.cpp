@@ -30,6 +30,135 @@ const char** ScriptContext::GetSupportedLanguages()
 	return languages;
 }
 
+void ClassDesc::AssignTypeId()
+{
+	//! Number of type ids assigned so far
+	static int numTypeIds = 0;
+
+	if (m_typeId != -1)
+		return;
+
+	if (m_superClass)
+	{
+		m_superClass->AssignTypeId();
+		m_display = m_superClass->m_display;
+	}
+
+	m_typeId = numTypeIds++;
+	m_display.push_back(m_typeId);
+}
+
+void ClassDesc::GetAllMethods(vector<ClassMethodDesc>& methods)
+{
+	if (m_superClass)
+		m_superClass->GetAllMethods(methods);
+
+	for (unsigned int i = 0; i < m_methods.size(); ++i)
+	{
+		// Override super class method of the same name (if any)
+		unsigned int j = 0;
+		while (j < methods.size() && strcmp(methods[j].m_name, m_methods[i].m_name))
+			j++;
+
+		if (j < methods.size())
+			methods[j] = m_methods[i];
+		else
+			methods.push_back(m_methods[i]);
+	}
+}
+
+void ClassDesc::GetAllFields(vector<ClassFieldDesc>& fields)
+{
+	if (m_superClass)
+		m_superClass->GetAllFields(fields);
+
+	for (unsigned int i = 0; i < m_fields.size(); ++i)
+	{
+		// Override super class field of the same name (if any)
+		unsigned int j = 0;
+		while (j < fields.size() && strcmp(fields[j].m_name, m_fields[i].m_name))
+			j++;
+
+		if (j < fields.size())
+			fields[j] = m_fields[i];
+		else
+			fields.push_back(m_fields[i]);
+	}
+}
+
+GenericClassToStringMethod ClassDesc::GetToStringMethod()
+{
+	ClassDesc* desc = this;
+	while (desc && !desc->m_toStringMethod)
+		desc = desc->m_superClass;
+	return desc ? desc->m_toStringMethod : NULL;
+}
+
+void ClassDesc::GetAllOperators(GenericClassMethod* operators)
+{
+	if (m_superClass)
+		m_superClass->GetAllOperators(operators);
+	else
+		for (int i = 0; i < ClassOperator_Count; ++i)
+			operators[i] = NULL;
+
+	for (unsigned int i = 0; i < m_operators.size(); ++i)
+	{
+		MultiScriptAssert( m_operators[i].m_operator < ClassOperator_Count );
+		operators[m_operators[i].m_operator] = m_operators[i].m_method;
+	}
+}
+
+ScriptFieldMatcher::ScriptFieldMatcher(const ClassFieldDesc* fields, int numFields) :
+	m_fields(fields),
+	m_numFields(numFields),
+	m_lengths(numFields),
+	m_next(0)
+{
+	for (int i = 0; i < numFields; ++i)
+		m_lengths[i] = (int) strlen(fields[i].m_name);
+}
+
+const ClassFieldDesc* ScriptFieldMatcher::Find(const char* name, int length)
+{
+	int index = m_next;
+	for (int i = 0; i < m_numFields; ++i)
+	{
+		if (index == m_numFields)
+			index = 0;
+		if (m_lengths[index] == length && !memcmp(m_fields[index].m_name, name, length))
+		{
+			m_next = index + 1;
+			return &m_fields[index];
+		}
+		index++;
+	}
+	return NULL;
+}
+
+bool ScriptFieldMatcher::Store(const ClassFieldDesc* field, const ScriptValue& value, void* objectPtr)
+{
+	const bool isInteger = value.m_type == ScriptValueType_Int || value.m_type == ScriptValueType_Bool;
+	if (!isInteger && value.m_type != ScriptValueType_Float)
+		return false;
+
+	void* fieldPtr = field->GetFieldPtr(objectPtr);
+	switch (field->m_type)
+	{
+	case ClassFieldType_Int:
+		*(int*) fieldPtr = isInteger ? value.m_int : (int) value.m_float;
+		return true;
+	case ClassFieldType_Float:
+		*(float*) fieldPtr = isInteger ? (float) value.m_int : value.m_float;
+		return true;
+	case ClassFieldType_Bool:
+		*(bool*) fieldPtr = isInteger ? value.m_int != 0 : value.m_float != 0.0f;
+		return true;
+	default:
+		return false;
+	}
+}
+
 void MultiScriptPrintf(const char* text, ...)
 {
 	char buffer[1024];
@@ -17,6 +17,7 @@ void MultiScriptSprintf(char* buffer, int bufferSize, const char* text, ...);
 
 class ScriptStack;
 class ScriptObject;
+class ScriptTableView;
 
 //! Generic function type; first pops parameters from the stack, then pushes results onto the stack
 typedef bool (*GenericFunction)(ScriptStack* stack);
@@ -66,16 +67,87 @@ struct ClassMethodDesc
 	{}
 };
 
+//! Type of the class field
+enum ClassFieldType
+{
+	ClassFieldType_Int = 0,	//!< int
+	ClassFieldType_Float,	//!< float
+	ClassFieldType_Bool,	//!< bool
+
+	ClassFieldType_Count
+};
+
+//! Description of the class field; the field is read and written by script directly in object's memory (as object.name) without invoking any method
+struct ClassFieldDesc
+{
+	const char* m_name; //!< Field name
+	ClassFieldType m_type; //!< Field type
+	int m_offset; //!< Byte offset of the field within the object at scriptObject->m_objectPtr (use offsetof())
+
+	ClassFieldDesc() :
+		m_name(NULL),
+		m_type(ClassFieldType_Int),
+		m_offset(0)
+	{}
+
+	ClassFieldDesc(const char* name, ClassFieldType type, int offset) :
+		m_name(name),
+		m_type(type),
+		m_offset(offset)
+	{}
+
+	//! Retrieves pointer to the field of the given object
+	inline void* GetFieldPtr(void* objectPtr) const { return (char*) objectPtr + m_offset; }
+};
+
+//! Operators that can be overloaded by a class; operator is always invoked on its left (or only) operand which is required to be an object of the class
+enum ClassOperator
+{
+	ClassOperator_Add = 0,	//!< a + b
+	ClassOperator_Sub,		//!< a - b
+	ClassOperator_Mul,		//!< a * b
+	ClassOperator_Eq,		//!< a == b; should push integer which is then converted to boolean (if supported by the language)
+	ClassOperator_Lt,		//!< a < b; should push integer which is then converted to boolean (if supported by the language)
+	ClassOperator_Index,	//!< a[key]; invoked only when there is no method of that name
+	ClassOperator_NewIndex,	//!< a[key] = value
+	ClassOperator_Len,		//!< Length of the object (#a in Lua, a.len() in Squirrel)
+	ClassOperator_Call,		//!< a(...)
+
+	ClassOperator_Count
+};
+
+//! Description of the class operator
+struct ClassOperatorDesc
+{
+	ClassOperator m_operator; //!< Overloaded operator
+	GenericClassMethod m_method; //!< The actual function; pops remaining operands from the stack and pushes the result onto the stack
+
+	ClassOperatorDesc() :
+		m_operator(ClassOperator_Count),
+		m_method(NULL)
+	{}
+
+	ClassOperatorDesc(ClassOperator op, GenericClassMethod method) :
+		m_operator(op),
+		m_method(method)
+	{}
+};
+
 //! Description of a class
 struct ClassDesc
 {
 	bool m_garbageCollect; //!< Indicates whether the class is garbage collected or not; if yes, the destructor is called when garbage collector destroys it, otherwise the only way to destroy object from the script is to call special method Destroy() on it
-	ClassDesc* m_superClass; //!< Optional super class 
+	ClassDesc* m_superClass; //!< Optional super class; all of its methods are inherited by this class
 	const char* m_name; //!< Name of the class
 	GenericClassConstructor m_constructor; //!< Mandatory constructor; it's required that passed script object's internal pointer is set to non-NULL value
 	GenericClassDestructor m_destructor; //!< Mandatory destructor (if garbage collected, invoked on garbage collection event; otherwise invoked only when manually called special method Destroy() on this from script); it's not required to NULL-ify the script object's internal pointer 
-	GenericClassToStringMethod m_toStringMethod; //!< Optional to-string method; accessible from script as ToString() method
+	GenericClassToStringMethod m_toStringMethod; //!< Optional to-string method; accessible from script as ToString() method; inherited by derived classes that don't have their own
 	vector<ClassMethodDesc> m_methods; //!< Class methods
+	vector<ClassOperatorDesc> m_operators; //!< Overloaded class operators; just like methods these are inherited by derived classes
+	vector<ClassFieldDesc> m_fields; //!< Fields directly accessible from script; just like methods these are inherited by derived classes
+
+	int m_typeId; //!< Compact type id unique within the process; assigned on first registration of the class (-1 until then)
+	vector<int> m_display; //!< Ancestor display (Cohen): type ids of all super classes indexed by their depth in hierarchy followed by this class' type id; assigned together with type id
 
 	ClassDesc() :
 		m_garbageCollect(true),
@@ -83,8 +155,28 @@ struct ClassDesc
 		m_name(NULL),
 		m_constructor(NULL),
 		m_destructor(NULL),
-		m_toStringMethod(NULL)
+		m_toStringMethod(NULL),
+		m_typeId(-1)
 	{}
+
+	//! Assigns type id and ancestor display to this class and all of its super classes (unless already assigned); invoked on class registration
+	void AssignTypeId();
+
+	//! Constant time check whether this class is the given class or derives from it; both classes are required to have type ids assigned
+	inline bool IsKindOf(ClassDesc* classDesc)
+	{
+		const unsigned int depth = (unsigned int) classDesc->m_display.size() - 1;
+		return depth < m_display.size() && m_display[depth] == classDesc->m_typeId;
+	}
+
+	//! Collects methods of this class and all of its super classes into single flat table; methods of derived class override super class methods of the same name
+	void GetAllMethods(vector<ClassMethodDesc>& methods);
+	//! Resolves operators of this class and all of its super classes into table indexed by ClassOperator (NULL if operator is not overloaded); derived class operators override super class ones
+	void GetAllOperators(GenericClassMethod* operators);
+	//! Collects fields of this class and all of its super classes into single flat table; fields of derived class override super class fields of the same name
+	void GetAllFields(vector<ClassFieldDesc>& fields);
+	//! Resolves to-string method of this class or of its nearest super class that has one (NULL if none)
+	GenericClassToStringMethod GetToStringMethod();
 };
 
 /**
@@ -102,6 +194,10 @@ public:
 	// Popping values from the stack
 	virtual bool PopInt(int& value) = 0;
 	virtual ScriptObject* PopScriptObject() = 0;
+	//! Pops script object only if it is an instance of the expected class (or any class derived from it); otherwise returns NULL and leaves the stack untouched
+	virtual ScriptObject* PopScriptObject(ClassDesc* expected) = 0;
+	//! Pops table (or Squirrel array) as a read only view; returns NULL and leaves the stack untouched if the value isn't one
+	virtual ScriptTableView* PopTable() = 0;
 
 	// Pushing values to the stack
 	virtual bool PushInt(int value) = 0;
@@ -109,6 +205,16 @@ public:
 	virtual bool PushScriptObject(ScriptObject* scriptObject) = 0;
 	virtual ScriptObject* PushNewScriptObject(ClassDesc* classDesc, void* objectPtr) = 0;
 
+	// Pushing arrays and tables; the container is allocated once at its final size and filled in a single pass
+	//! Pushes an array of count values; indices start at 0 (at 1 in Lua)
+	virtual bool PushArray(const int* values, int count) = 0;
+	virtual bool PushArray(const float* values, int count) = 0;
+	virtual bool PushArray(const char** strings, int count) = 0;
+	//! Pushes a table mapping each of count string keys to the value at the same index
+	virtual bool PushTable(const char** keys, const int* values, int count) = 0;
+	virtual bool PushTable(const char** keys, const float* values, int count) = 0;
+	virtual bool PushTable(const char** keys, const char** values, int count) = 0;
+
 	// Script call interface
 	virtual bool EndCall() = 0;
 	virtual void ReleaseAfterCall() = 0;
@@ -192,6 +298,114 @@ public:
 	}
 };
 
+//! Type of a value read from a script table
+enum ScriptValueType
+{
+	ScriptValueType_Null = 0,	//!< nil / null
+	ScriptValueType_Int,		//!< Integer (Lua numbers without fractional part are reported as integers)
+	ScriptValueType_Float,		//!< Floating point number
+	ScriptValueType_Bool,		//!< Boolean; stored in m_int as 0 or 1
+	ScriptValueType_String,		//!< String
+	ScriptValueType_Other,		//!< Any other type (table, function, object etc.)
+
+	ScriptValueType_Count
+};
+
+//! Key or value of a script table entry
+struct ScriptValue
+{
+	ScriptValueType m_type; //!< Type of the value
+	int m_int; //!< Value of integer or boolean
+	float m_float; //!< Value of float
+	const char* m_string; //!< Value of string; remains valid as long as the table holds it
+	int m_length; //!< Length of string
+
+	ScriptValue() :
+		m_type(ScriptValueType_Null),
+		m_int(0),
+		m_float(0.0f),
+		m_string(NULL),
+		m_length(0)
+	{}
+};
+
+/**
+ *	Read only view of a script table; see ScriptStack::PopTable().
+ *
+ *	The view keeps the table alive until released; release it before the context is destroyed.
+ *	Tables must not be modified while iterated.
+ */
+class ScriptTableView
+{
+public:
+	virtual ~ScriptTableView() {}
+
+	//! Retrieves number of entries (length of the array part in Lua)
+	virtual int GetCount() = 0;
+
+	//! Restarts iteration from the first entry
+	virtual void Reset() = 0;
+	//! Retrieves next entry; returns false after the last one
+	virtual bool Next(ScriptValue& key, ScriptValue& value) = 0;
+
+	//! Fills fields of the object at objectPtr from the entries whose keys name a field (in a single pass over the table); returns number of fields filled
+	virtual int Extract(const ClassFieldDesc* fields, int numFields, void* objectPtr) = 0;
+	//! Fills an array of numObjects objects (objectSize bytes apart) from the table rows stored at integer keys: row at key i fills object i (i-1 in Lua); returns number of rows filled
+	virtual int ExtractRows(const ClassFieldDesc* fields, int numFields, void* objects, int objectSize, int numObjects) = 0;
+
+	//! Releases the view
+	virtual void Release() = 0;
+};
+
+//! Helper class to manage table view
+class ScriptTableViewPtr
+{
+private:
+	ScriptTableView* m_view; //!< Handled view
+public:
+	ScriptTableViewPtr(ScriptTableView* view = NULL) :
+		m_view(view)
+	{}
+
+	~ScriptTableViewPtr()
+	{
+		if (m_view)
+			m_view->Release();
+	}
+
+	inline void operator = (ScriptTableView* view)
+	{
+		if (m_view)
+			m_view->Release();
+		m_view = view;
+	}
+
+	inline operator ScriptTableView* () const { return m_view; }
+
+	inline ScriptTableView* operator -> ()
+	{
+		return m_view;
+	}
+};
+
+//! Matches table keys against fields of a schema and stores values into object's fields; used by ScriptTableView implementations
+class ScriptFieldMatcher
+{
+private:
+	const ClassFieldDesc* m_fields; //!< Schema
+	int m_numFields; //!< Number of fields in the schema
+	vector<int> m_lengths; //!< Lengths of field names
+	int m_next; //!< Field following the last matched one
+
+public:
+	ScriptFieldMatcher(const ClassFieldDesc* fields, int numFields);
+
+	//! Finds field of the given name; starts at the field following the last match so that rows with the same key order match each key at first try
+	const ClassFieldDesc* Find(const char* name, int length);
+	//! Stores value into the field of object at objectPtr converting between numeric types; returns false if the value can't be converted
+	static bool Store(const ClassFieldDesc* field, const ScriptValue& value, void* objectPtr);
+};
+
 /**
  *	An interface to logger registered for a context.
  */
@@ -203,6 +417,47 @@ public:
 	virtual void Output(const char* text, ...) = 0;
 };
 
+//! Tunable options of a script context; see ScriptContext::SetOption()
+enum ScriptContextOption
+{
+	ScriptContextOption_Jit = 0,		//!< Enables (non-zero) or disables (zero) the JIT compiler
+	ScriptContextOption_JitThreshold,	//!< Number of calls after which a function gets compiled by the JIT compiler
+	ScriptContextOption_GcGenerational,	//!< Switches the garbage collector to generational (non-zero) or incremental (zero) mode
+	ScriptContextOption_GcMinorMul,		//!< Generational mode: memory allocated between minor collections, in percent of the heap after the last major collection
+	ScriptContextOption_GcMajorMul,		//!< Generational mode: heap growth (in percent) since the last major collection that triggers another one
+	ScriptContextOption_GcStepWork,		//!< Work budget of a single garbage collection step (CollectGarbage(false)); units are language specific
+	ScriptContextOption_GcBackgroundFree,	//!< Returns big blocks of collected objects to the system on a worker thread (non-zero) or during collection (zero); objects are still destructed during collection
+	ScriptContextOption_GcMinorHeapSize,	//!< Size of the minor heap (young generation) in kilobytes
+	ScriptContextOption_GcSpaceOverhead,	//!< Major collector speed: memory wasted on garbage in percent of live data; smaller values collect harder
+	ScriptContextOption_GcHeapIncrement,	//!< Amount the major heap grows by when it is full, in kilobytes
+
+	ScriptContextOption_Count
+};
+
+//! Garbage collector counters of a script context; see ScriptContext::GetGcStats()
+//! Counters a language doesn't track are zero
+struct ScriptGcStats
+{
+	double m_minorBytes;		//!< Bytes allocated in the minor heap (young generation)
+	double m_promotedBytes;		//!< Bytes promoted from the minor to the major heap
+	double m_majorBytes;		//!< Bytes allocated in the major heap, including promoted bytes
+	int m_minorCollections;		//!< Number of minor collections
+	int m_majorCollections;		//!< Number of finished major collection cycles
+	int m_compactions;		//!< Number of heap compactions
+	size_t m_heapSize;		//!< Current heap size in bytes
+	size_t m_topHeapSize;		//!< Largest heap size in bytes
+	int m_stringRehashWork;		//!< Interned strings moved by string table resizing since the previous GetGcStats() call
+	int m_stringCount;		//!< Number of interned strings
+	int m_stringTableSize;		//!< Number of slots of the string intern table; m_stringCount / m_stringTableSize is its load factor
+
+	ScriptGcStats() :
+		m_minorBytes(0), m_promotedBytes(0), m_majorBytes(0),
+		m_minorCollections(0), m_majorCollections(0), m_compactions(0),
+		m_heapSize(0), m_topHeapSize(0), m_stringRehashWork(0),
+		m_stringCount(0), m_stringTableSize(0)
+	{}
+};
+
 /**
  *	Language independent script context interface.
  *
@@ -221,6 +476,10 @@ public:
 	virtual void SetLogger(ScriptLogger* logger)= 0;
 	//! Collects garbage; by default performs single gc step (if supported)
 	virtual void CollectGarbage(bool full = false) = 0;
+	//! Sets context option; returns false if the option isn't supported by the language (or by the way it was built)
+	virtual bool SetOption(ScriptContextOption option, int value) = 0;
+	//! Retrieves garbage collector counters; returns false if the language doesn't track any
+	virtual bool GetGcStats(ScriptGcStats& stats) = 0;
 
 	//! Executes the script given as string; returns true on success, false otherwise
 	virtual bool ExecuteString(const char* string) = 0;
@@ -235,6 +494,11 @@ public:
 	//! Registers user supplied class
 	virtual bool RegisterUserClass(ClassDesc* desc) = 0;
 
+	//! Invokes script method with the same integer arguments on each of the objects; returns number of successful calls
+	//! The method is resolved once per class (so objects grouped by class are fastest); a failed call doesn't abort the others
+	//! and, if results array is given, results[i] is set to whether the call on objects[i] succeeded
+	virtual int InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args = NULL, int numArgs = 0, bool* results = NULL) = 0;
+
 	//! Creates context for a given language name
 	static ScriptContext* Create(const char* languageName, int stackSize = 1 << 16);
 
@@ -12,12 +12,14 @@
 #include "sqstdaux.h"
 #include "sqvm.h"
 
-#include "SquirrelScriptStack.h"
 #include "SquirrelScriptContext.h"
+#include "SquirrelScriptStack.h"
 
 SquirrelScriptObject::SquirrelScriptObject() :
 	m_lockedByScript(false)
-{}
+{
+	sq_resetobject(&m_instance);
+}
 
 void SquirrelScriptObject::Release()
 {
@@ -26,7 +28,8 @@ void SquirrelScriptObject::Release()
 }
 
 SquirrelScriptContext::SquirrelScriptContext() :
-	m_vm(NULL)
+	m_vm(NULL),
+	m_gcStepWork(0)
 {}
 
 SquirrelScriptContext::~SquirrelScriptContext()
@@ -48,6 +51,7 @@ SquirrelScriptContext* SquirrelScriptContext::CreateContext(int stackSize)
 	sq_pushroottable(vm);
 
 	// Register stdlibs
+	sqstd_register_bloblib(vm);
 	sqstd_register_iolib(vm);
 	sqstd_register_mathlib(vm);
 	sqstd_register_stringlib(vm);
@@ -65,7 +69,29 @@ void SquirrelScriptContext::SetLogger(ScriptLogger* logger)
 
 void SquirrelScriptContext::CollectGarbage(bool full)
 {
-	sq_collectgarbage(m_vm);
+	if (full)
+		sq_collectgarbage(m_vm);
+	else
+		sq_collectgarbagestep(m_vm, m_gcStepWork);
+}
+
+bool SquirrelScriptContext::SetOption(ScriptContextOption option, int value)
+{
+	switch (option)
+	{
+		case ScriptContextOption_GcStepWork:
+			if (value <= 0)
+				return false;
+			m_gcStepWork = value;
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool SquirrelScriptContext::GetGcStats(ScriptGcStats& stats)
+{
+	return false;
 }
 
 bool SquirrelScriptContext::ExecuteString(const char* string)
@@ -140,15 +166,35 @@ bool SquirrelScriptContext::RegisterUserClass(ClassDesc* desc)
 	MultiScriptAssert(desc->m_constructor);
 	MultiScriptAssert(desc->m_destructor);
 
+	// Super class has to exist before the derived one is created
+	if (desc->m_superClass && !FindClassInfo(desc->m_superClass))
+		RegisterUserClass(desc->m_superClass);
+
+	desc->AssignTypeId();
+
 	SquirrelClassInfo* classInfo = new SquirrelClassInfo();
 	classInfo->m_desc = desc;
 	classInfo->m_context = this;
+	desc->GetAllOperators(classInfo->m_operators);
+	desc->GetAllFields(classInfo->m_fields);
+	classInfo->m_toStringMethod = desc->GetToStringMethod();
 
 	// Create class
+	sq_pushroottable(m_vm);
 	sq_pushstring(m_vm, desc->m_name, -1);
 
-	// TODO: Handle subclass via 2nd parameter
-	sq_newclass(m_vm, SQFalse);
+	if (desc->m_superClass)
+	{
+		// Push base class; Squirrel copies all of its members into the new class so the method lookup is flat
+		sq_pushstring(m_vm, desc->m_superClass->m_name, -1);
+		sq_get(m_vm, -3);
+		MultiScriptAssert( sq_gettype(m_vm, -1) == OT_CLASS );
+	}
+
+	sq_newclass(m_vm, desc->m_superClass ? SQTrue : SQFalse);
+
+	// Tag the class with its info so that instances can be identified
+	sq_settypetag(m_vm, -1, classInfo);
 
 	// Add methods
 	for (unsigned int i = 0; i < desc->m_methods.size(); ++i)
@@ -160,6 +206,45 @@ bool SquirrelScriptContext::RegisterUserClass(ClassDesc* desc)
 		sq_createslot(m_vm, -3);
 	}
 
+	// Add operators as metamethods; there's no less-than nor length metamethod in Squirrel so these map to _cmp and len() method
+	static const char* operatorMetamethods[ClassOperator_Count] = {"_add", "_sub", "_mul", NULL, "_cmp", NULL, NULL, "len", "_call"};
+	for (int i = 0; i < ClassOperator_Count; ++i)
+		if (classInfo->m_operators[i] && operatorMetamethods[i])
+		{
+			sq_pushstring(m_vm, operatorMetamethods[i], -1);
+			sq_pushuserpointer(m_vm, classInfo);
+			sq_pushinteger(m_vm, i);
+			sq_newclosure(m_vm, SquirrelClassOperatorCallback, 2);
+			sq_createslot(m_vm, -3);
+		}
+
+	// Keep references to interned field names
+	for (unsigned int i = 0; i < classInfo->m_fields.size(); ++i)
+	{
+		HSQOBJECT name;
+		sq_pushstring(m_vm, classInfo->m_fields[i].m_name, -1);
+		sq_getstackobj(m_vm, -1, &name);
+		sq_addref(m_vm, &name);
+		sq_pop(m_vm, 1);
+		classInfo->m_sqFieldNames.push_back(name);
+	}
+
+	// Add field accessors; these are invoked only when there's no member of that name and fall back to index operators
+	if (classInfo->m_fields.size() || classInfo->m_operators[ClassOperator_Index])
+	{
+		sq_pushstring(m_vm, "_get", -1);
+		sq_pushuserpointer(m_vm, classInfo);
+		sq_newclosure(m_vm, SquirrelClassGetCallback, 1);
+		sq_createslot(m_vm, -3);
+	}
+	if (classInfo->m_fields.size() || classInfo->m_operators[ClassOperator_NewIndex])
+	{
+		sq_pushstring(m_vm, "_set", -1);
+		sq_pushuserpointer(m_vm, classInfo);
+		sq_newclosure(m_vm, SquirrelClassSetCallback, 1);
+		sq_createslot(m_vm, -3);
+	}
+
 	// Add constructor
 	sq_pushstring(m_vm, "constructor", -1);
 	sq_pushuserpointer(m_vm, classInfo);
@@ -188,12 +273,77 @@ bool SquirrelScriptContext::RegisterUserClass(ClassDesc* desc)
 
 	// Add class to root table
 	sq_createslot(m_vm, -3);
+	sq_pop(m_vm, 1);
 
 	// Add class info
 	m_classes.push_back(classInfo);
 	return true;
 }
 
+int SquirrelScriptContext::InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args, int numArgs, bool* results)
+{
+	const int top = sq_gettop(m_vm);
+
+	HSQOBJECT currentClass;
+	sq_resetobject(&currentClass);
+	HSQOBJECT method;
+	sq_resetobject(&method);
+
+	int numSucceeded = 0;
+	for (int i = 0; i < numObjects; ++i)
+	{
+		bool succeeded = false;
+		SquirrelScriptObject* scriptObject = (SquirrelScriptObject*) objects[i];
+		if (scriptObject && scriptObject->m_objectPtr && sq_type(scriptObject->m_instance) == OT_INSTANCE)
+		{
+			// Objects are usually grouped by class, so method is only looked up when class changes;
+			// the class of an instance may be a script class derived from the registered one
+			sq_pushobject(m_vm, scriptObject->m_instance);
+			sq_getclass(m_vm, -1);
+			HSQOBJECT instanceClass;
+			sq_getstackobj(m_vm, -1, &instanceClass);
+			if (instanceClass._unVal.pClass != currentClass._unVal.pClass)
+			{
+				currentClass = instanceClass;
+				sq_resetobject(&method);
+
+				sq_pushstring(m_vm, methodName, -1);
+				if (SQ_SUCCEEDED(sq_rawget(m_vm, -2)))
+				{
+					sq_getstackobj(m_vm, -1, &method); // Class keeps the method alive
+					sq_pop(m_vm, 1);
+				}
+
+				if (sq_type(method) != OT_CLOSURE && sq_type(method) != OT_NATIVECLOSURE)
+				{
+					sq_resetobject(&method);
+					if (m_logger)
+						m_logger->Output("Method '%s' not found in class '%s'\n", methodName, scriptObject->m_classInfo->m_desc->m_name);
+				}
+			}
+			sq_pop(m_vm, 2); // Pop class and instance
+
+			if (sq_type(method) != OT_NULL)
+			{
+				sq_pushobject(m_vm, method);
+				sq_pushobject(m_vm, scriptObject->m_instance);
+				for (int j = 0; j < numArgs; ++j)
+					sq_pushinteger(m_vm, args[j]);
+				succeeded = SQ_SUCCEEDED(sq_call(m_vm, 1 + numArgs, SQFalse, SQTrue));
+				sq_pop(m_vm, 1); // Pop method
+			}
+		}
+
+		if (results)
+			results[i] = succeeded;
+		if (succeeded)
+			numSucceeded++;
+	}
+
+	MultiScriptAssert( sq_gettop(m_vm) == top );
+	return numSucceeded;
+}
+
 SquirrelClassInfo* SquirrelScriptContext::FindClassInfo(ClassDesc* classDesc)
 {
 	for (unsigned int i = 0; i < m_classes.size(); ++i)
@@ -253,6 +403,7 @@ int SquirrelScriptContext::SquirrelClassConstructorCallback(HSQUIRRELVM vm)
 	// There is already an instance on the stack (pushed automatically when constructor was invoked from script)
 	// Attach our object to created instance
 	sq_setinstanceup(vm, -1, scriptObject);
+	sq_getstackobj(vm, -1, &scriptObject->m_instance);
 
 	// Set garbage collection callback for this instance
 	sq_setreleasehook(vm, -1, SquirrelClassGCCallback);
@@ -262,15 +413,12 @@ int SquirrelScriptContext::SquirrelClassConstructorCallback(HSQUIRRELVM vm)
 
 int SquirrelScriptContext::SquirrelClassDestructorCallback(HSQUIRRELVM vm)
 {
-	// Get class info
+	// Pop class info; the method might be inherited from the super class so use object's own class info instead
 	MultiScriptAssert( sq_gettype(vm, -1) == OT_USERPOINTER );
-	void* userPtr = NULL;
-	sq_getuserpointer(vm, -1, &userPtr);
 	sq_pop(vm, 1);
 
-	SquirrelClassInfo* classInfo = (SquirrelClassInfo*) userPtr;
-
 	// Get the instance
+	void* userPtr = NULL;
 	MultiScriptAssert( sq_gettype(vm, 1) == OT_INSTANCE );
 	sq_getinstanceup(vm, 1, &userPtr, 0);
 	SquirrelScriptObject* scriptObject = (SquirrelScriptObject*) userPtr;
@@ -278,7 +426,7 @@ int SquirrelScriptContext::SquirrelClassDestructorCallback(HSQUIRRELVM vm)
 
 	// Invoke user supplied destructor
 	scriptObject->m_lockedByScript = true;
-	classInfo->m_desc->m_destructor(scriptObject);
+	scriptObject->m_classInfo->m_desc->m_destructor(scriptObject);
 	scriptObject->m_lockedByScript = false;
 	scriptObject->m_objectPtr = NULL;
 
@@ -323,10 +471,10 @@ int SquirrelScriptContext::SquirrelClassToStringMethodCallback(HSQUIRRELVM vm)
 
 	// Invoke to-string method
 	char buffer[1 << 8];
-	if (classInfo->m_desc->m_toStringMethod)
+	if (classInfo->m_toStringMethod)
 	{
 		SquirrelScriptStack stack(classInfo->m_context, false);
-		const bool result = classInfo->m_desc->m_toStringMethod(scriptObject, buffer, 1 << 8);
+		const bool result = classInfo->m_toStringMethod(scriptObject, buffer, 1 << 8);
 		MultiScriptAssert( result );
 		MultiScriptAssert( stack.m_numPushed == 0 );
 	}
@@ -367,6 +515,194 @@ int SquirrelScriptContext::SquirrelClassMethodCallback(HSQUIRRELVM vm)
 	return stack.m_numPushed;
 }
 
+int SquirrelScriptContext::SquirrelClassOperatorCallback(HSQUIRRELVM vm)
+{
+	// Get class info
+	MultiScriptAssert( sq_gettype(vm, -1) == OT_USERPOINTER );
+	void* userPtr = NULL;
+	sq_getuserpointer(vm, -1, &userPtr);
+	sq_pop(vm, 1);
+
+	SquirrelClassInfo* classInfo = (SquirrelClassInfo*) userPtr;
+
+	// Get operator index
+	MultiScriptAssert( sq_gettype(vm, -1) == OT_INTEGER );
+
+	int operatorIndex;
+	sq_getinteger(vm, -1, &operatorIndex);
+	sq_pop(vm, 1);
+
+	// Get the instance
+	MultiScriptAssert( sq_gettype(vm, 1) == OT_INSTANCE );
+	sq_getinstanceup(vm, 1, &userPtr, 0);
+	SquirrelScriptObject* scriptObject = (SquirrelScriptObject*) userPtr;
+	MultiScriptAssert(scriptObject->m_objectPtr);
+
+	// Remove call environment
+	if (operatorIndex == ClassOperator_Call)
+		sq_remove(vm, 2);
+
+	if (operatorIndex != ClassOperator_Lt)
+	{
+		SquirrelScriptStack stack(classInfo->m_context, false);
+		const bool result = classInfo->m_operators[operatorIndex](scriptObject, &stack);
+		MultiScriptAssert( result );
+
+		return stack.m_numPushed;
+	}
+
+	// Emulate _cmp via less-than and (optional) equality operators
+	int compareResult = 1;
+	{
+		SquirrelScriptStack stack(classInfo->m_context, false);
+		sq_push(vm, 2); // Keep the right operand for equality test
+		const bool result = classInfo->m_operators[ClassOperator_Lt](scriptObject, &stack);
+		MultiScriptAssert( result );
+		MultiScriptAssert( stack.m_numPushed == 1 );
+
+		int isLess;
+		sq_getinteger(vm, -1, &isLess);
+		sq_pop(vm, 1);
+		if (isLess)
+			compareResult = -1;
+	}
+	if (compareResult > 0 && classInfo->m_operators[ClassOperator_Eq])
+	{
+		SquirrelScriptStack stack(classInfo->m_context, false);
+		const bool result = classInfo->m_operators[ClassOperator_Eq](scriptObject, &stack);
+		MultiScriptAssert( result );
+		MultiScriptAssert( stack.m_numPushed == 1 );
+
+		int isEqual;
+		sq_getinteger(vm, -1, &isEqual);
+		sq_pop(vm, 1);
+		if (isEqual)
+			compareResult = 0;
+	}
+
+	sq_pushinteger(vm, compareResult);
+	return 1;
+}
+
+int SquirrelScriptContext::FindField(SquirrelClassInfo* classInfo, const HSQOBJECT& name)
+{
+	// Strings are interned so comparing references is enough
+	if (name._type != OT_STRING)
+		return -1;
+	for (unsigned int i = 0; i < classInfo->m_sqFieldNames.size(); ++i)
+		if (classInfo->m_sqFieldNames[i]._unVal.pString == name._unVal.pString)
+			return i;
+	return -1;
+}
+
+int SquirrelScriptContext::SquirrelClassGetCallback(HSQUIRRELVM vm)
+{
+	// Get class info
+	MultiScriptAssert( sq_gettype(vm, -1) == OT_USERPOINTER );
+	void* userPtr = NULL;
+	sq_getuserpointer(vm, -1, &userPtr);
+	sq_pop(vm, 1);
+
+	SquirrelClassInfo* classInfo = (SquirrelClassInfo*) userPtr;
+
+	// Get the instance
+	MultiScriptAssert( sq_gettype(vm, 1) == OT_INSTANCE );
+	sq_getinstanceup(vm, 1, &userPtr, 0);
+	SquirrelScriptObject* scriptObject = (SquirrelScriptObject*) userPtr;
+	MultiScriptAssert(scriptObject->m_objectPtr);
+
+	// Read the field directly from object's memory
+	HSQOBJECT key;
+	sq_getstackobj(vm, 2, &key);
+	const int fieldIndex = FindField(classInfo, key);
+	if (fieldIndex != -1)
+	{
+		const ClassFieldDesc& field = classInfo->m_fields[fieldIndex];
+		void* fieldPtr = field.GetFieldPtr(scriptObject->m_objectPtr);
+
+		switch (field.m_type)
+		{
+			case ClassFieldType_Int: sq_pushinteger(vm, *(int*) fieldPtr); break;
+			case ClassFieldType_Float: sq_pushfloat(vm, *(float*) fieldPtr); break;
+			case ClassFieldType_Bool: sq_pushbool(vm, *(bool*) fieldPtr ? SQTrue : SQFalse); break;
+		}
+		return 1;
+	}
+
+	// Fall back to index operator
+	if (!classInfo->m_operators[ClassOperator_Index])
+		return sq_throwerror(vm, "the index doesn't exist");
+
+	SquirrelScriptStack stack(classInfo->m_context, false);
+	const bool result = classInfo->m_operators[ClassOperator_Index](scriptObject, &stack);
+	MultiScriptAssert( result );
+
+	return stack.m_numPushed;
+}
+
+int SquirrelScriptContext::SquirrelClassSetCallback(HSQUIRRELVM vm)
+{
+	// Get class info
+	MultiScriptAssert( sq_gettype(vm, -1) == OT_USERPOINTER );
+	void* userPtr = NULL;
+	sq_getuserpointer(vm, -1, &userPtr);
+	sq_pop(vm, 1);
+
+	SquirrelClassInfo* classInfo = (SquirrelClassInfo*) userPtr;
+
+	// Get the instance
+	MultiScriptAssert( sq_gettype(vm, 1) == OT_INSTANCE );
+	sq_getinstanceup(vm, 1, &userPtr, 0);
+	SquirrelScriptObject* scriptObject = (SquirrelScriptObject*) userPtr;
+	MultiScriptAssert(scriptObject->m_objectPtr);
+
+	// Write the field directly to object's memory
+	HSQOBJECT key;
+	sq_getstackobj(vm, 2, &key);
+	const int fieldIndex = FindField(classInfo, key);
+	if (fieldIndex != -1)
+	{
+		const ClassFieldDesc& field = classInfo->m_fields[fieldIndex];
+		void* fieldPtr = field.GetFieldPtr(scriptObject->m_objectPtr);
+
+		switch (field.m_type)
+		{
+			case ClassFieldType_Int:
+			{
+				SQInteger value;
+				if (SQ_FAILED(sq_getinteger(vm, 3, &value))) return sq_throwerror(vm, "integer expected");
+				*(int*) fieldPtr = (int) value;
+				break;
+			}
+			case ClassFieldType_Float:
+			{
+				SQFloat value;
+				if (SQ_FAILED(sq_getfloat(vm, 3, &value))) return sq_throwerror(vm, "float expected");
+				*(float*) fieldPtr = (float) value;
+				break;
+			}
+			case ClassFieldType_Bool:
+			{
+				SQBool value;
+				sq_tobool(vm, 3, &value);
+				*(bool*) fieldPtr = value != SQFalse;
+				break;
+			}
+		}
+		return 0;
+	}
+
+	// Fall back to new-index operator
+	if (!classInfo->m_operators[ClassOperator_NewIndex])
+		return sq_throwerror(vm, "the index doesn't exist");
+
+	SquirrelScriptStack stack(classInfo->m_context, false);
+	const bool result = classInfo->m_operators[ClassOperator_NewIndex](scriptObject, &stack);
+	MultiScriptAssert( result );
+
+	return stack.m_numPushed;
+}
+
 int SquirrelScriptContext::SquirrelFunctionCallback(HSQUIRRELVM vm)
 {
 	MultiScriptAssert( sq_gettype(vm, -1) == OT_USERPOINTER );
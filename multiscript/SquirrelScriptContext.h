@@ -12,12 +12,18 @@ struct SquirrelClassInfo
 {
 	SquirrelScriptContext* m_context;
 	ClassDesc* m_desc;
+
+	GenericClassMethod m_operators[ClassOperator_Count]; //!< Overloaded operators of the class and all of its super classes
+	vector<ClassFieldDesc> m_fields; //!< Flattened fields of the class and all of its super classes
+	vector<HSQOBJECT> m_sqFieldNames; //!< Interned field names; field lookup only compares these
+	GenericClassToStringMethod m_toStringMethod; //!< To-string method of the class or of its nearest super class that has one
 };
 
 class SquirrelScriptObject : public ScriptObject
 {
 public:
 	SquirrelClassInfo* m_classInfo;
+	HSQOBJECT m_instance; //!< Weak reference to the script instance holding this object
 	bool m_lockedByScript;
 
 	SquirrelScriptObject();
@@ -31,8 +37,10 @@ class SquirrelScriptContext : public ScriptContext
 {
 	friend class SquirrelScriptCall;
 	friend class SquirrelScriptStack;
+	friend class SquirrelScriptTableView;
 private:
 	HSQUIRRELVM m_vm;
+	int m_gcStepWork; //!< Objects plus references visited by one cycle collection step; 0 uses the VM default
 	std::vector<SquirrelFunctionInfo*> m_functions;
 	std::vector<SquirrelClassInfo*> m_classes;
 
@@ -46,11 +54,14 @@ public:
 
 	void SetLogger(ScriptLogger* logger);
 	void CollectGarbage(bool full);
+	bool SetOption(ScriptContextOption option, int value);
+	bool GetGcStats(ScriptGcStats& stats);
 	bool ExecuteString(const char* string);
 	ScriptStack* BeginCall(FunctionDesc* desc);
 	ScriptStack* BeginCall(const char* name);
 	bool RegisterFunction(FunctionDesc* desc);
 	bool RegisterUserClass(ClassDesc* desc);
+	int InvokeMethodOnAll(const char* methodName, ScriptObject** objects, int numObjects, const int* args, int numArgs, bool* results);
 
 protected:
 	SquirrelClassInfo* FindClassInfo(ClassDesc* classDesc);
@@ -64,5 +75,9 @@ protected:
 	static int SquirrelClassGCCallback(HSQUIRRELVM vm);
 	static int SquirrelClassToStringMethodCallback(HSQUIRRELVM vm);
 	static int SquirrelClassMethodCallback(HSQUIRRELVM vm);
+	static int SquirrelClassOperatorCallback(HSQUIRRELVM vm);
+	static int FindField(SquirrelClassInfo* classInfo, const HSQOBJECT& name);
+	static int SquirrelClassGetCallback(HSQUIRRELVM vm);
+	static int SquirrelClassSetCallback(HSQUIRRELVM vm);
 	static int SquirrelFunctionCallback(HSQUIRRELVM vm);
 };
\ No newline at end of file
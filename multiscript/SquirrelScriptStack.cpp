@@ -51,6 +51,33 @@ ScriptObject* SquirrelScriptStack::PopScriptObject()
 	return (SquirrelScriptObject*) userPtr;
 }
 
+ScriptObject* SquirrelScriptStack::PopScriptObject(ClassDesc* expected)
+{
+	if (sq_gettype(m_context->m_vm, -1) != OT_INSTANCE) return NULL;
+
+	// Registered classes are tagged with their class info
+	SQUserPointer typeTag = NULL;
+	sq_gettypetag(m_context->m_vm, -1, &typeTag);
+	SquirrelClassInfo* classInfo = (SquirrelClassInfo*) typeTag;
+	if (!classInfo || !classInfo->m_desc->IsKindOf(expected)) return NULL;
+
+	return PopScriptObject();
+}
+
+ScriptTableView* SquirrelScriptStack::PopTable()
+{
+	const SQObjectType type = sq_gettype(m_context->m_vm, -1);
+	if (type != OT_TABLE && type != OT_ARRAY) return NULL;
+
+	HSQOBJECT table;
+	sq_getstackobj(m_context->m_vm, -1, &table);
+	sq_addref(m_context->m_vm, &table);
+	sq_pop(m_context->m_vm, 1);
+
+	m_numParams--;
+	return new SquirrelScriptTableView(m_context, table);
+}
+
 bool SquirrelScriptStack::PushInt(int value)
 {
 	sq_pushinteger(m_context->m_vm, value);
@@ -67,11 +94,10 @@ bool SquirrelScriptStack::PushString(const char* string, int length)
 
 bool SquirrelScriptStack::PushScriptObject(ScriptObject* object)
 {
-	MultiScriptAssert(false);
-	// TODO: Implement me!!!
-
+	SquirrelScriptObject* scriptObject = (SquirrelScriptObject*) object;
+	sq_pushobject(m_context->m_vm, scriptObject->m_instance);
 	m_numPushed++;
-	return false;
+	return sq_gettype(m_context->m_vm, -1) == OT_INSTANCE;
 }
 
 ScriptObject* SquirrelScriptStack::PushNewScriptObject(ClassDesc* classDesc, void* objectPtr)
@@ -84,9 +110,11 @@ ScriptObject* SquirrelScriptStack::PushNewScriptObject(ClassDesc* classDesc, voi
 	}
 
 	SquirrelScriptObject* scriptObject = new SquirrelScriptObject();
+	scriptObject->m_classInfo = classInfo;
 	scriptObject->m_objectPtr = objectPtr;
 
-	// Find the class
+	// Find the class; don't rely on the root table being at the bottom of the stack (it's not there within operators)
+	sq_pushroottable(m_context->m_vm);
 	sq_pushstring(m_context->m_vm, classDesc->m_name, -1);
 	sq_get(m_context->m_vm, -2);
 	MultiScriptAssert( sq_gettype(m_context->m_vm, -1) == OT_CLASS );
@@ -94,14 +122,89 @@ ScriptObject* SquirrelScriptStack::PushNewScriptObject(ClassDesc* classDesc, voi
 	// Create instance
 	sq_createinstance(m_context->m_vm, -1);
 	sq_setinstanceup(m_context->m_vm, -1, scriptObject);
+	sq_getstackobj(m_context->m_vm, -1, &scriptObject->m_instance);
+	if (classDesc->m_garbageCollect)
+		sq_setreleasehook(m_context->m_vm, -1, SquirrelScriptContext::SquirrelClassGCCallback);
 
-	// Remove class from the stack
+	// Remove class and root table from the stack
+	sq_remove(m_context->m_vm, -2);
 	sq_remove(m_context->m_vm, -2);
 
 	m_numPushed++;
 	return scriptObject;
 }
 
+// Pushes a single array or table element
+static inline void SquirrelPushValue(HSQUIRRELVM vm, int value) { sq_pushinteger(vm, value); }
+static inline void SquirrelPushValue(HSQUIRRELVM vm, float value) { sq_pushfloat(vm, value); }
+static inline void SquirrelPushValue(HSQUIRRELVM vm, const char* value) { sq_pushstring(vm, value, -1); }
+
+template <typename T>
+static void SquirrelPushArray(HSQUIRRELVM vm, const T* values, int count)
+{
+	sq_newarray(vm, count);
+	for (int i = 0; i < count; i++)
+	{
+		sq_pushinteger(vm, i);
+		SquirrelPushValue(vm, values[i]);
+		sq_rawset(vm, -3);
+	}
+}
+
+template <typename T>
+static void SquirrelPushTable(HSQUIRRELVM vm, const char** keys, const T* values, int count)
+{
+	sq_newtableex(vm, count);
+	for (int i = 0; i < count; i++)
+	{
+		sq_pushstring(vm, keys[i], -1);
+		SquirrelPushValue(vm, values[i]);
+		sq_rawset(vm, -3);
+	}
+}
+
+bool SquirrelScriptStack::PushArray(const int* values, int count)
+{
+	SquirrelPushArray(m_context->m_vm, values, count);
+	m_numPushed++;
+	return true;
+}
+
+bool SquirrelScriptStack::PushArray(const float* values, int count)
+{
+	SquirrelPushArray(m_context->m_vm, values, count);
+	m_numPushed++;
+	return true;
+}
+
+bool SquirrelScriptStack::PushArray(const char** strings, int count)
+{
+	SquirrelPushArray(m_context->m_vm, strings, count);
+	m_numPushed++;
+	return true;
+}
+
+bool SquirrelScriptStack::PushTable(const char** keys, const int* values, int count)
+{
+	SquirrelPushTable(m_context->m_vm, keys, values, count);
+	m_numPushed++;
+	return true;
+}
+
+bool SquirrelScriptStack::PushTable(const char** keys, const float* values, int count)
+{
+	SquirrelPushTable(m_context->m_vm, keys, values, count);
+	m_numPushed++;
+	return true;
+}
+
+bool SquirrelScriptStack::PushTable(const char** keys, const char** values, int count)
+{
+	SquirrelPushTable(m_context->m_vm, keys, values, count);
+	m_numPushed++;
+	return true;
+}
+
 bool SquirrelScriptStack::EndCall()
 {
 	MultiScriptAssert(m_isCall);
@@ -125,4 +228,165 @@ void SquirrelScriptStack::ReleaseAfterCall()
 	MultiScriptAssert(m_isCall);
 	sq_pop(m_context->m_vm, 2); // Pop function and root table
 	delete this;
+}
+
+//---------------------------------------------------------
+// Table view
+//---------------------------------------------------------
+
+// Reads key or value of a table slot
+static void SquirrelGetValue(HSQUIRRELVM vm, int index, ScriptValue& value)
+{
+	switch (sq_gettype(vm, index))
+	{
+	case OT_NULL:
+		value.m_type = ScriptValueType_Null;
+		break;
+	case OT_INTEGER:
+	{
+		SQInteger integer;
+		sq_getinteger(vm, index, &integer);
+		value.m_type = ScriptValueType_Int;
+		value.m_int = (int) integer;
+		break;
+	}
+	case OT_FLOAT:
+	{
+		SQFloat number;
+		sq_getfloat(vm, index, &number);
+		value.m_type = ScriptValueType_Float;
+		value.m_float = (float) number;
+		break;
+	}
+	case OT_BOOL:
+	{
+		SQBool boolean;
+		sq_getbool(vm, index, &boolean);
+		value.m_type = ScriptValueType_Bool;
+		value.m_int = boolean ? 1 : 0;
+		break;
+	}
+	case OT_STRING:
+		value.m_type = ScriptValueType_String;
+		sq_getstring(vm, index, &value.m_string);
+		value.m_length = (int) sq_getsize(vm, index);
+		break;
+	default:
+		value.m_type = ScriptValueType_Other;
+		break;
+	}
+}
+
+// Fills the object from the table on top of the stack in a single sq_next traversal
+static int SquirrelExtract(HSQUIRRELVM vm, ScriptFieldMatcher& matcher, void* objectPtr)
+{
+	int numFilled = 0;
+	ScriptValue value;
+	sq_pushnull(vm);
+	while (SQ_SUCCEEDED(sq_next(vm, -2)))
+	{
+		if (sq_gettype(vm, -2) == OT_STRING)
+		{
+			const SQChar* name;
+			sq_getstring(vm, -2, &name);
+			const ClassFieldDesc* field = matcher.Find(name, (int) sq_getsize(vm, -2));
+			if (field)
+			{
+				SquirrelGetValue(vm, -1, value);
+				if (ScriptFieldMatcher::Store(field, value, objectPtr))
+					numFilled++;
+			}
+		}
+		sq_pop(vm, 2);
+	}
+	sq_pop(vm, 1);
+	return numFilled;
+}
+
+SquirrelScriptTableView::SquirrelScriptTableView(SquirrelScriptContext* context, HSQOBJECT table) :
+	m_context(context),
+	m_table(table),
+	m_iterator(0),
+	m_started(false),
+	m_finished(false)
+{}
+
+int SquirrelScriptTableView::GetCount()
+{
+	sq_pushobject(m_context->m_vm, m_table);
+	const int count = (int) sq_getsize(m_context->m_vm, -1);
+	sq_pop(m_context->m_vm, 1);
+	return count;
+}
+
+void SquirrelScriptTableView::Reset()
+{
+	m_started = false;
+	m_finished = false;
+}
+
+bool SquirrelScriptTableView::Next(ScriptValue& key, ScriptValue& value)
+{
+	if (m_finished) return false;
+
+	HSQUIRRELVM vm = m_context->m_vm;
+	sq_pushobject(vm, m_table);
+	if (m_started) sq_pushinteger(vm, m_iterator);
+	else sq_pushnull(vm);
+	m_started = true;
+
+	if (SQ_FAILED(sq_next(vm, -2)))
+	{
+		sq_pop(vm, 2);
+		m_finished = true;
+		return false;
+	}
+
+	// Strings stay valid after popping since the table references them
+	SquirrelGetValue(vm, -2, key);
+	SquirrelGetValue(vm, -1, value);
+	sq_getinteger(vm, -3, &m_iterator);
+	sq_pop(vm, 4);
+	return true;
+}
+
+int SquirrelScriptTableView::Extract(const ClassFieldDesc* fields, int numFields, void* objectPtr)
+{
+	ScriptFieldMatcher matcher(fields, numFields);
+	sq_pushobject(m_context->m_vm, m_table);
+	const int numFilled = SquirrelExtract(m_context->m_vm, matcher, objectPtr);
+	sq_pop(m_context->m_vm, 1);
+	return numFilled;
+}
+
+int SquirrelScriptTableView::ExtractRows(const ClassFieldDesc* fields, int numFields, void* objects, int objectSize, int numObjects)
+{
+	HSQUIRRELVM vm = m_context->m_vm;
+	ScriptFieldMatcher matcher(fields, numFields);
+	int numRows = 0;
+
+	sq_pushobject(vm, m_table);
+	sq_pushnull(vm);
+	while (SQ_SUCCEEDED(sq_next(vm, -2)))
+	{
+		if (sq_gettype(vm, -2) == OT_INTEGER && sq_gettype(vm, -1) == OT_TABLE)
+		{
+			SQInteger index;
+			sq_getinteger(vm, -2, &index);
+			if (index >= 0 && index < numObjects)
+			{
+				SquirrelExtract(vm, matcher, (char*) objects + index * objectSize);
+				numRows++;
+			}
+		}
+		sq_pop(vm, 2);
+	}
+	sq_pop(vm, 2);
+	return numRows;
+}
+
+void SquirrelScriptTableView::Release()
+{
+	sq_release(m_context->m_vm, &m_table);
+	delete this;
 }
\ No newline at end of file
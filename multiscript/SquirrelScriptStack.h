@@ -16,12 +16,40 @@ public:
 
 	bool PopInt(int& value);
 	ScriptObject* PopScriptObject();
+	ScriptObject* PopScriptObject(ClassDesc* expected);
+	ScriptTableView* PopTable();
 
 	bool PushInt(int value);
 	bool PushString(const char* string, int length);
 	bool PushScriptObject(ScriptObject* object);
 	ScriptObject* PushNewScriptObject(ClassDesc* classDesc, void* objectPtr);
+	bool PushArray(const int* values, int count);
+	bool PushArray(const float* values, int count);
+	bool PushArray(const char** strings, int count);
+	bool PushTable(const char** keys, const int* values, int count);
+	bool PushTable(const char** keys, const float* values, int count);
+	bool PushTable(const char** keys, const char** values, int count);
 
 	bool EndCall();
 	void ReleaseAfterCall();
 };
+
+class SquirrelScriptTableView : public ScriptTableView
+{
+private:
+	SquirrelScriptContext* m_context;
+	HSQOBJECT m_table; //!< Referenced table or array
+	SQInteger m_iterator; //!< Iterator of the current entry (as updated by sq_next)
+	bool m_started;
+	bool m_finished;
+
+public:
+	SquirrelScriptTableView(SquirrelScriptContext* context, HSQOBJECT table);
+
+	int GetCount();
+	void Reset();
+	bool Next(ScriptValue& key, ScriptValue& value);
+	int Extract(const ClassFieldDesc* fields, int numFields, void* objectPtr);
+	int ExtractRows(const ClassFieldDesc* fields, int numFields, void* objects, int objectSize, int numObjects);
+	void Release();
+};
@@ -1,6 +1,7 @@
 #include "ScriptInterface.h"
 
 #include "windows.h"
+#include <stddef.h>
 
 //---------------------------------------------------------
 // Sample classes
@@ -65,6 +66,41 @@ public:
 		return true;
 	}
 
+	//! Pops the right operand which might be either SampleClass object or an integer
+	static bool PopOperand(ScriptStack* stack, int& value)
+	{
+		ScriptObject* other = stack->PopScriptObject(SampleClass::GetClassDesc_Static());
+		if (!other)
+			return stack->PopInt(value);
+
+		value = ((SampleClass*) other->m_objectPtr)->m_value;
+		return true;
+	}
+
+	static bool Generic_Add(ScriptObject* scriptObject, ScriptStack* stack)
+	{
+		SampleClass* object = (SampleClass*) scriptObject->m_objectPtr;
+		int value;
+		if (!PopOperand(stack, value)) return false;
+		return stack->PushNewScriptObject(SampleClass::GetClassDesc_Static(), new SampleClass(object->m_value + value)) != NULL;
+	}
+
+	static bool Generic_Eq(ScriptObject* scriptObject, ScriptStack* stack)
+	{
+		SampleClass* object = (SampleClass*) scriptObject->m_objectPtr;
+		int value;
+		if (!PopOperand(stack, value)) return false;
+		return stack->PushInt(object->m_value == value);
+	}
+
+	static bool Generic_Lt(ScriptObject* scriptObject, ScriptStack* stack)
+	{
+		SampleClass* object = (SampleClass*) scriptObject->m_objectPtr;
+		int value;
+		if (!PopOperand(stack, value)) return false;
+		return stack->PushInt(object->m_value < value);
+	}
+
 	static ClassDesc* GetClassDesc_Static()
 	{
 		static ClassDesc classDesc;
@@ -81,6 +117,77 @@ public:
 			classDesc.m_toStringMethod = SampleClass::Generic_ToString;
 			classDesc.m_methods.push_back( ClassMethodDesc("SetInt", SampleClass::Generic_SetInt) );
 			classDesc.m_methods.push_back( ClassMethodDesc("GetInt", SampleClass::Generic_GetInt) );
+			classDesc.m_operators.push_back( ClassOperatorDesc(ClassOperator_Add, SampleClass::Generic_Add) );
+			classDesc.m_operators.push_back( ClassOperatorDesc(ClassOperator_Eq, SampleClass::Generic_Eq) );
+			classDesc.m_operators.push_back( ClassOperatorDesc(ClassOperator_Lt, SampleClass::Generic_Lt) );
+			classDesc.m_fields.push_back( ClassFieldDesc("value", ClassFieldType_Int, offsetof(SampleClass, m_value)) );
+		}
+
+		return &classDesc;
+	}
+};
+
+/**
+ *	Sample class derived from SampleClass; all methods of SampleClass are inherited by it on the script side too.
+ */
+class DerivedSampleClass : public SampleClass
+{
+public:
+	int m_multiplier; //!< Multiplier applied to inherited value
+
+	DerivedSampleClass(int multiplier = 2) :
+		m_multiplier(multiplier)
+	{
+	}
+
+	~DerivedSampleClass()
+	{
+		MultiScriptPrintf("CPP: destroyed DerivedSampleClass\n");
+	}
+
+	static void Generic_Constructor(ScriptStack* stack, ScriptObject* scriptObject)
+	{
+		DerivedSampleClass* object = new DerivedSampleClass();
+		stack->PopInt(object->m_multiplier); // Optional parameter; may fail
+
+		scriptObject->m_objectPtr = object;
+	}
+
+	static void Generic_Destructor(ScriptObject* scriptObject)
+	{
+		MultiScriptPrintf("CPP: destructor\n");
+		if (!scriptObject->m_objectPtr)
+		{
+			MultiScriptPrintf("CPP (destructor): object already destroyed.\n");
+			return;
+		}
+
+		DerivedSampleClass* object = (DerivedSampleClass*) scriptObject->m_objectPtr;
+		delete object;
+	}
+
+	static bool Generic_GetMultipliedInt(ScriptObject* scriptObject, ScriptStack* stack)
+	{
+		DerivedSampleClass* object = (DerivedSampleClass*) scriptObject->m_objectPtr;
+		stack->PushInt(object->m_value * object->m_multiplier);
+		return true;
+	}
+
+	static ClassDesc* GetClassDesc_Static()
+	{
+		static ClassDesc classDesc;
+
+		static bool isInitialized = false;
+		if (!isInitialized)
+		{
+			isInitialized = true;
+
+			classDesc.m_garbageCollect = true;
+			classDesc.m_superClass = SampleClass::GetClassDesc_Static();
+			classDesc.m_name = "DerivedSampleClass";
+			classDesc.m_constructor = DerivedSampleClass::Generic_Constructor;
+			classDesc.m_destructor = DerivedSampleClass::Generic_Destructor;
+			classDesc.m_methods.push_back( ClassMethodDesc("GetMultipliedInt", DerivedSampleClass::Generic_GetMultipliedInt) );
 		}
 
 		return &classDesc;
@@ -238,8 +345,8 @@ static bool MyAdd(ScriptStack* stack)
 
 static bool ReplaceCPPObject(ScriptStack* stack)
 {
-	// Pop an object to replace
-	ScriptObject* oldScriptObject = stack->PopScriptObject();
+	// Pop an object to replace; fails if it's not NewSampleClass object
+	ScriptObject* oldScriptObject = stack->PopScriptObject(NewSampleClass::GetClassDesc_Static());
 	if (!oldScriptObject) return false;
 
 	NewSampleClass* oldObject = (NewSampleClass*) oldScriptObject->m_objectPtr;
@@ -253,6 +360,103 @@ static bool ReplaceCPPObject(ScriptStack* stack)
 	return true;
 }
 
+static vector<ScriptObject*> trackedObjects; //!< Objects passed to Track(); updated from C++ after the script was executed
+
+static bool Track(ScriptStack* stack)
+{
+	ScriptObject* object = stack->PopScriptObject(SampleClass::GetClassDesc_Static());
+	if (!object) return false;
+
+	trackedObjects.push_back(object);
+	return true;
+}
+
+static bool MakeSquares(ScriptStack* stack)
+{
+	int count;
+	if (!stack->PopInt(count) || count < 0) return false;
+
+	vector<int> squares(count);
+	for (int i = 0; i < count; ++i)
+		squares[i] = i * i;
+	return stack->PushArray(count ? &squares[0] : NULL, count);
+}
+
+static bool MakeConfig(ScriptStack* stack)
+{
+	int scale;
+	if (!stack->PopInt(scale)) return false;
+
+	const char* keys[] = { "width", "height", "depth" };
+	const int values[] = { 4 * scale, 3 * scale, scale };
+	return stack->PushTable(keys, values, 3);
+}
+
+//! Row of a config table read in bulk by LoadRows and LoadSettings
+struct ConfigRow
+{
+	int m_id;
+	float m_weight;
+	bool m_enabled;
+
+	static const ClassFieldDesc* GetFields_Static(int& numFields)
+	{
+		static const ClassFieldDesc fields[] =
+		{
+			ClassFieldDesc("id", ClassFieldType_Int, offsetof(ConfigRow, m_id)),
+			ClassFieldDesc("weight", ClassFieldType_Float, offsetof(ConfigRow, m_weight)),
+			ClassFieldDesc("enabled", ClassFieldType_Bool, offsetof(ConfigRow, m_enabled))
+		};
+		numFields = sizeof(fields) / sizeof(fields[0]);
+		return fields;
+	}
+};
+
+static bool LoadRows(ScriptStack* stack)
+{
+	ScriptTableViewPtr view = stack->PopTable();
+	if (!view) return false;
+
+	int numFields;
+	const ClassFieldDesc* fields = ConfigRow::GetFields_Static(numFields);
+
+	const int count = view->GetCount();
+	vector<ConfigRow> rows(count);
+	const int numRows = count ? view->ExtractRows(fields, numFields, &rows[0], sizeof(ConfigRow), count) : 0;
+
+	int idSum = 0;
+	float weightSum = 0.0f;
+	int numEnabled = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		idSum += rows[i].m_id;
+		weightSum += rows[i].m_weight;
+		numEnabled += rows[i].m_enabled ? 1 : 0;
+	}
+	MultiScriptPrintf("CPP: rows = %d, id sum = %d, weight sum = %.1f, enabled = %d\n", numRows, idSum, weightSum, numEnabled);
+	return stack->PushInt(numRows);
+}
+
+static bool LoadSettings(ScriptStack* stack)
+{
+	ScriptTableViewPtr view = stack->PopTable();
+	if (!view) return false;
+
+	int numFields;
+	const ClassFieldDesc* fields = ConfigRow::GetFields_Static(numFields);
+
+	ConfigRow settings = { 0, 0.0f, false };
+	const int numFilled = view->Extract(fields, numFields, &settings);
+
+	int numEntries = 0;
+	ScriptValue key, value;
+	while (view->Next(key, value))
+		numEntries++;
+
+	MultiScriptPrintf("CPP: settings %d of %d entries: id = %d, weight = %.1f, enabled = %d\n", numFilled, numEntries, settings.m_id, settings.m_weight, settings.m_enabled ? 1 : 0);
+	return true;
+}
+
 //---------------------------------------------------------
 // Script call example
 //---------------------------------------------------------
@@ -282,6 +486,26 @@ bool ExecuteScriptFunction_ScriptAdd(ScriptContext* context, bool checkResult =
 	return false;
 }
 
+//! Invokes script's OnUpdate method on all tracked objects at once
+void BroadcastUpdate(ScriptContext* context)
+{
+	const int numObjects = (int) trackedObjects.size();
+	bool* results = new bool[numObjects];
+
+	const int dt = 10;
+	const int numSucceeded = context->InvokeMethodOnAll("OnUpdate", &trackedObjects[0], numObjects, &dt, 1, results);
+	MultiScriptPrintf("CPP: OnUpdate succeeded on %d of %d objects\n", numSucceeded, numObjects);
+
+	for (int i = 0; i < numObjects; ++i)
+	{
+		SampleClass* object = (SampleClass*) trackedObjects[i]->m_objectPtr;
+		MultiScriptPrintf("CPP: object %d %s, value = %d\n", i, results[i] ? "updated" : "failed", object->m_value);
+	}
+
+	delete [] results;
+	trackedObjects.clear();
+}
+
 //---------------------------------------------------------
 // Test scripts - "same" for each supported language (as much as syntax allows)
 //---------------------------------------------------------
@@ -390,6 +614,137 @@ const ScriptText scripts[] =
 					"x.Destroy();\n"
 					"y.Destroy();"},
 
+	// Test Program 4 - methods and to-string method inherited from super class (no Ocaml coz Ocaml doesn't support binding of the classes)
+	{"lua",			"d = DerivedSampleClass(3)\n"
+					"d:SetInt(7)\n"
+					"print('d = ', d, ' value = ', d:GetInt(), ' multiplied = ', d:GetMultipliedInt(), '\\n')"},
+
+	{"gm",			"d = DerivedSampleClass(3);\n"
+					"d.SetInt(7);\n"
+					"print(\"d = \" + d.AsString() + \" value = \" + d.GetInt() + \" multiplied = \" + d.GetMultipliedInt() + \"\\n\");"},
+
+	{"squirrel",	"local d = DerivedSampleClass(3);\n"
+					"d.SetInt(7);\n"
+					"print(\"d = \" + d.AsString() + \" value = \" + d.GetInt() + \" multiplied = \" + d.GetMultipliedInt() + \"\\n\");"},
+
+	// Test Program 5 - overloaded operators (no Ocaml coz Ocaml doesn't support binding of the classes)
+	{"lua",			"e = SampleClass(5) + SampleClass(6)\n"
+					"print('e = ', e, ' e + 1 = ', e + 1, ' e == 11: ', e == SampleClass(11), ' e < 12: ', e < SampleClass(12), '\\n')"},
+
+	{"gm",			"e = SampleClass(5) + SampleClass(6);\n"
+					"print(\"e = \" + e.AsString() + \" e + 1 = \" + (e + 1).AsString() + \" e == 11: \" + (e == SampleClass(11)) + \" e < 12: \" + (e < SampleClass(12)) + \"\\n\");"},
+
+		// Note: Squirrel compares instances by identity so equality is only reachable via <= and >=
+	{"squirrel",	"local e = SampleClass(5) + SampleClass(6);\n"
+					"print(\"e = \" + e.AsString() + \" e + 1 = \" + (e + 1).AsString() + \" e <= 11: \" + (e <= SampleClass(11)) + \" e < 12: \" + (e < SampleClass(12)) + \"\\n\");"},
+
+	// Test Program 6 - fields accessed directly in object's memory (no Ocaml coz Ocaml doesn't support binding of the classes)
+	{"lua",			"f = DerivedSampleClass(2)\n"
+					"f.value = 5\n"
+					"f.value = f.value + 1\n"
+					"print('f.value = ', f.value, ' GetInt() = ', f:GetInt(), ' multiplied = ', f:GetMultipliedInt(), '\\n')"},
+
+	{"gm",			"f = DerivedSampleClass(2);\n"
+					"f.value = 5;\n"
+					"f.value = f.value + 1;\n"
+					"print(\"f.value = \" + f.value + \" GetInt() = \" + f.GetInt() + \" multiplied = \" + f.GetMultipliedInt() + \"\\n\");"},
+
+	{"squirrel",	"local f = DerivedSampleClass(2);\n"
+					"f.value = 5;\n"
+					"f.value = f.value + 1;\n"
+					"print(\"f.value = \" + f.value + \" GetInt() = \" + f.GetInt() + \" multiplied = \" + f.GetMultipliedInt() + \"\\n\");"},
+
+	// Test Program 7 - method invoked from C++ on many objects at once (no Ocaml coz Ocaml doesn't support binding of the classes)
+		// Note: Script methods added to SampleClass in Lua and Squirrel are not visible in DerivedSampleClass, so the last call fails there
+		// Note: GM method throws on the second object to check the calls after a failed one still succeed
+	{"lua",			"function SampleClass:OnUpdate(dt) self.value = self.value + dt end\n"
+					"g = SampleClass(1)\n"
+					"h = SampleClass(2)\n"
+					"k = DerivedSampleClass(3)\n"
+					"Track(g) Track(h) Track(k)"},
+
+	{"gm",			"global OnUpdate = function(dt) { if(.value == 2) { NoSuchFunction(); } .value = .value + dt; };\n"
+					"global g = SampleClass(1);\n"
+					"global h = SampleClass(2);\n"
+					"global k = DerivedSampleClass(3);\n"
+					"Track(g); Track(h); Track(k);"},
+
+	{"squirrel",	"function SampleClass::OnUpdate(dt) { value = value + dt; }\n"
+					"g <- SampleClass(1);\n"
+					"h <- SampleClass(2);\n"
+					"k <- DerivedSampleClass(3);\n"
+					"Track(g); Track(h); Track(k);"},
+
+	// Test Program 8 - array and table built by C++ (no Ocaml coz Ocaml doesn't have tables)
+	{"lua",			"s = MakeSquares(5)\n"
+					"sum = 0\n"
+					"for i = 1, #s do sum = sum + s[i] end\n"
+					"c = MakeConfig(2)\n"
+					"print('squares = ', #s, ' sum = ', sum, ' config = ', c.width, ' x ', c.height, ' x ', c.depth, '\\n')"},
+
+	{"gm",			"s = MakeSquares(5);\n"
+					"sum = 0;\n"
+					"for(i = 0; i < tableCount(s); i = i + 1) { sum = sum + s[i]; }\n"
+					"c = MakeConfig(2);\n"
+					"print(\"squares = \" + tableCount(s) + \" sum = \" + sum + \" config = \" + c.width + \" x \" + c.height + \" x \" + c.depth + \"\\n\");"},
+
+	{"squirrel",	"local s = MakeSquares(5);\n"
+					"local sum = 0;\n"
+					"foreach (x in s) sum += x;\n"
+					"local c = MakeConfig(2);\n"
+					"print(\"squares = \" + s.len() + \" sum = \" + sum + \" config = \" + c.width + \" x \" + c.height + \" x \" + c.depth + \"\\n\");"},
+
+	// Test Program 9 - config tables read by C++ in bulk (no Ocaml coz Ocaml doesn't have tables)
+	{"lua",			"rows = {}\n"
+					"for i = 1, 100 do rows[i] = { id = i, weight = i * 0.5, enabled = i % 2 == 0 } end\n"
+					"LoadRows(rows)\n"
+					"LoadSettings({ id = 7, weight = 2.5, enabled = true, name = 'default' })"},
+
+	{"gm",			"rows = {};\n"
+					"for(i = 1; i <= 100; i = i + 1) { rows[i - 1] = { id = i, weight = i * 0.5, enabled = i % 2 == 0 }; }\n"
+					"LoadRows(rows);\n"
+					"LoadSettings({ id = 7, weight = 2.5, enabled = 1, name = \"default\" });"},
+
+	{"squirrel",	"local rows = [];\n"
+					"for (local i = 1; i <= 100; i++) rows.append({ id = i, weight = i * 0.5, enabled = i % 2 == 0 });\n"
+					"LoadRows(rows);\n"
+					"LoadSettings({ id = 7, weight = 2.5, enabled = true, name = \"default\" });"},
+
+	// Test Program 10 - packed typed arrays of the blob library (Squirrel only)
+	{"squirrel",	"local a = int32array(6);\n"
+					"for (local i = 0; i < a.len(); i++) a[i] = i * 10 - 20;\n"
+					"local s = 0;\n"
+					"foreach (i, x in a) s += x;\n"
+					"print(\"int32array len = \" + a.len() + \" a[1] = \" + a[1] + \" foreach sum = \" + s + \" sum = \" + a.sum() + \" min = \" + a.min() + \" max = \" + a.max() + \"\\n\");\n"
+					"a.fill(5, 1, 3);\n"
+					"a.copy(a, 2, 0, 4);\n"
+					"print(\"fill and copy up = \" + a[0] + \" \" + a[1] + \" \" + a[2] + \" \" + a[3] + \" \" + a[4] + \" \" + a[5] + \"\\n\");\n"
+					"a.copy(a, 0, 2, 4);\n"
+					"print(\"copy down = \" + a[0] + \" \" + a[1] + \" \" + a[2] + \" \" + a[3] + \" \" + a[4] + \" \" + a[5] + \" sum(1, 4) = \" + a.sum(1, 4) + \"\\n\");\n"
+					"local f = float32array(4, 0.5);\n"
+					"f[2] = -1.25;\n"
+					"f.resize(6);\n"
+					"print(\"float32array len = \" + f.len() + \" sum = \" + f.sum() + \" min = \" + f.min() + \" max = \" + f.max() + \" f[5] = \" + f[5] + \"\\n\");\n"
+					"f.resize(2);\n"
+					"print(\"after shrink len = \" + f.len() + \" sum = \" + f.sum() + \"\\n\");\n"
+					"local u = uint8array(3, 255);\n"
+					"u[1] = 256 + 7;\n"
+					"print(\"uint8array = \" + u[0] + \" \" + u[1] + \" \" + u[2] + \" sum = \" + u.sum() + \" typeof = \" + typeof u + \"\\n\");\n"
+					"local errors = [\n"
+					"function(a, f, u) { return a[6]; },\n"
+					"function(a, f, u) { a[-1] = 0; },\n"
+					"function(a, f, u) { a.fill(0, 4, 2); },\n"
+					"function(a, f, u) { a.copy(a, 5, 0, 2); },\n"
+					"function(a, f, u) { a.sum(0, 7); },\n"
+					"function(a, f, u) { a.copy(f); },\n"
+					"function(a, f, u) { u.resize(-1); },\n"
+					"function(a, f, u) { int32array(-1); }\n"
+					"];\n"
+					"foreach (e in errors) {\n"
+					"try { e(a, f, u); print(\"no error\\n\"); }\n"
+					"catch (err) { print(\"error: \" + err + \"\\n\"); }\n"
+					"}"},
+
 	{NULL, NULL}
 };
 
@@ -405,6 +760,28 @@ const ScriptText script_function[] =
 	{NULL, NULL}
 };
 
+//---------------------------------------------------------
+// Context setups the test scripts are executed with
+//---------------------------------------------------------
+
+struct ContextSetup
+{
+	const char* m_name;
+	bool m_jit; //!< Compile every function on its first call where a JIT is available
+	bool m_gcGenerational; //!< Collect garbage generationally where supported
+	bool m_gcBackgroundFree; //!< Free collected garbage on a worker thread where supported
+};
+
+//! Default options first, then each non-default mode on its own
+const ContextSetup contextSetups[] =
+{
+	{"default options",	false,	false,	false},
+	{"jit",				true,	false,	false},
+	{"generational gc",	false,	true,	false},
+	{"background free",	false,	false,	true},
+	{NULL, false, false, false}
+};
+
 //---------------------------------------------------------
 // Logger registered to the script context
 //---------------------------------------------------------
@@ -443,15 +820,22 @@ void main()
 	FunctionDesc* myAddFunction = NULL;
 	funcs.push_back( myAddFunction = new FunctionDesc("MyAdd", MyAdd, 2) );
 	funcs.push_back( new FunctionDesc("ReplaceCPPObject", ReplaceCPPObject, 1) );
+	funcs.push_back( new FunctionDesc("Track", Track, 1) );
+	funcs.push_back( new FunctionDesc("MakeSquares", MakeSquares, 1) );
+	funcs.push_back( new FunctionDesc("MakeConfig", MakeConfig, 1) );
+	funcs.push_back( new FunctionDesc("LoadRows", LoadRows, 1) );
+	funcs.push_back( new FunctionDesc("LoadSettings", LoadSettings, 1) );
 
 	// Create classes description
 	vector<ClassDesc*> classes;
 	classes.push_back( SampleClass::GetClassDesc_Static() );
 	classes.push_back( NewSampleClass::GetClassDesc_Static() );
+	classes.push_back( DerivedSampleClass::GetClassDesc_Static() );
 
 	// ---------------------------------------------------------------
-	// Execute all test scripts for all supported languages
+	// Execute all test scripts for all supported languages, once per context setup
 	// ---------------------------------------------------------------
+	for (const ContextSetup* setup = contextSetups; setup->m_name; ++setup)
 	for (int i = 0; scripts[i].m_language; ++i)
 	{
 		// Create context for given language
@@ -462,10 +846,16 @@ void main()
 		// Some info
 		MultiScriptPrintf(
 			"====================================\n"
-			"Executing script in '%s' language:\n", scripts[i].m_language);
+			"Executing script in '%s' language (%s):\n", scripts[i].m_language, setup->m_name);
 
-		// Set up context
+		// Set up context; options left at their defaults unless the setup changes them
 		context->SetLogger(logger);
+		if (setup->m_jit && context->SetOption(ScriptContextOption_Jit, 1))
+			context->SetOption(ScriptContextOption_JitThreshold, 1);
+		if (setup->m_gcGenerational)
+			context->SetOption(ScriptContextOption_GcGenerational, 1);
+		if (setup->m_gcBackgroundFree)
+			context->SetOption(ScriptContextOption_GcBackgroundFree, 1);
 
 		// Register functions and classes
 		for (unsigned int j = 0; j < funcs.size(); j++)
@@ -478,7 +868,12 @@ void main()
 		if (!result)
 			MultiScriptPrintf("FAILED\n");
 
-		// Destroy context
+		// Update objects tracked by the script
+		if (!trackedObjects.empty())
+			BroadcastUpdate(context);
+
+		// Collect garbage with a single bounded step first, then destroy context
+		context->CollectGarbage();
 		context->CollectGarbage(true);
 		delete context;
 	}
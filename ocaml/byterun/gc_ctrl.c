@@ -23,6 +23,7 @@
 #include "minor_gc.h"
 #include "misc.h"
 #include "mlvalues.h"
+#include "signals.h"
 #include "stacks.h"
 
 #ifndef NATIVE_CODE
@@ -451,6 +452,97 @@ CAMLprim value caml_gc_compaction(value v)
   return Val_unit;
 }
 
+// ======================== Custom caml stuff ===========================
+
+CAMLexport void custom_caml_gc_get_params(caml_gc_params* params)
+{
+	params->minor_heap_size = Wsize_bsize (caml_minor_heap_size);
+	params->major_heap_increment = Wsize_bsize (caml_major_heap_increment);
+	params->space_overhead = caml_percent_free;
+	params->max_overhead = caml_percent_max;
+}
+
+// Same as caml_gc_set() without the verbosity and stack size
+CAMLexport void custom_caml_gc_set_params(const caml_gc_params* params)
+{
+	uintnat newpf, newpm;
+	asize_t newheapincr;
+	asize_t newminsize;
+
+	newpf = norm_pfree (params->space_overhead);
+	if (newpf != caml_percent_free){
+		caml_percent_free = newpf;
+		caml_gc_message (0x20, "New space overhead: %d%%\n", caml_percent_free);
+	}
+
+	newpm = norm_pmax (params->max_overhead);
+	if (newpm != caml_percent_max){
+		caml_percent_max = newpm;
+		caml_gc_message (0x20, "New max overhead: %d%%\n", caml_percent_max);
+	}
+
+	newheapincr = Bsize_wsize (norm_heapincr (params->major_heap_increment));
+	if (newheapincr != caml_major_heap_increment){
+		caml_major_heap_increment = newheapincr;
+		caml_gc_message (0x20, "New heap increment size: %luk bytes\n",
+		                 caml_major_heap_increment/1024);
+	}
+
+	// Changing the minor heap size empties it first
+	newminsize = norm_minsize (Bsize_wsize (params->minor_heap_size));
+	if (newminsize != caml_minor_heap_size){
+		caml_gc_message (0x20, "New minor heap size: %luk bytes\n",
+		                 newminsize/1024);
+		caml_set_minor_heap_size (newminsize);
+	}
+}
+
+CAMLexport void custom_caml_gc_get_stats(caml_gc_stats* stats)
+{
+	stats->minor_words = caml_stat_minor_words
+	                     + (double) Wsize_bsize (caml_young_end - caml_young_ptr);
+	stats->promoted_words = caml_stat_promoted_words;
+	stats->major_words = caml_stat_major_words + (double) caml_allocated_words;
+	stats->minor_collections = caml_stat_minor_collections;
+	stats->major_collections = caml_stat_major_collections;
+	stats->heap_size = Wsize_bsize (caml_stat_heap_size);
+	stats->top_heap_size = Wsize_bsize (caml_stat_top_heap_size);
+	stats->heap_chunks = caml_stat_heap_chunks;
+	stats->compactions = caml_stat_compactions;
+}
+
+CAMLexport void custom_caml_gc_minor()
+{
+	caml_minor_collection ();
+}
+
+// Empties the minor heap and does [howmuch] words of major GC work (0 lets the GC compute it, as after
+// each minor collection); returns the amount of work done. Unlike caml_minor_collection(), the slice
+// is bounded by the caller, so the host can spread a major cycle over its frames
+CAMLexport intnat custom_caml_gc_major_slice(intnat howmuch)
+{
+	intnat prev_alloc_words = caml_allocated_words;
+	intnat work;
+
+	caml_empty_minor_heap ();
+	caml_stat_promoted_words += caml_allocated_words - prev_alloc_words;
+	++ caml_stat_minor_collections;
+
+	work = caml_major_collection_slice (howmuch);
+	caml_force_major_slice = 0;
+
+	caml_final_do_calls ();
+	caml_empty_minor_heap ();
+	return work;
+}
+
+CAMLexport void custom_caml_gc_full_major()
+{
+	caml_gc_full_major (Val_unit);
+}
+
+// ===================================================================
+
 void caml_init_gc (uintnat minor_size, uintnat major_size,
                    uintnat major_incr, uintnat percent_fr,
                    uintnat percent_m)
@@ -39,4 +39,38 @@ void caml_init_gc (uintnat, uintnat, uintnat,
 void caml_heap_check (void);
 #endif
 
+// ======================== Custom caml stuff ===========================
+
+//! Garbage collector parameters; a subset of Gc.control, sizes are in words
+typedef struct caml_gc_params
+{
+	uintnat minor_heap_size; //!< Size of the minor heap
+	uintnat major_heap_increment; //!< Amount the major heap grows by when it is full
+	uintnat space_overhead; //!< Major GC speed: memory wasted on garbage in percent of live data; smaller collects harder
+	uintnat max_overhead; //!< Free memory in percent of live data that triggers a heap compaction
+} caml_gc_params;
+
+//! Garbage collector counters; a subset of Gc.stat, sizes are in words
+typedef struct caml_gc_stats
+{
+	double minor_words; //!< Words allocated in the minor heap
+	double promoted_words; //!< Words promoted from the minor to the major heap
+	double major_words; //!< Words allocated in the major heap, including promoted words
+	intnat minor_collections; //!< Number of minor collections
+	intnat major_collections; //!< Number of finished major collection cycles
+	intnat heap_size; //!< Current size of the major heap
+	intnat top_heap_size; //!< Largest size of the major heap
+	intnat heap_chunks; //!< Number of chunks in the major heap
+	intnat compactions; //!< Number of heap compactions
+} caml_gc_stats;
+
+CAMLextern void custom_caml_gc_get_params(caml_gc_params* params);
+CAMLextern void custom_caml_gc_set_params(const caml_gc_params* params);
+CAMLextern void custom_caml_gc_get_stats(caml_gc_stats* stats);
+CAMLextern void custom_caml_gc_minor();
+CAMLextern intnat custom_caml_gc_major_slice(intnat howmuch);
+CAMLextern void custom_caml_gc_full_major();
+
+// ===================================================================
+
 #endif /* CAML_GC_CTRL_H */
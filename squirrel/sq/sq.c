@@ -311,6 +311,16 @@ int main(int argc, char* argv[])
 	}
 
 	sq_close(v);
+
+#ifdef SQ_REFCOUNT_STATS
+	{
+		SQUnsignedInteger refcountops,instructions;
+		sq_getrefcountstats(&refcountops,&instructions);
+		scfprintf(stderr,_SC("refcount ops: %lu, instructions: %lu, ops per instruction: %.3f\n"),
+			(unsigned long)refcountops,(unsigned long)instructions,
+			instructions?(double)refcountops/(double)instructions:0.0);
+	}
+#endif
 	
 #if defined(_MSC_VER) && defined(_DEBUG)
 	_getch();
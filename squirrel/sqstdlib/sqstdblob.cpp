@@ -151,6 +151,290 @@ static SQRegFunction _blob_methods[] = {
 
 
 
+//Typed arrays
+//packed int32, float32 and uint8 elements in a blob buffer; the classes derive from blob
+//so the stream methods and sqstd_getblob() still see the raw bytes
+
+#define SQSTD_INT32ARRAY_TYPE_TAG (SQSTD_STREAM_TYPE_TAG | 0x00000010)
+#define SQSTD_FLOAT32ARRAY_TYPE_TAG (SQSTD_STREAM_TYPE_TAG | 0x00000011)
+#define SQSTD_UINT8ARRAY_TYPE_TAG (SQSTD_STREAM_TYPE_TAG | 0x00000012)
+
+struct _int32array {
+	typedef SQInt32 Elem;
+	typedef SQInteger Sum;
+	static const SQChar *Name() { return _SC("int32array"); }
+	static SQUserPointer TypeTag() { return (SQUserPointer)SQSTD_INT32ARRAY_TYPE_TAG; }
+	static void Push(HSQUIRRELVM v,Elem e) { sq_pushinteger(v,e); }
+	static void PushSum(HSQUIRRELVM v,Sum s) { sq_pushinteger(v,s); }
+	static Elem Get(HSQUIRRELVM v,SQInteger idx) { SQInteger i = 0; sq_getinteger(v,idx,&i); return (Elem)i; }
+};
+
+struct _float32array {
+	typedef float Elem;
+	typedef double Sum;
+	static const SQChar *Name() { return _SC("float32array"); }
+	static SQUserPointer TypeTag() { return (SQUserPointer)SQSTD_FLOAT32ARRAY_TYPE_TAG; }
+	static void Push(HSQUIRRELVM v,Elem e) { sq_pushfloat(v,(SQFloat)e); }
+	static void PushSum(HSQUIRRELVM v,Sum s) { sq_pushfloat(v,(SQFloat)s); }
+	static Elem Get(HSQUIRRELVM v,SQInteger idx) { SQFloat f = 0; sq_getfloat(v,idx,&f); return (Elem)f; }
+};
+
+struct _uint8array {
+	typedef unsigned char Elem;
+	typedef SQInteger Sum;
+	static const SQChar *Name() { return _SC("uint8array"); }
+	static SQUserPointer TypeTag() { return (SQUserPointer)SQSTD_UINT8ARRAY_TYPE_TAG; }
+	static void Push(HSQUIRRELVM v,Elem e) { sq_pushinteger(v,e); }
+	static void PushSum(HSQUIRRELVM v,Sum s) { sq_pushinteger(v,s); }
+	static Elem Get(HSQUIRRELVM v,SQInteger idx) { SQInteger i = 0; sq_getinteger(v,idx,&i); return (Elem)i; }
+};
+
+#define SETUP_TYPEDARRAY(v) \
+	SQBlob *self = NULL; \
+	{ if(SQ_FAILED(sq_getinstanceup(v,1,(SQUserPointer*)&self,T::TypeTag()))) \
+		return SQ_ERROR; } \
+	SQInteger len = self->Len() / (SQInteger)sizeof(typename T::Elem);
+
+#define SETUP_TYPEDARRAY_BUF(v) \
+	SETUP_TYPEDARRAY(v) \
+	typename T::Elem *buf = (typename T::Elem *)self->GetBuf();
+
+//reads the optional [start,end) element range of fill, sum, min and max from the stack
+static SQInteger __typedarray_range(HSQUIRRELVM v,SQInteger idx,SQInteger len,SQInteger &start,SQInteger &end)
+{
+	start = 0;
+	end = len;
+	if(sq_gettop(v) >= idx) sq_getinteger(v,idx,&start);
+	if(sq_gettop(v) >= idx+1) sq_getinteger(v,idx+1,&end);
+	if(start < 0 || end > len || start > end)
+		return sq_throwerror(v,_SC("range out of bounds"));
+	return SQ_OK;
+}
+
+template<class T>
+static SQInteger _typedarray_constructor(HSQUIRRELVM v)
+{
+	SQInteger nparam = sq_gettop(v);
+	SQInteger size = 0;
+	if(nparam >= 2) {
+		sq_getinteger(v, 2, &size);
+	}
+	if(size < 0) return sq_throwerror(v, _SC("cannot create array with negative size"));
+	SQBlob *b = new SQBlob(size * (SQInteger)sizeof(typename T::Elem));
+	if(SQ_FAILED(sq_setinstanceup(v,1,b))) {
+		delete b;
+		return sq_throwerror(v, _SC("cannot create array"));
+	}
+	sq_setreleasehook(v,1,_blob_releasehook);
+	if(nparam >= 3) {
+		typename T::Elem *buf = (typename T::Elem *)b->GetBuf();
+		typename T::Elem e = T::Get(v,3);
+		for(SQInteger i = 0; i < size; i++) buf[i] = e;
+	}
+	return 0;
+}
+
+template<class T>
+static SQInteger _typedarray_resize(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY(v);
+	SQInteger size;
+	sq_getinteger(v,2,&size);
+	if(size < 0)
+		return sq_throwerror(v,_SC("resize failed"));
+	//bytes past the length are always zero, so growing only moves the length
+	bool ok = (size < len) ? self->Resize(size * (SQInteger)sizeof(typename T::Elem))
+		: self->GrowBufOf((size - len) * (SQInteger)sizeof(typename T::Elem));
+	if(!ok)
+		return sq_throwerror(v,_SC("resize failed"));
+	return 0;
+}
+
+template<class T>
+static SQInteger _typedarray_len(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY(v);
+	sq_pushinteger(v,len);
+	return 1;
+}
+
+template<class T>
+static SQInteger _typedarray__set(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY_BUF(v);
+	SQInteger idx;
+	sq_getinteger(v,2,&idx);
+	if(idx < 0 || idx >= len)
+		return sq_throwerror(v,_SC("index out of range"));
+	buf[idx] = T::Get(v,3);
+	sq_push(v,3);
+	return 1;
+}
+
+template<class T>
+static SQInteger _typedarray__get(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY_BUF(v);
+	SQInteger idx;
+	sq_getinteger(v,2,&idx);
+	if(idx < 0 || idx >= len)
+		return sq_throwerror(v,_SC("index out of range"));
+	T::Push(v,buf[idx]);
+	return 1;
+}
+
+template<class T>
+static SQInteger _typedarray__nexti(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY(v);
+	if(sq_gettype(v,2) == OT_NULL) {
+		if(len > 0) sq_pushinteger(v, 0);
+		else sq_pushnull(v);
+		return 1;
+	}
+	SQInteger idx;
+	if(SQ_SUCCEEDED(sq_getinteger(v, 2, &idx))) {
+		if(idx+1 < len) {
+			sq_pushinteger(v, idx+1);
+			return 1;
+		}
+		sq_pushnull(v);
+		return 1;
+	}
+	return sq_throwerror(v,_SC("internal error (_nexti) wrong argument type"));
+}
+
+template<class T>
+static SQInteger _typedarray__typeof(HSQUIRRELVM v)
+{
+	sq_pushstring(v,T::Name(),-1);
+	return 1;
+}
+
+template<class T>
+static SQInteger _typedarray_fill(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY_BUF(v);
+	SQInteger start, end;
+	if(SQ_FAILED(__typedarray_range(v,3,len,start,end)))
+		return SQ_ERROR;
+	typename T::Elem e = T::Get(v,2);
+	for(SQInteger i = start; i < end; i++) buf[i] = e;
+	return 0;
+}
+
+//copy(src[,dstidx[,srcidx[,count]]]) copies elements from an array of the same type, the ranges may overlap
+template<class T>
+static SQInteger _typedarray_copy(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY_BUF(v);
+	SQBlob *src = NULL;
+	if(SQ_FAILED(sq_getinstanceup(v,2,(SQUserPointer*)&src,T::TypeTag())))
+		return sq_throwerror(v,_SC("source must be an array of the same type"));
+	SQInteger srclen = src->Len() / (SQInteger)sizeof(typename T::Elem);
+	SQInteger dstidx = 0, srcidx = 0, count;
+	if(sq_gettop(v) >= 3) sq_getinteger(v,3,&dstidx);
+	if(sq_gettop(v) >= 4) sq_getinteger(v,4,&srcidx);
+	count = srclen - srcidx;
+	if(len - dstidx < count) count = len - dstidx;
+	if(sq_gettop(v) >= 5) sq_getinteger(v,5,&count);
+	if(dstidx < 0 || srcidx < 0 || count < 0 || dstidx + count > len || srcidx + count > srclen)
+		return sq_throwerror(v,_SC("range out of bounds"));
+	memmove(&buf[dstidx],&((typename T::Elem *)src->GetBuf())[srcidx],count * sizeof(typename T::Elem));
+	return 0;
+}
+
+//sum, min and max keep independent partial results so the loops pipeline (and vectorize where the compiler can)
+template<class T>
+static SQInteger _typedarray_sum(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY_BUF(v);
+	SQInteger start, end;
+	if(SQ_FAILED(__typedarray_range(v,2,len,start,end)))
+		return SQ_ERROR;
+	typename T::Sum s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	SQInteger i = start;
+	for(; i + 4 <= end; i += 4) {
+		s0 += buf[i]; s1 += buf[i+1]; s2 += buf[i+2]; s3 += buf[i+3];
+	}
+	for(; i < end; i++) s0 += buf[i];
+	T::PushSum(v,(s0 + s1) + (s2 + s3));
+	return 1;
+}
+
+template<class T,bool MAX>
+static SQInteger _typedarray_minmax(HSQUIRRELVM v)
+{
+	SETUP_TYPEDARRAY_BUF(v);
+	SQInteger start, end;
+	if(SQ_FAILED(__typedarray_range(v,2,len,start,end)))
+		return SQ_ERROR;
+	if(start == end) {
+		sq_pushnull(v);
+		return 1;
+	}
+	typename T::Elem m0 = buf[start], m1 = m0, m2 = m0, m3 = m0;
+	SQInteger i = start;
+	for(; i + 4 <= end; i += 4) {
+		if(MAX) {
+			m0 = buf[i] > m0 ? buf[i] : m0; m1 = buf[i+1] > m1 ? buf[i+1] : m1;
+			m2 = buf[i+2] > m2 ? buf[i+2] : m2; m3 = buf[i+3] > m3 ? buf[i+3] : m3;
+		}
+		else {
+			m0 = buf[i] < m0 ? buf[i] : m0; m1 = buf[i+1] < m1 ? buf[i+1] : m1;
+			m2 = buf[i+2] < m2 ? buf[i+2] : m2; m3 = buf[i+3] < m3 ? buf[i+3] : m3;
+		}
+	}
+	for(; i < end; i++) {
+		if(MAX) m0 = buf[i] > m0 ? buf[i] : m0;
+		else m0 = buf[i] < m0 ? buf[i] : m0;
+	}
+	if(MAX) {
+		m0 = m1 > m0 ? m1 : m0; m2 = m3 > m2 ? m3 : m2; m0 = m2 > m0 ? m2 : m0;
+	}
+	else {
+		m0 = m1 < m0 ? m1 : m0; m2 = m3 < m2 ? m3 : m2; m0 = m2 < m0 ? m2 : m0;
+	}
+	T::Push(v,m0);
+	return 1;
+}
+
+template<class T>
+static SQInteger _typedarray_min(HSQUIRRELVM v)
+{
+	return _typedarray_minmax<T,false>(v);
+}
+
+template<class T>
+static SQInteger _typedarray_max(HSQUIRRELVM v)
+{
+	return _typedarray_minmax<T,true>(v);
+}
+
+#define _DECL_TYPEDARRAY_FUNC(type,name,nparams,typecheck) {_SC(#name),_typedarray_##name<type>,nparams,typecheck}
+#define _DECL_TYPEDARRAY_METHODS(type) \
+static SQRegFunction type##_methods[] = { \
+	_DECL_TYPEDARRAY_FUNC(type,constructor,-1,_SC("xnn")), \
+	_DECL_TYPEDARRAY_FUNC(type,resize,2,_SC("xn")), \
+	_DECL_TYPEDARRAY_FUNC(type,len,1,_SC("x")), \
+	_DECL_TYPEDARRAY_FUNC(type,_set,3,_SC("xnn")), \
+	_DECL_TYPEDARRAY_FUNC(type,_get,2,_SC("xn")), \
+	_DECL_TYPEDARRAY_FUNC(type,_typeof,1,_SC("x")), \
+	_DECL_TYPEDARRAY_FUNC(type,_nexti,2,_SC("x")), \
+	_DECL_TYPEDARRAY_FUNC(type,fill,-2,_SC("xnnn")), \
+	_DECL_TYPEDARRAY_FUNC(type,copy,-2,_SC("xxnnn")), \
+	_DECL_TYPEDARRAY_FUNC(type,sum,-1,_SC("xnn")), \
+	_DECL_TYPEDARRAY_FUNC(type,min,-1,_SC("xnn")), \
+	_DECL_TYPEDARRAY_FUNC(type,max,-1,_SC("xnn")), \
+	{0,0,0,0} \
+};
+
+_DECL_TYPEDARRAY_METHODS(_int32array)
+_DECL_TYPEDARRAY_METHODS(_float32array)
+_DECL_TYPEDARRAY_METHODS(_uint8array)
+
+
+
 //GLOBAL FUNCTIONS
 
 static SQInteger _g_blob_casti2f(HSQUIRRELVM v)
@@ -244,8 +528,50 @@ SQUserPointer sqstd_createblob(HSQUIRRELVM v, SQInteger size)
 	return NULL;
 }
 
+static SQRESULT declare_typedarray(HSQUIRRELVM v,const SQChar *name,SQUserPointer typetag,const SQChar *reg_name,SQRegFunction *methods)
+{
+	SQInteger top = sq_gettop(v);
+	sq_pushregistrytable(v);
+	sq_pushstring(v,reg_name,-1);
+	sq_pushstring(v,_SC("std_blob"),-1);
+	if(SQ_SUCCEEDED(sq_get(v,-3))) {
+		sq_newclass(v,SQTrue);
+		sq_settypetag(v,-1,typetag);
+		SQInteger i = 0;
+		while(methods[i].name != 0) {
+			SQRegFunction &f = methods[i];
+			sq_pushstring(v,f.name,-1);
+			sq_newclosure(v,f.f,0);
+			sq_setparamscheck(v,f.nparamscheck,f.typemask);
+			sq_setnativeclosurename(v,-1,f.name);
+			sq_createslot(v,-3);
+			i++;
+		}
+		sq_createslot(v,-3);
+		sq_pop(v,1);
+
+		//register the class in the target table
+		sq_pushstring(v,name,-1);
+		sq_pushregistrytable(v);
+		sq_pushstring(v,reg_name,-1);
+		sq_get(v,-2);
+		sq_remove(v,-2);
+		sq_createslot(v,-3);
+
+		sq_settop(v,top);
+		return SQ_OK;
+	}
+	sq_settop(v,top);
+	return SQ_ERROR;
+}
+
 SQRESULT sqstd_register_bloblib(HSQUIRRELVM v)
 {
-	return declare_stream(v,_SC("blob"),(SQUserPointer)SQSTD_BLOB_TYPE_TAG,_SC("std_blob"),_blob_methods,bloblib_funcs);
+	if(SQ_FAILED(declare_stream(v,_SC("blob"),(SQUserPointer)SQSTD_BLOB_TYPE_TAG,_SC("std_blob"),_blob_methods,bloblib_funcs))
+		|| SQ_FAILED(declare_typedarray(v,_SC("int32array"),_int32array::TypeTag(),_SC("std_int32array"),_int32array_methods))
+		|| SQ_FAILED(declare_typedarray(v,_SC("float32array"),_float32array::TypeTag(),_SC("std_float32array"),_float32array_methods))
+		|| SQ_FAILED(declare_typedarray(v,_SC("uint8array"),_uint8array::TypeTag(),_SC("std_uint8array"),_uint8array_methods)))
+		return SQ_ERROR;
+	return SQ_OK;
 }
 
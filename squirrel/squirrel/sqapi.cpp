@@ -231,6 +231,12 @@ void sq_newtable(HSQUIRRELVM v)
 	v->Push(SQTable::Create(_ss(v), 0));	
 }
 
+void sq_newtableex(HSQUIRRELVM v,SQInteger initialcapacity)
+{
+	//a table rehashes once its last node is taken, so keep one spare
+	v->Push(SQTable::Create(_ss(v), initialcapacity + 1));	
+}
+
 void sq_newarray(HSQUIRRELVM v,SQInteger size)
 {
 	v->Push(SQArray::Create(_ss(v), size));	
@@ -1014,6 +1020,15 @@ SQInteger sq_collectgarbage(HSQUIRRELVM v)
 #endif
 }
 
+SQInteger sq_collectgarbagestep(HSQUIRRELVM v,SQInteger work)
+{
+#ifndef NO_GARBAGE_COLLECTOR
+	return _ss(v)->CollectGarbageStep(v,work);
+#else
+	return -1;
+#endif
+}
+
 const SQChar *sq_getfreevariable(HSQUIRRELVM v,SQInteger idx,SQUnsignedInteger nval)
 {
 	SQObjectPtr &self = stack_get(v,idx);
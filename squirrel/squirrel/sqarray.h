@@ -18,6 +18,7 @@ public:
 	}
 #ifndef NO_GARBAGE_COLLECTOR
 	void Mark(SQCollectable **chain);
+	void Traverse(SQGCVisitor *v);
 #endif
 	void Finalize(){
 		_values.resize(0);
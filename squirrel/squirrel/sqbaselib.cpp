@@ -41,6 +41,14 @@ static SQInteger base_collectgarbage(HSQUIRRELVM v)
 	sq_pushinteger(v, sq_collectgarbage(v));
 	return 1;
 }
+
+static SQInteger base_collectgarbagestep(HSQUIRRELVM v)
+{
+	SQInteger work = 0;
+	if(sq_gettop(v) > 1) sq_getinteger(v, 2, &work);
+	sq_pushinteger(v, sq_collectgarbagestep(v, work));
+	return 1;
+}
 #endif
 
 static SQInteger base_getroottable(HSQUIRRELVM v)
@@ -225,6 +233,7 @@ static SQRegFunction base_funcs[]={
 	{_SC("dummy"),base_dummy,0,NULL},
 #ifndef NO_GARBAGE_COLLECTOR
 	{_SC("collectgarbage"),base_collectgarbage,1, _SC("t")},
+	{_SC("collectgarbagestep"),base_collectgarbagestep,-1, _SC("tn")},
 #endif
 	{0,0}
 };
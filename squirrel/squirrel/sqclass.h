@@ -60,6 +60,7 @@ public:
 	void Finalize();
 #ifndef NO_GARBAGE_COLLECTOR
 	void Mark(SQCollectable ** );
+	void Traverse(SQGCVisitor *v);
 #endif
 	SQInteger Next(const SQObjectPtr &refpos, SQObjectPtr &outkey, SQObjectPtr &outval);
 	SQInstance *CreateInstance();
@@ -138,6 +139,7 @@ public:
 	void Finalize();
 #ifndef NO_GARBAGE_COLLECTOR 
 	void Mark(SQCollectable ** );
+	void Traverse(SQGCVisitor *v);
 #endif
 	bool InstanceOf(SQClass *trg);
 	bool GetMetaMethod(SQVM *v,SQMetaMethod mm,SQObjectPtr &res);
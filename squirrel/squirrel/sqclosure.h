@@ -32,6 +32,7 @@ public:
 	static bool Load(SQVM *v,SQUserPointer up,SQREADFUNC read,SQObjectPtr &ret);
 #ifndef NO_GARBAGE_COLLECTOR
 	void Mark(SQCollectable **chain);
+	void Traverse(SQGCVisitor *v);
 	void Finalize(){_outervalues.resize(0); }
 #endif
 	SQObjectPtr _env;
@@ -65,6 +66,7 @@ public:
 	bool Resume(SQVM *v,SQInteger target);
 #ifndef NO_GARBAGE_COLLECTOR
 	void Mark(SQCollectable **chain);
+	void Traverse(SQGCVisitor *v);
 	void Finalize(){_stack.resize(0);_closure=_null_;}
 #endif
 	SQObjectPtr _closure;
@@ -105,6 +107,7 @@ public:
 	}
 #ifndef NO_GARBAGE_COLLECTOR
 	void Mark(SQCollectable **chain);
+	void Traverse(SQGCVisitor *v);
 	void Finalize(){_outervalues.resize(0);}
 #endif
 	SQInteger _nparamscheck;
@@ -8,6 +8,17 @@
 #include "sqclosure.h"
 #include "sqstring.h"
 
+#ifdef SQ_REFCOUNT_STATS
+SQUnsignedInteger _sq_refcountops = 0;
+SQUnsignedInteger _sq_instructions = 0;
+
+void sq_getrefcountstats(SQUnsignedInteger *refcountops,SQUnsignedInteger *instructions)
+{
+	*refcountops = _sq_refcountops;
+	*instructions = _sq_instructions;
+}
+#endif
+
 SQRESULT sq_stackinfos(HSQUIRRELVM v, SQInteger level, SQStackInfos *si)
 {
 	SQInteger cssize = v->_callsstacksize;
@@ -70,12 +70,33 @@ typedef sqvector<SQLineInfo> SQLineInfoVec;
 			ptr[nl].~type(); \
 	} \
 }
+//per instruction lookup cache of _OP_GETK and _OP_PREPCALLK (see SQVM::GetCached)
+enum SQInlineCacheKind {
+	icEMPTY = 0,
+	icSLOT = 1,		//slot of the receiver table
+	icDELEGATE = 2,	//slot of the receiver's delegate
+	icROOT = 3,		//slot of the root table (fetchroot)
+	icMEMBER = 4	//member index in the receiver instance's class
+};
+
+struct SQInlineCache
+{
+	SQStamp _stamp;			//stamp of the receiver table or of the instance's class _members
+	SQStamp _ownerstamp;	//stamp of the delegate/root table holding _slot
+	SQInteger _kind;
+	union {
+		SQObjectPtr *_slot;
+		SQInteger _member;
+	};
+};
+
 struct SQFunctionProto : public SQRefCounted
 {
 private:
 	SQFunctionProto(){
 	_stacksize=0;
-	_bgenerator=false;}
+	_bgenerator=false;
+	_inlinecaches=NULL;}
 public:
 	static SQFunctionProto *Create(SQInteger ninstructions,
 		SQInteger nliterals,SQInteger nparameters,
@@ -115,6 +136,7 @@ public:
 		_DESTRUCT_VECTOR(SQOuterVar,_noutervalues,_outervalues);
 		//_DESTRUCT_VECTOR(SQLineInfo,_nlineinfos,_lineinfos); //not required are 2 integers
 		_DESTRUCT_VECTOR(SQLocalVarInfo,_nlocalvarinfos,_localvarinfos);
+		if(_inlinecaches) sq_vm_free(_inlinecaches,_ninstructions*sizeof(SQInlineCache));
 		SQInteger size = _FUNC_SIZE(_ninstructions,_nliterals,_nparameters,_nfunctions,_noutervalues,_nlineinfos,_nlocalvarinfos);
 		this->~SQFunctionProto();
 		sq_vm_free(this,size);
@@ -123,6 +145,15 @@ public:
 	SQInteger GetLine(SQInstruction *curr);
 	bool Save(SQVM *v,SQUserPointer up,SQWRITEFUNC write);
 	static bool Load(SQVM *v,SQUserPointer up,SQREADFUNC read,SQObjectPtr &ret);
+	//allocated on the first cached lookup, one entry per instruction
+	inline SQInlineCache &GetInlineCache(SQInstruction *i)
+	{
+		if(!_inlinecaches) {
+			_inlinecaches = (SQInlineCache *)sq_vm_malloc(_ninstructions*sizeof(SQInlineCache));
+			memset(_inlinecaches,0,_ninstructions*sizeof(SQInlineCache));
+		}
+		return _inlinecaches[i - _instructions];
+	}
 
 	SQObjectPtr _sourcename;
 	SQObjectPtr _name;
@@ -147,6 +178,8 @@ public:
 
 	SQInteger _noutervalues;
 	SQOuterVar *_outervalues;
+
+	SQInlineCache *_inlinecaches;
 	
 	SQInteger _ninstructions;
 	SQInstruction _instructions[1];
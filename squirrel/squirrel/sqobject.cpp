@@ -80,6 +80,19 @@ bool SQDelegable::GetMetaMethod(SQVM *v,SQMetaMethod mm,SQObjectPtr &res) {
 	return false;
 }
 
+#ifdef NO_GARBAGE_COLLECTOR
+static SQStamp _stampcounter = 0;
+#endif
+
+void SQDelegable::NewStamp()
+{
+#ifndef NO_GARBAGE_COLLECTOR
+	_stamp = ++_sharedstate->_stampcounter;
+#else
+	_stamp = ++_stampcounter;
+#endif
+}
+
 bool SQDelegable::SetDelegate(SQTable *mt)
 {
 	SQTable *temp = mt;
@@ -90,6 +103,7 @@ bool SQDelegable::SetDelegate(SQTable *mt)
 	if (mt)	__ObjAddRef(mt);
 	__ObjRelease(_delegate);
 	_delegate = mt;
+	NewStamp();
 	return true;
 }
 
@@ -531,5 +545,82 @@ void SQUserData::Mark(SQCollectable **chain){
 
 void SQCollectable::UnMark() { _uiRef&=~MARK_FLAG; }
 
+void SQVM::Traverse(SQGCVisitor *v)
+{
+	SQSharedState::TraverseObject(_lasterror,v);
+	SQSharedState::TraverseObject(_errorhandler,v);
+	SQSharedState::TraverseObject(_debughook,v);
+	SQSharedState::TraverseObject(_roottable,v);
+	SQSharedState::TraverseObject(temp_reg,v);
+	for(SQUnsignedInteger i = 0; i < _stack.size() && v->_left > 0; i++) SQSharedState::TraverseObject(_stack[i],v);
+	for(SQUnsignedInteger j = 0; j < _vargsstack.size() && v->_left > 0; j++) SQSharedState::TraverseObject(_vargsstack[j],v);
+}
+
+void SQArray::Traverse(SQGCVisitor *v)
+{
+	SQInteger len = _values.size();
+	for(SQInteger i = 0;i < len && v->_left > 0; i++) SQSharedState::TraverseObject(_values[i],v);
+}
+
+void SQTable::Traverse(SQGCVisitor *v)
+{
+	if(_delegate) v->Visit(_delegate);
+	SQInteger len = _numofnodes;
+	for(SQInteger i = 0; i < len && v->_left > 0; i++){
+		SQSharedState::TraverseObject(_nodes[i].key,v);
+		SQSharedState::TraverseObject(_nodes[i].val,v);
+	}
+}
+
+void SQClass::Traverse(SQGCVisitor *v)
+{
+	v->Visit(_members);
+	if(_base) v->Visit(_base);
+	SQSharedState::TraverseObject(_attributes,v);
+	for(SQUnsignedInteger i =0; i< _defaultvalues.size() && v->_left > 0; i++) {
+		SQSharedState::TraverseObject(_defaultvalues[i].val,v);
+		SQSharedState::TraverseObject(_defaultvalues[i].attrs,v);
+	}
+	for(SQUnsignedInteger j =0; j< _methods.size() && v->_left > 0; j++) {
+		SQSharedState::TraverseObject(_methods[j].val,v);
+		SQSharedState::TraverseObject(_methods[j].attrs,v);
+	}
+	for(SQUnsignedInteger k =0; k< _metamethods.size() && v->_left > 0; k++) {
+		SQSharedState::TraverseObject(_metamethods[k],v);
+	}
+}
+
+void SQInstance::Traverse(SQGCVisitor *v)
+{
+	if(!_class) return; //already finalized
+	v->Visit(_class);
+	SQUnsignedInteger nvalues = _class->_defaultvalues.size();
+	for(SQUnsignedInteger i =0; i< nvalues && v->_left > 0; i++) {
+		SQSharedState::TraverseObject(_values[i],v);
+	}
+}
+
+void SQGenerator::Traverse(SQGCVisitor *v)
+{
+	for(SQUnsignedInteger i = 0; i < _stack.size() && v->_left > 0; i++) SQSharedState::TraverseObject(_stack[i],v);
+	for(SQUnsignedInteger j = 0; j < _vargsstack.size() && v->_left > 0; j++) SQSharedState::TraverseObject(_vargsstack[j],v);
+	SQSharedState::TraverseObject(_closure,v);
+}
+
+void SQClosure::Traverse(SQGCVisitor *v)
+{
+	for(SQUnsignedInteger i = 0; i < _outervalues.size() && v->_left > 0; i++) SQSharedState::TraverseObject(_outervalues[i],v);
+}
+
+void SQNativeClosure::Traverse(SQGCVisitor *v)
+{
+	for(SQUnsignedInteger i = 0; i < _outervalues.size() && v->_left > 0; i++) SQSharedState::TraverseObject(_outervalues[i],v);
+}
+
+void SQUserData::Traverse(SQGCVisitor *v)
+{
+	if(_delegate) v->Visit(_delegate);
+}
+
 #endif
 
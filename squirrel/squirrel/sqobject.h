@@ -10,6 +10,13 @@
 
 struct SQSharedState;
 
+//64 bits even where SQUnsignedInteger is 32, so that stamps never wrap around to an old value
+#ifdef _MSC_VER
+typedef unsigned __int64 SQStamp;
+#else
+typedef unsigned long long SQStamp;
+#endif
+
 enum SQMetaMethod{
 	MT_ADD=0,
 	MT_SUB=1,
@@ -73,18 +80,30 @@ struct SQWeakRef : SQRefCounted
 
 struct SQObjectPtr;
 
+//define SQ_REFCOUNT_STATS to count every reference count update and every executed instruction
+//(see sq_getrefcountstats())
+#ifdef SQ_REFCOUNT_STATS
+extern SQUnsignedInteger _sq_refcountops;
+extern SQUnsignedInteger _sq_instructions;
+#define __CountRefOp() (_sq_refcountops++)
+#else
+#define __CountRefOp() ((void)0)
+#endif
+
 #define __AddRef(type,unval) if(ISREFCOUNTED(type))	\
 		{ \
+			__CountRefOp(); \
 			unval.pRefCounted->_uiRef++; \
 		}  
 
-#define __Release(type,unval) if(ISREFCOUNTED(type) && ((--unval.pRefCounted->_uiRef)<=0))	\
+#define __Release(type,unval) if(ISREFCOUNTED(type) && (__CountRefOp(), (--unval.pRefCounted->_uiRef)<=0))	\
 		{	\
 			unval.pRefCounted->Release();	\
 		}
 
 #define __ObjRelease(obj) { \
 	if((obj)) {	\
+		__CountRefOp(); \
 		(obj)->_uiRef--; \
 		if((obj)->_uiRef == 0) \
 			(obj)->Release(); \
@@ -93,6 +112,7 @@ struct SQObjectPtr;
 }
 
 #define __ObjAddRef(obj) { \
+	__CountRefOp(); \
 	(obj)->_uiRef++; \
 }
 
@@ -282,6 +302,8 @@ struct SQObjectPtr : public SQObject
 	}
 	inline SQObjectPtr& operator=(const SQObjectPtr& obj)
 	{ 
+		if(_type == obj._type && ISREFCOUNTED(_type) && _unVal.pRefCounted == obj._unVal.pRefCounted)
+			return *this; //same object, skip the AddRef/Release pair
 		SQObjectType tOldType;
 		SQObjectValue unOldVal;
 		tOldType=_type;
@@ -294,6 +316,8 @@ struct SQObjectPtr : public SQObject
 	}
 	inline SQObjectPtr& operator=(const SQObject& obj)
 	{ 
+		if(_type == obj._type && ISREFCOUNTED(_type) && _unVal.pRefCounted == obj._unVal.pRefCounted)
+			return *this;
 		SQObjectType tOldType;
 		SQObjectValue unOldVal;
 		tOldType=_type;
@@ -307,15 +331,33 @@ struct SQObjectPtr : public SQObject
 	private:
 		SQObjectPtr(const SQChar *){} //safety
 };
+
+//exchanges two objects without touching their reference counts; moving a value out of a slot
+//that is about to be cleared is _Swap() followed by Null() on the source
+inline void _Swap(SQObject &a,SQObject &b)
+{
+	SQObjectType tOldType = a._type;
+	SQObjectValue unOldVal = a._unVal;
+	a._type = b._type;
+	a._unVal = b._unVal;
+	b._type = tOldType;
+	b._unVal = unOldVal;
+}
 /////////////////////////////////////////////////////////////////////////////////////
 #ifndef NO_GARBAGE_COLLECTOR
 #define MARK_FLAG 0x80000000
+struct SQCollectable;
+struct SQGCVisitor {
+	virtual void Visit(SQCollectable *c)=0;
+	SQInteger _left; //references left to traverse, Traverse() stops when it runs out
+};
 struct SQCollectable : public SQRefCounted {
 	SQCollectable *_next;
 	SQCollectable *_prev;
 	SQSharedState *_sharedstate;
 	virtual void Release()=0;
 	virtual void Mark(SQCollectable **chain)=0;
+	virtual void Traverse(SQGCVisitor *v)=0; //visits the same references as Mark() without recursing, in the same order
 	void UnMark();
 	virtual void Finalize()=0;
 	static void AddToChain(SQCollectable **chain,SQCollectable *c);
@@ -326,7 +368,7 @@ struct SQCollectable : public SQRefCounted {
 #define ADD_TO_CHAIN(chain,obj) AddToChain(chain,obj)
 #define REMOVE_FROM_CHAIN(chain,obj) {if(!(_uiRef&MARK_FLAG))RemoveFromChain(chain,obj);}
 #define CHAINABLE_OBJ SQCollectable
-#define INIT_CHAIN() {_next=NULL;_prev=NULL;_sharedstate=ss;}
+#define INIT_CHAIN() {_next=NULL;_prev=NULL;SQCollectable::_sharedstate=ss;} //qualified: SQVM declares its own _sharedstate
 #else
 
 #define ADD_TO_CHAIN(chain,obj) ((void)0)
@@ -338,7 +380,9 @@ struct SQCollectable : public SQRefCounted {
 struct SQDelegable : public CHAINABLE_OBJ {
 	bool SetDelegate(SQTable *m);
 	virtual bool GetMetaMethod(SQVM *v,SQMetaMethod mm,SQObjectPtr &res);
+	void NewStamp();
 	SQTable *_delegate;
+	SQStamp _stamp; //renewed when the slot layout or the delegate changes (validates SQInlineCache)
 };
 
 SQUnsignedInteger TranslateIndex(const SQObjectPtr &idx);
@@ -24,6 +24,7 @@ SQSharedState::SQSharedState()
 	_printfunc = NULL;
 	_debuginfo = false;
 	_notifyallexceptions = false;
+	_stampcounter = 0;
 }
 
 #define newsysstring(s) {	\
@@ -100,6 +101,7 @@ void SQSharedState::Init()
 	_scratchpadsize=0;
 #ifndef NO_GARBAGE_COLLECTOR
 	_gc_chain=NULL;
+	_gc_cursor=NULL;
 #endif
 	sq_new(_stringtable,StringTable);
 	sq_new(_metamethods,SQObjectPtrVec);
@@ -238,6 +240,23 @@ void SQSharedState::MarkObject(SQObjectPtr &o,SQCollectable **chain)
 	}
 }
 
+void SQSharedState::TraverseObject(SQObjectPtr &o,SQGCVisitor *v)
+{
+	v->_left--;
+	switch(type(o)){
+	case OT_TABLE:v->Visit(_table(o));break;
+	case OT_ARRAY:v->Visit(_array(o));break;
+	case OT_USERDATA:v->Visit(_userdata(o));break;
+	case OT_CLOSURE:v->Visit(_closure(o));break;
+	case OT_NATIVECLOSURE:v->Visit(_nativeclosure(o));break;
+	case OT_GENERATOR:v->Visit(_generator(o));break;
+	case OT_THREAD:v->Visit(_thread(o));break;
+	case OT_CLASS:v->Visit(_class(o));break;
+	case OT_INSTANCE:v->Visit(_instance(o));break;
+	default: break; //shutup compiler
+	}
+}
+
 
 SQInteger SQSharedState::CollectGarbage(SQVM *vm)
 {
@@ -279,10 +298,107 @@ SQInteger SQSharedState::CollectGarbage(SQVM *vm)
 		t = t->_next;
 	}
 	_gc_chain = tchain;
+	_gc_cursor = NULL;
 	SQInteger z = _table(_thread(_root_vm)->_roottable)->CountUsed();
 	assert(z == x);
 	return n;
 }
+
+//grows the slice from the scanned members while there are references left to traverse; every
+//reference between two members is taken off the target's trial count (the low bits of _uiRef while MARK_FLAG is set)
+struct SQGCSliceBuilder : public SQGCVisitor {
+	SQGCSliceBuilder(sqvector<SQGCSliceEntry> &slice,SQInteger work) : _slice(slice) { _left = work; }
+	void Add(SQCollectable *c) {
+		SQGCSliceEntry e;
+		e.obj = c;
+		e.refs = c->_uiRef;
+		_slice.push_back(e);
+		c->_uiRef |= MARK_FLAG;
+	}
+	void Visit(SQCollectable *c) {
+		if(!(c->_uiRef & MARK_FLAG)) {
+			if(_left <= 0) return;
+			Add(c);
+		}
+		assert(c->_uiRef != MARK_FLAG);
+		c->_uiRef--;
+	}
+	sqvector<SQGCSliceEntry> &_slice;
+};
+
+//revives the members referenced by a reachable member
+struct SQGCSliceReach : public SQGCVisitor {
+	SQGCSliceReach(sqvector<SQCollectable*> &stack) : _stack(stack) { _left = 0; }
+	void Visit(SQCollectable *c) {
+		if(c->_uiRef == MARK_FLAG) {
+			c->_uiRef = MARK_FLAG|1;
+			_stack.push_back(c);
+		}
+	}
+	sqvector<SQCollectable*> &_stack;
+};
+
+/*
+	Collects the reference cycles of a bounded slice of the heap (trial deletion). The slice grows
+	from seeds taken along _gc_chain; the reference counts already include every reference held from
+	outside of it (vm stacks, registry, C handles...) so no root set is needed: once the references
+	between members are subtracted, the members left with a count are externally reachable, so is
+	everything they reach, and the rest can only be referenced by garbage of the same slice.
+	Members found after the work ran out are not traversed and are kept.
+*/
+SQInteger SQSharedState::CollectGarbageStep(SQVM *vm,SQInteger work)
+{
+	if(work <= 0) work = GC_STEP_DEFAULT_WORK;
+	if(!_gc_cursor) _gc_cursor = _gc_chain;
+	SQGCSliceBuilder builder(_gc_slice,work);
+	SQUnsignedInteger scanned = 0;
+	SQInteger lastleft = 0;
+	while(builder._left > 0) {
+		if(scanned == _gc_slice.size()) {
+			while(_gc_cursor && (_gc_cursor->_uiRef & MARK_FLAG)) _gc_cursor = _gc_cursor->_next;
+			if(!_gc_cursor) break;
+			builder.Add(_gc_cursor);
+			_gc_cursor = _gc_cursor->_next;
+		}
+		lastleft = builder._left;
+		_gc_slice[scanned++].obj->Traverse(&builder);
+	}
+	SQUnsignedInteger size = _gc_slice.size();
+	SQUnsignedInteger i;
+	for(i = scanned; i < size; i++) _gc_slice[i].obj->_uiRef = MARK_FLAG|1;
+	_gc_work.resize(0);
+	for(i = 0; i < scanned; i++) {
+		if(_gc_slice[i].obj->_uiRef != MARK_FLAG) _gc_work.push_back(_gc_slice[i].obj);
+	}
+	//only the last scanned member may have been cut short, it is traversed again up to the same reference
+	SQCollectable *last = scanned ? _gc_slice[scanned - 1].obj : NULL;
+	SQGCSliceReach reach(_gc_work);
+	while(!_gc_work.empty()) {
+		SQCollectable *c = _gc_work.top();
+		_gc_work.pop_back();
+		reach._left = c == last ? lastleft : work;
+		c->Traverse(&reach);
+	}
+	//the members were examined, the next slice starts past them
+	while(_gc_cursor && (_gc_cursor->_uiRef & MARK_FLAG)) _gc_cursor = _gc_cursor->_next;
+	for(i = 0; i < size; i++) {
+		SQGCSliceEntry &e = _gc_slice[i];
+		if(e.obj->_uiRef == MARK_FLAG) _gc_work.push_back(e.obj);
+		e.obj->_uiRef = e.refs;
+	}
+	_gc_slice.resize(0);
+	SQInteger n = _gc_work.size();
+	//same protocol as CollectGarbage(), the whole garbage set is held until it has been finalized
+	for(i = 0; i < (SQUnsignedInteger)n; i++) _gc_work[i]->_uiRef++;
+	for(i = 0; i < (SQUnsignedInteger)n; i++) _gc_work[i]->Finalize();
+	for(i = 0; i < (SQUnsignedInteger)n; i++) {
+		SQCollectable *t = _gc_work[i];
+		if(--t->_uiRef == 0)
+			t->Release();
+	}
+	_gc_work.resize(0);
+	return n;
+}
 #endif
 
 #ifndef NO_GARBAGE_COLLECTOR
@@ -296,6 +412,7 @@ void SQCollectable::AddToChain(SQCollectable **chain,SQCollectable *c)
 
 void SQCollectable::RemoveFromChain(SQCollectable **chain,SQCollectable *c)
 {
+	if(c->_sharedstate->_gc_cursor == c) c->_sharedstate->_gc_cursor = c->_next;
 	if(c->_prev) c->_prev->_next = c->_next;
 	else *chain = c->_next;
 	if(c->_next)
@@ -8,6 +8,8 @@ struct SQString;
 struct SQTable;
 //max number of character for a printed number
 #define NUMBER_MAX_CHAR 50
+//work budget of CollectGarbageStep() when the caller passes 0 (objects + references visited)
+#define GC_STEP_DEFAULT_WORK 4096
 
 struct StringTable
 {
@@ -54,6 +56,13 @@ private:
 
 struct SQObjectPtr;
 
+#ifndef NO_GARBAGE_COLLECTOR
+struct SQGCSliceEntry {
+	SQCollectable *obj;
+	SQUnsignedInteger refs; //reference count saved while _uiRef holds the trial count
+};
+#endif
+
 struct SQSharedState
 {
 	SQSharedState();
@@ -64,7 +73,9 @@ public:
 	SQInteger GetMetaMethodIdxByName(const SQObjectPtr &name);
 #ifndef NO_GARBAGE_COLLECTOR
 	SQInteger CollectGarbage(SQVM *vm); 
+	SQInteger CollectGarbageStep(SQVM *vm,SQInteger work);
 	static void MarkObject(SQObjectPtr &o,SQCollectable **chain);
+	static void TraverseObject(SQObjectPtr &o,SQGCVisitor *v);
 #endif
 	SQObjectPtrVec *_metamethods;
 	SQObjectPtr _metamethodsmap;
@@ -76,6 +87,9 @@ public:
 	SQObjectPtr _constructoridx;
 #ifndef NO_GARBAGE_COLLECTOR
 	SQCollectable *_gc_chain;
+	SQCollectable *_gc_cursor; //next seed of CollectGarbageStep(); NULL starts a new pass from the head of _gc_chain
+	sqvector<SQGCSliceEntry> _gc_slice;
+	sqvector<SQCollectable*> _gc_work;
 #endif
 	SQObjectPtr _root_vm;
 	SQObjectPtr _table_default_delegate;
@@ -103,6 +117,7 @@ public:
 	SQPRINTFUNCTION _printfunc;
 	bool _debuginfo;
 	bool _notifyallexceptions;
+	SQStamp _stampcounter; //source of SQDelegable::_stamp values
 private:
 	SQChar *_scratchpad;
 	SQInteger _scratchpadsize;
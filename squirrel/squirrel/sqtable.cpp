@@ -16,6 +16,7 @@ SQTable::SQTable(SQSharedState *ss,SQInteger nInitialSize)
 	_delegate = NULL;
 	INIT_CHAIN();
 	ADD_TO_CHAIN(&_sharedstate->_gc_chain,this);
+	NewStamp();
 }
 
 void SQTable::Remove(const SQObjectPtr &key)
@@ -25,6 +26,7 @@ void SQTable::Remove(const SQObjectPtr &key)
 	if (n) {
 		n->val = n->key = _null_;
 		_usednodes--;
+		NewStamp();
 		Rehash(false);
 	}
 }
@@ -58,6 +60,7 @@ void SQTable::Rehash(bool force)
 	else
 		return;
 	_usednodes = 0;
+	NewStamp();
 	for (SQInteger i=0; i<oldsize; i++) {
 		_HashNode *old = nold+i;
 		if (type(old->key) != OT_NULL)
@@ -102,6 +105,7 @@ bool SQTable::NewSlot(const SQObjectPtr &key,const SQObjectPtr &val)
 	}
 	_HashNode *mp = &_nodes[h];
 	n = mp;
+	NewStamp(); //nodes may move, invalidate cached slots
 
 
 	//key not found I'll insert it
@@ -180,6 +184,7 @@ bool SQTable::Set(const SQObjectPtr &key, const SQObjectPtr &val)
 void SQTable::_ClearNodes()
 {
 	for(SQInteger i = 0;i < _numofnodes; i++) { _nodes[i].key = _null_; _nodes[i].val = _null_; }
+	NewStamp();
 }
 
 void SQTable::Finalize()
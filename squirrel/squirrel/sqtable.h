@@ -61,6 +61,7 @@ public:
 	}
 #ifndef NO_GARBAGE_COLLECTOR 
 	void Mark(SQCollectable **chain);
+	void Traverse(SQGCVisitor *v);
 #endif
 	inline _HashNode *_Get(const SQObjectPtr &key,SQHash hash)
 	{
@@ -73,6 +74,13 @@ public:
 		return NULL;
 	}
 	bool Get(const SQObjectPtr &key,SQObjectPtr &val);
+	//returns the value slot of key or NULL; valid as long as _stamp does not change
+	inline SQObjectPtr *GetSlot(const SQObjectPtr &key)
+	{
+		if(type(key) == OT_NULL) return NULL;
+		_HashNode *n = _Get(key, HashObj(key) & (_numofnodes - 1));
+		return n ? &n->val : NULL;
+	}
 	void Remove(const SQObjectPtr &key);
 	bool Set(const SQObjectPtr &key, const SQObjectPtr &val);
 	//returns true if a new slot has been created false if it was already present
@@ -20,6 +20,7 @@ struct SQUserData : SQDelegable
 	}
 #ifndef NO_GARBAGE_COLLECTOR
 	void Mark(SQCollectable **chain);
+	void Traverse(SQGCVisitor *v);
 	void Finalize(){SetDelegate(NULL);}
 #endif
 	void Release() {
@@ -349,8 +349,7 @@ bool SQVM::StartCall(SQClosure *closure,SQInteger target,SQInteger nargs,SQInteg
 				return false;
 			}
 			for(SQInteger n = 0; n < nargs - paramssize; n++) {
-				_vargsstack.push_back(_stack._vals[stackbase+paramssize+n]);
-				_stack._vals[stackbase+paramssize+n] = _null_;
+				_Swap(_vargsstack.push_back(),_stack._vals[stackbase+paramssize+n]);
 			}
 		}
 		else {
@@ -406,17 +405,14 @@ bool SQVM::Return(SQInteger _arg0, SQInteger _arg1, SQObjectPtr &retval)
 	_top = _stackbase + ci->_prevtop;
 	if(ci->_vargs.size) PopVarArgs(ci->_vargs);
 	POP_CALLINFO(this);
-	if (broot) {
-		if (_arg0 != MAX_FUNC_STACKSIZE) retval = _stack._vals[oldstackbase+_arg1];
-		else retval = _null_;
-	}
-	else {
-		if(target != -1) { //-1 is when a class contructor ret value has to be ignored
-			if (_arg0 != MAX_FUNC_STACKSIZE)
-				STK(target) = _stack._vals[oldstackbase+_arg1];
-			else
-				STK(target) = _null_;
-		}
+	SQObjectPtr *dest = broot ? &retval : (target != -1 ? &STK(target) : NULL); //-1 is when a class contructor ret value has to be ignored
+	if (dest) {
+		SQInteger src = oldstackbase+_arg1;
+		if (_arg0 == MAX_FUNC_STACKSIZE) dest->Null();
+		//slots from _top up are cleared below, so the return value is moved out and the old
+		//value of the destination is released by the loop instead
+		else if (src >= _top) _Swap(*dest,_stack._vals[src]);
+		else *dest = _stack._vals[src];
 	}
 
 	while (last_top >= _top) _stack._vals[last_top--].Null();
@@ -452,6 +448,113 @@ bool SQVM::DerefInc(SQInteger op,SQObjectPtr &target, SQObjectPtr &self, SQObjec
 	return true;
 }
 
+//slot of key in the root table if Get() would fall back to it for self, NULL otherwise
+SQObjectPtr *SQVM::GetRootSlot(const SQObjectPtr &self,const SQObjectPtr &key)
+{
+	if(type(_roottable) != OT_TABLE || _rawval(STK(0)) != _rawval(self) || type(STK(0)) != type(self))
+		return NULL;
+	return _table(_roottable)->GetSlot(key);
+}
+
+bool SQVM::IsRootCacheValid(const SQInlineCache &ic,const SQObjectPtr &self)
+{
+	return type(_roottable) == OT_TABLE && _table(_roottable)->_stamp == ic._ownerstamp
+		&& _rawval(STK(0)) == _rawval(self) && type(STK(0)) == type(self);
+}
+
+bool SQVM::GetCached(SQInlineCache &ic,const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest)
+{
+	switch(type(self)) {
+	case OT_TABLE: {
+		SQTable *t = _table(self);
+		if(t->_stamp != ic._stamp) break;
+		switch(ic._kind) {
+		case icSLOT: dest = _realval(*ic._slot); return true;
+		case icDELEGATE:
+			if(t->_delegate->_stamp != ic._ownerstamp) break;
+			dest = _realval(*ic._slot);
+			return true;
+		case icROOT:
+			if(!IsRootCacheValid(ic,self)) break;
+			dest = _realval(*ic._slot);
+			return true;
+		}
+		}
+		break;
+	case OT_INSTANCE: {
+		SQInstance *inst = _instance(self);
+		if(inst->_class->_members->_stamp != ic._stamp) break;
+		if(ic._kind == icMEMBER) {
+			if(ic._member & MEMBER_TYPE_FIELD) dest = _realval(inst->_values[ic._member & 0x00FFFFFF]);
+			else dest = inst->_class->_methods[ic._member & 0x00FFFFFF].val;
+			return true;
+		}
+		if(ic._kind == icROOT && IsRootCacheValid(ic,self)) {
+			dest = _realval(*ic._slot);
+			return true;
+		}
+		}
+		break;
+	default: break;
+	}
+	return CacheGet(ic,self,key,dest);
+}
+
+//cache miss: resolves the lookups that do not involve metamethods or the default delegates
+//and records where the value was found, everything else goes through Get()
+bool SQVM::CacheGet(SQInlineCache &ic,const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest)
+{
+	SQObjectPtr *slot = NULL;
+	ic._kind = icEMPTY;
+	switch(type(self)) {
+	case OT_TABLE: {
+		SQTable *t = _table(self);
+		if((slot = t->GetSlot(key))) {
+			ic._kind = icSLOT;
+		}
+		else if(t->_delegate) {
+			if((slot = t->_delegate->GetSlot(key))) {
+				ic._kind = icDELEGATE;
+				ic._ownerstamp = t->_delegate->_stamp;
+			}
+		}
+		else if(!_table_ddel->GetSlot(key) && (slot = GetRootSlot(self,key))) {
+			ic._kind = icROOT;
+			ic._ownerstamp = _table(_roottable)->_stamp;
+		}
+		if(ic._kind == icEMPTY) break;
+		ic._stamp = t->_stamp;
+		ic._slot = slot;
+		dest = _realval(*slot);
+		return true;
+		}
+	case OT_INSTANCE: {
+		SQInstance *inst = _instance(self);
+		SQTable *members = inst->_class->_members;
+		if((slot = members->GetSlot(key))) {
+			ic._kind = icMEMBER;
+			ic._stamp = members->_stamp;
+			ic._member = _integer(*slot);
+			if(ic._member & MEMBER_TYPE_FIELD) dest = _realval(inst->_values[ic._member & 0x00FFFFFF]);
+			else dest = inst->_class->_methods[ic._member & 0x00FFFFFF].val;
+			return true;
+		}
+		if(type(inst->_class->_metamethods[MT_GET]) == OT_NULL && !_instance_ddel->GetSlot(key)
+			&& (slot = GetRootSlot(self,key))) {
+			ic._kind = icROOT;
+			ic._stamp = members->_stamp;
+			ic._ownerstamp = _table(_roottable)->_stamp;
+			ic._slot = slot;
+			dest = _realval(*slot);
+			return true;
+		}
+		}
+		break;
+	default: break;
+	}
+	return Get(self,key,dest,false,true);
+}
+
 #define arg0 (_i_._arg0)
 #define arg1 (_i_._arg1)
 #define sarg1 (*((SQInt32 *)&_i_._arg1))
@@ -556,6 +659,29 @@ bool SQVM::DELEGATE_OP(SQObjectPtr &trg,SQObjectPtr &o1,SQObjectPtr &o2)
 
 #define SQ_THROW() { goto exception_trap; }
 
+//moves temp_reg into a register without an AddRef/Release pair, temp_reg is left null
+#define _MOVE_TEMP(dst) { _Swap(dst,temp_reg); temp_reg.Null(); }
+
+#ifdef SQ_REFCOUNT_STATS
+#define _COUNT_INSTRUCTION() (_sq_instructions++)
+#else
+#define _COUNT_INSTRUCTION() ((void)0)
+#endif
+
+//inline cache of the instruction being executed
+#define _INLINE_CACHE() (_funcproto(_closure(ci->_closure)->_function)->GetInlineCache(ci->_ip - 1))
+
+// Threaded dispatch: with labels as values (GCC/Clang) every opcode fetches and jumps to the next one itself,
+// so each opcode gets its own indirect branch; define NO_COMPUTED_GOTO to use the single switch instead
+#if defined(__GNUC__) && !defined(NO_COMPUTED_GOTO)
+#define SQ_COMPUTED_GOTO
+#define SQ_CASE(op) case op: L##op:
+#define SQ_NEXT { _i_ = *ci->_ip++; _COUNT_INSTRUCTION(); goto *_dispatchtable[_i_.op]; }
+#else
+#define SQ_CASE(op) case op:
+#define SQ_NEXT continue
+#endif
+
 bool SQVM::CLOSURE_OP(SQObjectPtr &target, SQFunctionProto *func)
 {
 	SQInteger nouters;
@@ -676,6 +802,21 @@ bool SQVM::Execute(SQObjectPtr &closure, SQInteger target, SQInteger nargs, SQIn
 	SQInteger ct_target;
 	SQInteger ct_stackbase;
 	bool ct_tailcall; 
+	SQInstruction _i_;
+#ifdef SQ_COMPUTED_GOTO
+	static const void *const _dispatchtable[] = {
+		&&L_OP_LINE, &&L_OP_LOAD, &&L_OP_LOADINT, &&L_OP_LOADFLOAT, &&L_OP_DLOAD, &&L_OP_TAILCALL,
+		&&L_OP_CALL, &&L_OP_PREPCALL, &&L_OP_PREPCALLK, &&L_OP_GETK, &&L_OP_MOVE, &&L_OP_NEWSLOT,
+		&&L_OP_DELETE, &&L_OP_SET, &&L_OP_GET, &&L_OP_EQ, &&L_OP_NE, &&L_OP_ARITH, &&L_OP_BITW,
+		&&L_OP_RETURN, &&L_OP_LOADNULLS, &&L_OP_LOADROOTTABLE, &&L_OP_LOADBOOL, &&L_OP_DMOVE, &&L_OP_JMP,
+		&&L_OP_JNZ, &&L_OP_JZ, &&L_OP_LOADFREEVAR, &&L_OP_VARGC, &&L_OP_GETVARGV, &&L_OP_NEWTABLE,
+		&&L_OP_NEWARRAY, &&L_OP_APPENDARRAY, &&L_OP_GETPARENT, &&L_OP_COMPARITH, &&L_OP_COMPARITHL,
+		&&L_OP_INC, &&L_OP_INCL, &&L_OP_PINC, &&L_OP_PINCL, &&L_OP_CMP, &&L_OP_EXISTS, &&L_OP_INSTANCEOF,
+		&&L_OP_AND, &&L_OP_OR, &&L_OP_NEG, &&L_OP_NOT, &&L_OP_BWNOT, &&L_OP_CLOSURE, &&L_OP_YIELD,
+		&&L_OP_RESUME, &&L_OP_FOREACH, &&L_OP_POSTFOREACH, &&L_OP_DELEGATE, &&L_OP_CLONE, &&L_OP_TYPEOF,
+		&&L_OP_PUSHTRAP, &&L_OP_POPTRAP, &&L_OP_THROW, &&L_OP_CLASS, &&L_OP_NEWSLOTA
+	};
+#endif
 
 	switch(et) {
 		case ET_CALL: 
@@ -700,30 +841,31 @@ exception_restore:
 	{
 		for(;;)
 		{
-			const SQInstruction &_i_ = *ci->_ip++;
+			_i_ = *ci->_ip++;
+			_COUNT_INSTRUCTION();
 			//dumpstack(_stackbase);
 			//scprintf("\n[%d] %s %d %d %d %d\n",ci->_ip-ci->_iv->_vals,g_InstrDesc[_i_.op].name,arg0,arg1,arg2,arg3);
 			switch(_i_.op)
 			{
-			case _OP_LINE:
+			SQ_CASE(_OP_LINE)
 				if(type(_debughook) != OT_NULL && _rawval(_debughook) != _rawval(ci->_closure))
 					CallDebugHook(_SC('l'),arg1);
-				continue;
-			case _OP_LOAD: TARGET = ci->_literals[arg1]; continue;
-			case _OP_LOADINT: TARGET = (SQInteger)arg1; continue;
-			case _OP_LOADFLOAT: TARGET = *((SQFloat *)&arg1); continue;
-			case _OP_DLOAD: TARGET = ci->_literals[arg1]; STK(arg2) = ci->_literals[arg3];continue;
-			case _OP_TAILCALL:
+				SQ_NEXT;
+			SQ_CASE(_OP_LOAD) TARGET = ci->_literals[arg1]; SQ_NEXT;
+			SQ_CASE(_OP_LOADINT) TARGET = (SQInteger)arg1; SQ_NEXT;
+			SQ_CASE(_OP_LOADFLOAT) TARGET = *((SQFloat *)&arg1); SQ_NEXT;
+			SQ_CASE(_OP_DLOAD) TARGET = ci->_literals[arg1]; STK(arg2) = ci->_literals[arg3];SQ_NEXT;
+			SQ_CASE(_OP_TAILCALL)
 				temp_reg = STK(arg1);
 				if (type(temp_reg) == OT_CLOSURE){ 
 					ct_tailcall = true;
 					if(ci->_vargs.size) PopVarArgs(ci->_vargs);
-					for (SQInteger i = 0; i < arg3; i++) STK(i) = STK(arg2 + i);
+					for (SQInteger i = 0; i < arg3; i++) _Swap(STK(i), STK(arg2 + i));
 					ct_target = ci->_target;
 					ct_stackbase = _stackbase;
 					goto common_call;
 				}
-			case _OP_CALL: {
+			SQ_CASE(_OP_CALL) {
 					ct_tailcall = false;
 					ct_target = arg0;
 					temp_reg = STK(arg1);
@@ -744,12 +886,12 @@ common_call:
 
 							STK(ct_target) = gen;
 							while (last_top >= _top) _stack._vals[last_top--].Null();
-							continue;
+							SQ_NEXT;
 						}
 						if (type(_debughook) != OT_NULL && _rawval(_debughook) != _rawval(ci->_closure))
 							CallDebugHook(_SC('c'));
 						}
-						continue;
+						SQ_NEXT;
 					case OT_NATIVECLOSURE: {
 						bool suspend;
 						_GUARD(CallNative(_nativeclosure(temp_reg), arg3, ct_stackbase, temp_reg,suspend));
@@ -763,10 +905,10 @@ common_call:
 							return true;
 						}
 						if(ct_target != -1) { //skip return value for constructors
-							STK(ct_target) = temp_reg;
+							_MOVE_TEMP(STK(ct_target));
 						}
 										   }
-						continue;
+						SQ_NEXT;
 					case OT_CLASS:{
 						SQObjectPtr inst;
 						_GUARD(CreateClassInstance(_class(temp_reg),inst,temp_reg));
@@ -785,7 +927,7 @@ common_call:
 						Push(temp_reg);
 						for (SQInteger i = 0; i < arg3; i++) Push(STK(arg2 + i));
 						if (_delegable(temp_reg) && CallMetaMethod(_delegable(temp_reg), MT_CALL, arg3+1, temp_reg)){
-							STK(ct_target) = temp_reg;
+							_MOVE_TEMP(STK(ct_target));
 							break;
 						}
 						Raise_Error(_SC("attempt to call '%s'"), GetTypeName(temp_reg));
@@ -796,58 +938,85 @@ common_call:
 						SQ_THROW();
 					}
 				}
-				  continue;
-			case _OP_PREPCALL:
-			case _OP_PREPCALLK:
+				  SQ_NEXT;
+			SQ_CASE(_OP_PREPCALL)
+			SQ_CASE(_OP_PREPCALLK)
 				{
 					SQObjectPtr &key = _i_.op == _OP_PREPCALLK?(ci->_literals)[arg1]:STK(arg1);
 					SQObjectPtr &o = STK(arg2);
-					if (!Get(o, key, temp_reg,false,true)) {
+					if (!(_i_.op == _OP_PREPCALLK ? GetCached(_INLINE_CACHE(), o, key, temp_reg) : Get(o, key, temp_reg,false,true))) {
 						if(type(o) == OT_CLASS) { //hack?
 							if(_class_ddel->Get(key,temp_reg)) {
 								STK(arg3) = o;
-								TARGET = temp_reg;
-								continue;
+								_MOVE_TEMP(TARGET);
+								SQ_NEXT;
 							}
 						}
 						{ Raise_IdxError(key); SQ_THROW();}
 					}
 
 					STK(arg3) = type(o) == OT_CLASS?STK(0):o;
-					TARGET = temp_reg;
+					_MOVE_TEMP(TARGET);
 				}
-				continue;
-			case _OP_GETK:
-				if (!Get(STK(arg2), ci->_literals[arg1], temp_reg, false,true)) { Raise_IdxError(ci->_literals[arg1]); SQ_THROW();}
-				TARGET = temp_reg;
-				continue;
-			case _OP_MOVE: TARGET = STK(arg1); continue;
-			case _OP_NEWSLOT:
+				SQ_NEXT;
+			SQ_CASE(_OP_GETK)
+				if (!GetCached(_INLINE_CACHE(), STK(arg2), ci->_literals[arg1], temp_reg)) { Raise_IdxError(ci->_literals[arg1]); SQ_THROW();}
+				_MOVE_TEMP(TARGET);
+				SQ_NEXT;
+			SQ_CASE(_OP_MOVE) TARGET = STK(arg1); SQ_NEXT;
+			SQ_CASE(_OP_NEWSLOT)
 				_GUARD(NewSlot(STK(arg1), STK(arg2), STK(arg3),false));
 				if(arg0 != arg3) TARGET = STK(arg3);
-				continue;
-			case _OP_DELETE: _GUARD(DeleteSlot(STK(arg1), STK(arg2), TARGET)); continue;
-			case _OP_SET:
+				SQ_NEXT;
+			SQ_CASE(_OP_DELETE) _GUARD(DeleteSlot(STK(arg1), STK(arg2), TARGET)); SQ_NEXT;
+			SQ_CASE(_OP_SET)
 				if (!Set(STK(arg1), STK(arg2), STK(arg3),true)) { Raise_IdxError(STK(arg2)); SQ_THROW(); }
 				if (arg0 != arg3) TARGET = STK(arg3);
-				continue;
-			case _OP_GET:
-				if (!Get(STK(arg1), STK(arg2), temp_reg, false,true)) { Raise_IdxError(STK(arg2)); SQ_THROW(); }
-				TARGET = temp_reg;
-				continue;
-			case _OP_EQ:{
+				SQ_NEXT;
+			SQ_CASE(_OP_GET)
+				// Array elements and own table slots are read directly, everything else takes the generic path
+				if(type(STK(arg1)) == OT_ARRAY && type(STK(arg2)) == OT_INTEGER) {
+					if(!_array(STK(arg1))->Get(_integer(STK(arg2)), temp_reg)) { Raise_IdxError(STK(arg2)); SQ_THROW(); }
+				}
+				else if(type(STK(arg1)) != OT_TABLE || !_table(STK(arg1))->Get(STK(arg2), temp_reg)) {
+					if (!Get(STK(arg1), STK(arg2), temp_reg, false,true)) { Raise_IdxError(STK(arg2)); SQ_THROW(); }
+				}
+				_MOVE_TEMP(TARGET);
+				SQ_NEXT;
+			SQ_CASE(_OP_EQ){
 				bool res;
 				if(!IsEqual(STK(arg2),COND_LITERAL,res)) { SQ_THROW(); }
 				TARGET = res?_true_:_false_;
-				}continue;
-			case _OP_NE:{ 
+				}SQ_NEXT;
+			SQ_CASE(_OP_NE){ 
 				bool res;
 				if(!IsEqual(STK(arg2),COND_LITERAL,res)) { SQ_THROW(); }
 				TARGET = (!res)?_true_:_false_;
-				} continue;
-			case _OP_ARITH: _GUARD(ARITH_OP( arg3 , temp_reg, STK(arg2), STK(arg1))); TARGET = temp_reg; continue;
-			case _OP_BITW:	_GUARD(BW_OP( arg3,TARGET,STK(arg2),STK(arg1))); continue;
-			case _OP_RETURN:
+				} SQ_NEXT;
+			SQ_CASE(_OP_ARITH) {
+				// Plain numbers are computed in place; division by integer, modulo, strings and metamethods go through ARITH_OP
+				const SQObjectPtr &o1 = STK(arg2), &o2 = STK(arg1);
+				const SQInteger tmask = type(o1)|type(o2);
+				if(tmask == OT_INTEGER) {
+					switch(arg3) {
+						case '+': TARGET = _integer(o1) + _integer(o2); SQ_NEXT;
+						case '-': TARGET = _integer(o1) - _integer(o2); SQ_NEXT;
+						case '*': TARGET = _integer(o1) * _integer(o2); SQ_NEXT;
+					}
+				}
+				else if(tmask == OT_FLOAT || tmask == (OT_FLOAT|OT_INTEGER)) {
+					switch(arg3) {
+						case '+': TARGET = tofloat(o1) + tofloat(o2); SQ_NEXT;
+						case '-': TARGET = tofloat(o1) - tofloat(o2); SQ_NEXT;
+						case '*': TARGET = tofloat(o1) * tofloat(o2); SQ_NEXT;
+						case '/': TARGET = tofloat(o1) / tofloat(o2); SQ_NEXT;
+					}
+				}
+				_GUARD(ARITH_OP( arg3 , temp_reg, o1, o2)); _MOVE_TEMP(TARGET);
+				}
+				SQ_NEXT;
+			SQ_CASE(_OP_BITW)	_GUARD(BW_OP( arg3,TARGET,STK(arg2),STK(arg1))); SQ_NEXT;
+			SQ_CASE(_OP_RETURN)
 				if(type((ci)->_generator) == OT_GENERATOR) {
 					_generator((ci)->_generator)->Kill();
 				}
@@ -856,65 +1025,96 @@ common_call:
 					outres = temp_reg;
 					return true;
 				}
-				continue;
-			case _OP_LOADNULLS:{ for(SQInt32 n=0; n < arg1; n++) STK(arg0+n) = _null_; }continue;
-			case _OP_LOADROOTTABLE:	TARGET = _roottable; continue;
-			case _OP_LOADBOOL: TARGET = arg1?_true_:_false_; continue;
-			case _OP_DMOVE: STK(arg0) = STK(arg1); STK(arg2) = STK(arg3); continue;
-			case _OP_JMP: ci->_ip += (sarg1); continue;
-			case _OP_JNZ: if(!IsFalse(STK(arg0))) ci->_ip+=(sarg1); continue;
-			case _OP_JZ: if(IsFalse(STK(arg0))) ci->_ip+=(sarg1); continue;
-			case _OP_LOADFREEVAR: TARGET = _closure(ci->_closure)->_outervalues[arg1]; continue;
-			case _OP_VARGC: TARGET = SQInteger(ci->_vargs.size); continue;
-			case _OP_GETVARGV: 
+				SQ_NEXT;
+			SQ_CASE(_OP_LOADNULLS){ for(SQInt32 n=0; n < arg1; n++) STK(arg0+n) = _null_; }SQ_NEXT;
+			SQ_CASE(_OP_LOADROOTTABLE)	TARGET = _roottable; SQ_NEXT;
+			SQ_CASE(_OP_LOADBOOL) TARGET = arg1?_true_:_false_; SQ_NEXT;
+			SQ_CASE(_OP_DMOVE) STK(arg0) = STK(arg1); STK(arg2) = STK(arg3); SQ_NEXT;
+			SQ_CASE(_OP_JMP) ci->_ip += (sarg1); SQ_NEXT;
+			SQ_CASE(_OP_JNZ) if(!IsFalse(STK(arg0))) ci->_ip+=(sarg1); SQ_NEXT;
+			SQ_CASE(_OP_JZ) if(IsFalse(STK(arg0))) ci->_ip+=(sarg1); SQ_NEXT;
+			SQ_CASE(_OP_LOADFREEVAR) TARGET = _closure(ci->_closure)->_outervalues[arg1]; SQ_NEXT;
+			SQ_CASE(_OP_VARGC) TARGET = SQInteger(ci->_vargs.size); SQ_NEXT;
+			SQ_CASE(_OP_GETVARGV) 
 				if(!GETVARGV_OP(TARGET,STK(arg1),ci)) { SQ_THROW(); } 
-				continue;
-			case _OP_NEWTABLE: TARGET = SQTable::Create(_ss(this), arg1); continue;
-			case _OP_NEWARRAY: TARGET = SQArray::Create(_ss(this), 0); _array(TARGET)->Reserve(arg1); continue;
-			case _OP_APPENDARRAY: _array(STK(arg0))->Append(COND_LITERAL);	continue;
-			case _OP_GETPARENT: _GUARD(GETPARENT_OP(STK(arg1),TARGET)); continue;
-			case _OP_COMPARITH: _GUARD(DerefInc(arg3, TARGET, STK((((SQUnsignedInteger)arg1&0xFFFF0000)>>16)), STK(arg2), STK(arg1&0x0000FFFF), false)); continue;
-			case _OP_COMPARITHL: _GUARD(LOCAL_INC(arg3, TARGET, STK(arg1), STK(arg2))); continue;
-			case _OP_INC: {SQObjectPtr o(sarg3); _GUARD(DerefInc('+',TARGET, STK(arg1), STK(arg2), o, false));} continue;
-			case _OP_INCL: {SQObjectPtr o(sarg3); _GUARD(LOCAL_INC('+',TARGET, STK(arg1), o));} continue;
-			case _OP_PINC: {SQObjectPtr o(sarg3); _GUARD(DerefInc('+',TARGET, STK(arg1), STK(arg2), o, true));} continue;
-			case _OP_PINCL:	{SQObjectPtr o(sarg3); _GUARD(PLOCAL_INC('+',TARGET, STK(arg1), o));} continue;
-			case _OP_CMP:	_GUARD(CMP_OP((CmpOP)arg3,STK(arg2),STK(arg1),TARGET))	continue;
-			case _OP_EXISTS: TARGET = Get(STK(arg1), STK(arg2), temp_reg, true,false)?_true_:_false_;continue;
-			case _OP_INSTANCEOF: 
+				SQ_NEXT;
+			SQ_CASE(_OP_NEWTABLE) TARGET = SQTable::Create(_ss(this), arg1); SQ_NEXT;
+			SQ_CASE(_OP_NEWARRAY) TARGET = SQArray::Create(_ss(this), 0); _array(TARGET)->Reserve(arg1); SQ_NEXT;
+			SQ_CASE(_OP_APPENDARRAY) _array(STK(arg0))->Append(COND_LITERAL);	SQ_NEXT;
+			SQ_CASE(_OP_GETPARENT) _GUARD(GETPARENT_OP(STK(arg1),TARGET)); SQ_NEXT;
+			SQ_CASE(_OP_COMPARITH) _GUARD(DerefInc(arg3, TARGET, STK((((SQUnsignedInteger)arg1&0xFFFF0000)>>16)), STK(arg2), STK(arg1&0x0000FFFF), false)); SQ_NEXT;
+			SQ_CASE(_OP_COMPARITHL)
+				if((type(STK(arg1))|type(STK(arg2))) == OT_INTEGER && (arg3 == '+' || arg3 == '-')) {
+					const SQInteger res = arg3 == '+' ? _integer(STK(arg1)) + _integer(STK(arg2)) : _integer(STK(arg1)) - _integer(STK(arg2));
+					STK(arg1) = res; TARGET = res;
+					SQ_NEXT;
+				}
+				_GUARD(LOCAL_INC(arg3, TARGET, STK(arg1), STK(arg2))); SQ_NEXT;
+			SQ_CASE(_OP_INC) {SQObjectPtr o(sarg3); _GUARD(DerefInc('+',TARGET, STK(arg1), STK(arg2), o, false));} SQ_NEXT;
+			SQ_CASE(_OP_INCL)
+				if(type(STK(arg1)) == OT_INTEGER) {
+					const SQInteger res = _integer(STK(arg1)) + sarg3;
+					STK(arg1) = res; TARGET = res;
+					SQ_NEXT;
+				}
+				{SQObjectPtr o(sarg3); _GUARD(LOCAL_INC('+',TARGET, STK(arg1), o));} SQ_NEXT;
+			SQ_CASE(_OP_PINC) {SQObjectPtr o(sarg3); _GUARD(DerefInc('+',TARGET, STK(arg1), STK(arg2), o, true));} SQ_NEXT;
+			SQ_CASE(_OP_PINCL)
+				if(type(STK(arg1)) == OT_INTEGER) {
+					const SQInteger old = _integer(STK(arg1));
+					TARGET = old; STK(arg1) = old + sarg3;
+					SQ_NEXT;
+				}
+				{SQObjectPtr o(sarg3); _GUARD(PLOCAL_INC('+',TARGET, STK(arg1), o));} SQ_NEXT;
+			SQ_CASE(_OP_CMP)
+				if((type(STK(arg2))|type(STK(arg1))) == OT_INTEGER) {
+					const SQInteger i1 = _integer(STK(arg2)), i2 = _integer(STK(arg1));
+					bool res;
+					switch(arg3) {
+						case CMP_G: res = i1 > i2; break;
+						case CMP_GE: res = i1 >= i2; break;
+						case CMP_L: res = i1 < i2; break;
+						default: res = i1 <= i2; break;
+					}
+					TARGET = res?_true_:_false_;
+					SQ_NEXT;
+				}
+				_GUARD(CMP_OP((CmpOP)arg3,STK(arg2),STK(arg1),TARGET))	SQ_NEXT;
+			SQ_CASE(_OP_EXISTS) TARGET = Get(STK(arg1), STK(arg2), temp_reg, true,false)?_true_:_false_;SQ_NEXT;
+			SQ_CASE(_OP_INSTANCEOF) 
 				if(type(STK(arg1)) != OT_CLASS || type(STK(arg2)) != OT_INSTANCE)
 				{Raise_Error(_SC("cannot apply instanceof between a %s and a %s"),GetTypeName(STK(arg1)),GetTypeName(STK(arg2))); SQ_THROW();}
 				TARGET = _instance(STK(arg2))->InstanceOf(_class(STK(arg1)))?_true_:_false_;
-				continue;
-			case _OP_AND: 
+				SQ_NEXT;
+			SQ_CASE(_OP_AND) 
 				if(IsFalse(STK(arg2))) {
 					TARGET = STK(arg2);
 					ci->_ip += (sarg1);
 				}
-				continue;
-			case _OP_OR:
+				SQ_NEXT;
+			SQ_CASE(_OP_OR)
 				if(!IsFalse(STK(arg2))) {
 					TARGET = STK(arg2);
 					ci->_ip += (sarg1);
 				}
-				continue;
-			case _OP_NEG: _GUARD(NEG_OP(TARGET,STK(arg1))); continue;
-			case _OP_NOT: TARGET = (IsFalse(STK(arg1))?_true_:_false_); continue;
-			case _OP_BWNOT:
+				SQ_NEXT;
+			SQ_CASE(_OP_NEG) _GUARD(NEG_OP(TARGET,STK(arg1))); SQ_NEXT;
+			SQ_CASE(_OP_NOT) TARGET = (IsFalse(STK(arg1))?_true_:_false_); SQ_NEXT;
+			SQ_CASE(_OP_BWNOT)
 				if(type(STK(arg1)) == OT_INTEGER) {
 					SQInteger t = _integer(STK(arg1));
 					TARGET = SQInteger(~t);
-					continue;
+					SQ_NEXT;
 				}
 				Raise_Error(_SC("attempt to perform a bitwise op on a %s"), GetTypeName(STK(arg1)));
 				SQ_THROW();
-			case _OP_CLOSURE: {
+			SQ_CASE(_OP_CLOSURE) {
 				SQClosure *c = ci->_closure._unVal.pClosure;
 				SQFunctionProto *fp = c->_function._unVal.pFunctionProto;
 				if(!CLOSURE_OP(TARGET,fp->_functions[arg1]._unVal.pFunctionProto)) { SQ_THROW(); }
-				continue;
+				SQ_NEXT;
 			}
-			case _OP_YIELD:{
+			SQ_CASE(_OP_YIELD){
 				if(type(ci->_generator) == OT_GENERATOR) {
 					if(sarg1 != MAX_FUNC_STACKSIZE) temp_reg = STK(arg1);
 					_GUARD(_generator(ci->_generator)->Yield(this));
@@ -929,43 +1129,43 @@ common_call:
 				}
 					
 				}
-				continue;
-			case _OP_RESUME:
+				SQ_NEXT;
+			SQ_CASE(_OP_RESUME)
 				if(type(STK(arg1)) != OT_GENERATOR){ Raise_Error(_SC("trying to resume a '%s',only genenerator can be resumed"), GetTypeName(STK(arg1))); SQ_THROW();}
 				_GUARD(_generator(STK(arg1))->Resume(this, arg0));
 				traps += ci->_etraps;
-                continue;
-			case _OP_FOREACH:{ int tojump;
+                SQ_NEXT;
+			SQ_CASE(_OP_FOREACH){ int tojump;
 				_GUARD(FOREACH_OP(STK(arg0),STK(arg2),STK(arg2+1),STK(arg2+2),arg2,sarg1,tojump));
 				ci->_ip += tojump; }
-				continue;
-			case _OP_POSTFOREACH:
+				SQ_NEXT;
+			SQ_CASE(_OP_POSTFOREACH)
 				assert(type(STK(arg0)) == OT_GENERATOR);
 				if(_generator(STK(arg0))->_state == SQGenerator::eDead) 
 					ci->_ip += (sarg1 - 1);
-				continue;
-			case _OP_DELEGATE: _GUARD(DELEGATE_OP(TARGET,STK(arg1),STK(arg2))); continue;
-			case _OP_CLONE:
+				SQ_NEXT;
+			SQ_CASE(_OP_DELEGATE) _GUARD(DELEGATE_OP(TARGET,STK(arg1),STK(arg2))); SQ_NEXT;
+			SQ_CASE(_OP_CLONE)
 				if(!Clone(STK(arg1), TARGET))
 				{ Raise_Error(_SC("cloning a %s"), GetTypeName(STK(arg1))); SQ_THROW();}
-				continue;
-			case _OP_TYPEOF: TypeOf(STK(arg1), TARGET); continue;
-			case _OP_PUSHTRAP:{
+				SQ_NEXT;
+			SQ_CASE(_OP_TYPEOF) TypeOf(STK(arg1), TARGET); SQ_NEXT;
+			SQ_CASE(_OP_PUSHTRAP){
 				SQInstruction *_iv = _funcproto(_closure(ci->_closure)->_function)->_instructions;
 				_etraps.push_back(SQExceptionTrap(_top,_stackbase, &_iv[(ci->_ip-_iv)+arg1], arg0)); traps++;
 				ci->_etraps++;
 							  }
-				continue;
-			case _OP_POPTRAP: {
+				SQ_NEXT;
+			SQ_CASE(_OP_POPTRAP) {
 				for(SQInteger i = 0; i < arg0; i++) {
 					_etraps.pop_back(); traps--;
 					ci->_etraps--;
 				}
 							  }
-				continue;
-			case _OP_THROW:	Raise_Error(TARGET); SQ_THROW(); continue;
-			case _OP_CLASS: _GUARD(CLASS_OP(TARGET,arg1,arg2)); continue;
-			case _OP_NEWSLOTA:
+				SQ_NEXT;
+			SQ_CASE(_OP_THROW)	Raise_Error(TARGET); SQ_THROW(); SQ_NEXT;
+			SQ_CASE(_OP_CLASS) _GUARD(CLASS_OP(TARGET,arg1,arg2)); SQ_NEXT;
+			SQ_CASE(_OP_NEWSLOTA) {
 				bool bstatic = (arg0&NEW_SLOT_STATIC_FLAG)?true:false;
 				if(type(STK(arg1)) == OT_CLASS) {
 					if(type(_class(STK(arg1))->_metamethods[MT_NEWMEMBER]) != OT_NULL ) {
@@ -974,7 +1174,7 @@ common_call:
 						int nparams = 4;
 						if(Call(_class(STK(arg1))->_metamethods[MT_NEWMEMBER], nparams, _top - nparams, temp_reg,SQFalse)) {
 							Pop(nparams);
-							continue;
+							SQ_NEXT;
 						}
 					}
 				}
@@ -982,7 +1182,8 @@ common_call:
 				if((arg0&NEW_SLOT_ATTRIBUTES_FLAG)) {
 					_class(STK(arg1))->SetAttributes(STK(arg2),STK(arg2-1));
 				}
-				continue;
+				}
+				SQ_NEXT;
 			}
 			
 		}
@@ -1129,8 +1330,12 @@ bool SQVM::CallNative(SQNativeClosure *nclosure,SQInteger nargs,SQInteger stackb
 		return false;
 	}
 	
-	if (ret != 0){ retval = TOP(); }
-	else { retval = _null_; }
+	if (ret != 0){
+		//anything the native function pushed above the caller's top is dead, move the return value out
+		if (_top > oldtop) { _Swap(retval,TOP()); TOP().Null(); }
+		else retval = TOP();
+	}
+	else { retval.Null(); }
 	_stackbase = oldstackbase;
 	_top = oldtop;
 	POP_CALLINFO(this);
@@ -1428,19 +1633,19 @@ bool SQVM::CallMetaMethod(SQDelegable *del,SQMetaMethod mm,SQInteger nparams,SQO
 void SQVM::Remove(SQInteger n) {
 	n = (n >= 0)?n + _stackbase - 1:_top + n;
 	for(SQInteger i = n; i < _top; i++){
-		_stack[i] = _stack[i+1];
+		_Swap(_stack[i],_stack[i+1]);
 	}
-	_stack[_top] = _null_;
+	_stack[_top].Null();
 	_top--;
 }
 
 void SQVM::Pop() {
-	_stack[--_top] = _null_;
+	_stack[--_top].Null();
 }
 
 void SQVM::Pop(SQInteger n) {
 	for(SQInteger i = 0; i < n; i++){
-		_stack[--_top] = _null_;
+		_stack[--_top].Null();
 	}
 }
 
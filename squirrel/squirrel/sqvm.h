@@ -9,6 +9,7 @@
 #define MIN_STACK_OVERHEAD 10
 
 #define SQ_SUSPEND_FLAG -666
+struct SQInlineCache;
 //base lib
 void sq_base_register(HSQUIRRELVM v);
 
@@ -72,6 +73,11 @@ public:
 	void CallErrorHandler(SQObjectPtr &e);
 	bool Get(const SQObjectPtr &self, const SQObjectPtr &key, SQObjectPtr &dest, bool raw, bool fetchroot);
 	bool FallBackGet(const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest,bool raw);
+	//Get(self,key,dest,false,true) through a per instruction cache
+	_INLINE bool GetCached(SQInlineCache &ic,const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest);
+	bool CacheGet(SQInlineCache &ic,const SQObjectPtr &self,const SQObjectPtr &key,SQObjectPtr &dest);
+	_INLINE SQObjectPtr *GetRootSlot(const SQObjectPtr &self,const SQObjectPtr &key);
+	_INLINE bool IsRootCacheValid(const SQInlineCache &ic,const SQObjectPtr &self);
 	bool Set(const SQObjectPtr &self, const SQObjectPtr &key, const SQObjectPtr &val, bool fetchroot);
 	bool NewSlot(const SQObjectPtr &self, const SQObjectPtr &key, const SQObjectPtr &val,bool bstatic);
 	bool DeleteSlot(const SQObjectPtr &self, const SQObjectPtr &key, SQObjectPtr &res);
@@ -115,6 +121,7 @@ public:
 
 #ifndef NO_GARBAGE_COLLECTOR
 	void Mark(SQCollectable **chain);
+	void Traverse(SQGCVisitor *v);
 #endif
 	void Finalize();
 	void GrowCallStack() {